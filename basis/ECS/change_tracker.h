@@ -0,0 +1,132 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+
+#include <entt/entity/observer.hpp> // IWYU pragma: keep
+
+#include <base/logging.h>
+#include <base/macros.h>
+#include <base/sequence_checker.h>
+
+#include <basic/macros.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace ECS {
+
+// Opt-in change detection for `Component`,
+// so incremental systems can process only changed entities
+// i.e. O(changed) instead of O(view) per tick.
+//
+// Entity is marked as changed when `Component` is emplaced
+// or updated using `registry.patch` or `registry.replace`
+// (modification using reference from `registry.get` is not tracked).
+//
+// Changes are collected by `entt::observer` during tick
+// and published by `onTickBoundary`, so during tick N systems see
+// entities changed during tick N-1 (see `eachChangedLastTick`).
+//
+/// \note call `onTickBoundary` from `T::tickBoundaryCallback`
+/// of `basis::FixedTimeStepLoop<T>`.
+/// \note entity changed multiple times during tick is reported once.
+/// \see change_tracker_perftest.cc for overhead of tracking
+//
+// USAGE
+//
+//  ECS::ChangeTracker<Transform> transformChanges_{registry};
+//
+//  // in `updateCallback`
+//  transformChanges_.eachChangedLastTick(
+//    [&](ECS::Entity entityId, Transform& transform){
+//      updateBoundingBox(entityId, transform);
+//    });
+//
+//  // in `tickBoundaryCallback`
+//  transformChanges_.onTickBoundary();
+template <typename Component>
+class ChangeTracker
+{
+ public:
+  explicit ChangeTracker(ECS::Registry& registry)
+    : registry_(registry)
+    , observer_(
+        registry
+        , entt::collector
+            .template group<Component>()
+            .template update<Component>())
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  }
+
+  ~ChangeTracker()
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    observer_.disconnect();
+  }
+
+  // Publishes changes collected since previous call
+  // and starts collection of changes for next tick.
+  void onTickBoundary()
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    changedLastTick_.assign(observer_.begin(), observer_.end());
+    observer_.clear();
+  }
+
+  // Calls `func(ECS::Entity, Component&)` for each entity
+  // that changed `Component` during previous tick.
+  /// \note skips entities that were destroyed
+  /// (or lost `Component`) since then.
+  template <typename Func>
+  void eachChangedLastTick(Func&& func)
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    auto view = registry_.view<Component>();
+
+    for(const ECS::Entity& entityId: changedLastTick_)
+    {
+      if(!registry_.valid(entityId)
+         || !view.contains(entityId))
+      {
+        continue;
+      }
+
+      func(entityId, view.get(entityId));
+    }
+  }
+
+  // Number of entities changed during previous tick
+  /// \note may include entities that were destroyed since then.
+  size_t changedLastTickCount() const
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    return changedLastTick_.size();
+  }
+
+  // Number of entities changed since last `onTickBoundary`.
+  size_t pendingCount() const
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    return observer_.size();
+  }
+
+ private:
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  ECS::Registry& registry_;
+
+  entt::basic_observer<ECS::EntityId> observer_;
+
+  // Re-used between ticks to avoid allocations.
+  std::vector<ECS::Entity> changedLastTick_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChangeTracker);
+};
+
+} // namespace ECS
@@ -0,0 +1,118 @@
+#include "basis/ECS/change_tracker.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace ECS {
+
+namespace {
+
+struct PerfTransform {
+  float x = 0.0f;
+  float y = 0.0f;
+  float z = 0.0f;
+};
+
+std::vector<ECS::Entity> populate(ECS::Registry& registry, int64_t count) {
+  std::vector<ECS::Entity> entities(count);
+  registry.create(entities.begin(), entities.end());
+  for (const ECS::Entity& entityId : entities) {
+    registry.emplace<PerfTransform>(entityId);
+  }
+  return entities;
+}
+
+void patchAll(ECS::Registry& registry,
+              const std::vector<ECS::Entity>& entities) {
+  for (const ECS::Entity& entityId : entities) {
+    registry.patch<PerfTransform>(entityId, [](PerfTransform& transform) {
+      transform.x += 1.0f;
+    });
+  }
+}
+
+// Overhead of tracking on `registry.patch` (compare with tracker disabled).
+void BM_PatchTracked(benchmark::State& state) {
+  const bool isTracked = state.range(1) != 0;
+
+  ECS::Registry registry;
+  const std::vector<ECS::Entity> entities
+    = populate(registry, state.range(0));
+
+  std::unique_ptr<ChangeTracker<PerfTransform>> tracker;
+  if (isTracked) {
+    tracker = std::make_unique<ChangeTracker<PerfTransform>>(registry);
+  }
+
+  for (auto _ : state) {
+    patchAll(registry, entities);
+
+    if (tracker) {
+      tracker->onTickBoundary();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * entities.size());
+}
+BENCHMARK(BM_PatchTracked)
+  ->ArgNames({"entities", "tracked"})
+  ->Args({4096, 0})
+  ->Args({4096, 1})
+  ->Args({65536, 0})
+  ->Args({65536, 1});
+
+// Full view pass (what systems do without change detection).
+void BM_IterateAll(benchmark::State& state) {
+  ECS::Registry registry;
+  populate(registry, state.range(0));
+
+  for (auto _ : state) {
+    registry.view<PerfTransform>().each([](PerfTransform& transform) {
+      benchmark::DoNotOptimize(transform.x);
+    });
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IterateAll)
+  ->ArgName("entities")
+  ->Arg(65536);
+
+// Pass over entities changed during previous tick,
+// where each `state.range(1)`-th entity changed.
+void BM_IterateChangedLastTick(benchmark::State& state) {
+  const int64_t changeEvery = state.range(1);
+
+  ECS::Registry registry;
+  const std::vector<ECS::Entity> entities
+    = populate(registry, state.range(0));
+
+  ChangeTracker<PerfTransform> tracker(registry);
+
+  std::vector<ECS::Entity> changed;
+  for (size_t i = 0; i < entities.size(); i += changeEvery) {
+    changed.push_back(entities[i]);
+  }
+  patchAll(registry, changed);
+  tracker.onTickBoundary();
+
+  for (auto _ : state) {
+    tracker.eachChangedLastTick(
+      [](ECS::Entity, PerfTransform& transform) {
+        benchmark::DoNotOptimize(transform.x);
+      });
+  }
+
+  state.SetItemsProcessed(state.iterations() * changed.size());
+}
+BENCHMARK(BM_IterateChangedLastTick)
+  ->ArgNames({"entities", "changeEvery"})
+  ->Args({65536, 1})
+  ->Args({65536, 64});
+
+}  // namespace
+
+}  // namespace ECS
@@ -0,0 +1,69 @@
+#include "basis/ECS/change_tracker.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace ECS {
+namespace {
+
+struct Position {
+  int x = 0;
+};
+
+TEST(ChangeTrackerTest, ReportsChangesOfPreviousTick) {
+  ECS::Registry registry;
+
+  // emplaced before tracker creation
+  const ECS::Entity early = registry.create();
+  registry.emplace<Position>(early);
+
+  ChangeTracker<Position> tracker(registry);
+
+  std::vector<ECS::Entity> entities;
+  for (int i = 0; i < 3; ++i) {
+    entities.push_back(registry.create());
+    registry.emplace<Position>(entities.back(), i);
+  }
+  EXPECT_EQ(3u, tracker.pendingCount());
+
+  tracker.onTickBoundary();
+  EXPECT_EQ(0u, tracker.pendingCount());
+  EXPECT_EQ(3u, tracker.changedLastTickCount());
+
+  // changes of current tick are not visible until next tick boundary
+  registry.patch<Position>(entities[1], [](Position& pos) { pos.x = 10; });
+  registry.patch<Position>(entities[1], [](Position& pos) { pos.x = 11; });
+  registry.replace<Position>(early, 5);
+  // not tracked
+  registry.get<Position>(entities[2]).x = 7;
+
+  size_t counter = 0;
+  tracker.eachChangedLastTick([&counter](ECS::Entity, Position&) {
+    ++counter;
+  });
+  EXPECT_EQ(3u, counter);
+
+  // destroyed after change
+  registry.destroy(entities[0]);
+
+  tracker.onTickBoundary();
+
+  std::vector<ECS::Entity> changed;
+  tracker.eachChangedLastTick(
+      [&changed](ECS::Entity entityId, Position&) {
+        changed.push_back(entityId);
+      });
+  ASSERT_EQ(2u, changed.size());
+  EXPECT_NE(changed.end(),
+            std::find(changed.begin(), changed.end(), entities[1]));
+  EXPECT_NE(changed.end(), std::find(changed.begin(), changed.end(), early));
+
+  // nothing changed
+  tracker.onTickBoundary();
+  EXPECT_EQ(0u, tracker.changedLastTickCount());
+}
+
+}  // namespace
+}  // namespace ECS
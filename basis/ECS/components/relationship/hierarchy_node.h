@@ -0,0 +1,64 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+
+#include <cstddef>
+
+namespace ECS {
+
+// Fused alternative to `ParentEntity`, `ChildSiblings`,
+// `FirstChildInLinkedList` and `TopLevelChildrenCount`.
+//
+// Stores both child-side (`parentId`, `prevId`, `nextId`)
+// and parent-side (`firstChildId`, `childrenCount`) links
+// in one component, so entity pays one sparse set slot per `TagType`
+// and each operation touches only one pool.
+//
+// Emplaced into entity when it becomes parent or child,
+// removed when it is neither parent nor child.
+//
+/// \see https://skypjack.github.io/2019-06-25-ecs-baf-part-4/
+//
+/// \note do not mix with `ParentEntity`, `ChildSiblings`, etc.
+/// for same `TagType`: use `prependChildNode`, `removeChildNode`,
+/// `foreachChildNode` and `isChildNodeOf`.
+//
+// USAGE
+//
+// // Same entity may have multiple (different) hierarchies like so:
+// using SceneNode = HierarchyNode<class SceneTag>;
+// using WeaponGroupNode = HierarchyNode<class WeaponGroupTag>;
+template <typename TagT>
+CREATE_ECS_COMPONENT(HierarchyNode)
+{
+  using TagType = TagT;
+
+  // Entity identifier of the parent, if any.
+  ECS::Entity parentId{ECS::NULL_ENTITY};
+
+  // Previous sibling in the list of children for the parent.
+  ECS::Entity prevId{ECS::NULL_ENTITY};
+
+  // Next sibling in the list of children for the parent.
+  ECS::Entity nextId{ECS::NULL_ENTITY};
+
+  // First element in the list of children (at top level), if any.
+  ECS::Entity firstChildId{ECS::NULL_ENTITY};
+
+  // Size of the list of children (at top level).
+  size_t childrenCount{0};
+
+  bool hasParent() const
+  {
+    return parentId != ECS::NULL_ENTITY;
+  }
+
+  bool hasChildren() const
+  {
+    return childrenCount != 0;
+  }
+};
+
+} // namespace ECS
+
+ECS_DECLARE_METATYPE_TEMPLATE_1ARG(HierarchyNode);
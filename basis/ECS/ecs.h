@@ -219,6 +219,34 @@ struct TypeMetaRegistrator {};
   }; \
   } /* namespace ECS */
 
+namespace ecs_internal {
+
+template <typename T, typename = void>
+struct has_type_meta : std::false_type {};
+
+template <typename T>
+struct has_type_meta<
+  T
+  , std::void_t<decltype(TypeMetaRegistrator<T>::name())>
+> : std::true_type {};
+
+} // namespace ecs_internal
+
+// Name of component type for reports (memory dumps, compaction, etc.),
+// uses `TypeMetaRegistrator` if type is declared by `ECS_DECLARE_METATYPE`.
+template <typename Component>
+std::string componentTypeName()
+{
+  if constexpr (ecs_internal::has_type_meta<Component>::value)
+  {
+    return TypeMetaRegistrator<Component>::name();
+  }
+  else
+  {
+    return std::string{entt::type_info<Component>::name()};
+  }
+}
+
 #define CREATE_ECS_TAG(TAG_NAME) \
   ECS_LABEL(TAG_NAME);
 
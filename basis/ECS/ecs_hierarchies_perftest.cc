@@ -0,0 +1,269 @@
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/helpers/relationship/prepend_child_entity.h>
+#include <basis/ECS/helpers/relationship/foreach_top_level_child.h>
+#include <basis/ECS/helpers/relationship/remove_child_from_top_level.h>
+#include <basis/ECS/helpers/relationship/prepend_child_node.h>
+#include <basis/ECS/helpers/relationship/foreach_child_node.h>
+#include <basis/ECS/helpers/relationship/remove_child_node.h>
+
+#include <base/bind.h>
+#include <base/callback.h>
+#include <base/logging.h>
+
+#include <basic/macros.h>
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+class PerfTestTypeTag{};
+
+ECS_DEFINE_METATYPE_TEMPLATE(ECS::ChildSiblings<PerfTestTypeTag>);
+ECS_DEFINE_METATYPE_TEMPLATE(ECS::TopLevelChildrenCount<PerfTestTypeTag, size_t>);
+ECS_DEFINE_METATYPE_TEMPLATE(ECS::ParentEntity<PerfTestTypeTag>);
+ECS_DEFINE_METATYPE_TEMPLATE(ECS::FirstChildInLinkedList<PerfTestTypeTag>);
+ECS_DEFINE_METATYPE_TEMPLATE(ECS::HierarchyNode<PerfTestTypeTag>);
+
+namespace ECS {
+
+namespace {
+
+using TagType = PerfTestTypeTag;
+
+std::vector<ECS::Entity> createEntities(
+  ECS::Registry& registry
+  , size_t count)
+{
+  std::vector<ECS::Entity> entities(count);
+  registry.create(entities.begin(), entities.end());
+  return entities;
+}
+
+void prependAll(
+  ECS::Registry& registry
+  , ECS::Entity parentId
+  , const std::vector<ECS::Entity>& children)
+{
+  for(ECS::Entity childId : children) {
+    ECS::prependChildEntity<TagType>(
+      REFERENCED(registry)
+      , parentId
+      , childId);
+  }
+}
+
+void removeAll(
+  ECS::Registry& registry
+  , ECS::Entity parentId
+  , const std::vector<ECS::Entity>& children)
+{
+  for(ECS::Entity childId : children) {
+    const bool removed
+      = ECS::removeChildFromTopLevel<TagType>(
+          REFERENCED(registry)
+          , parentId
+          , childId);
+    DCHECK(removed);
+    UNREFERENCED_PARAMETER(removed);
+  }
+}
+
+void BM_PrependChildEntity(benchmark::State& state) {
+  const size_t childrenCount = state.range(0);
+
+  ECS::Registry registry;
+  const ECS::Entity parentId = registry.create();
+  const std::vector<ECS::Entity> children
+    = createEntities(registry, childrenCount);
+
+  for (auto _ : state) {
+    prependAll(registry, parentId, children);
+
+    state.PauseTiming();
+    removeAll(registry, parentId, children);
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * childrenCount);
+}
+BENCHMARK(BM_PrependChildEntity)
+  ->ArgName("children")
+  ->Arg(16)
+  ->Arg(256)
+  ->Arg(4096);
+
+// Removes children in order of insertion,
+// (i.e. each removed child is last in linked list).
+void BM_RemoveChildFromTopLevel(benchmark::State& state) {
+  const size_t childrenCount = state.range(0);
+
+  ECS::Registry registry;
+  const ECS::Entity parentId = registry.create();
+  const std::vector<ECS::Entity> children
+    = createEntities(registry, childrenCount);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    prependAll(registry, parentId, children);
+    state.ResumeTiming();
+
+    removeAll(registry, parentId, children);
+  }
+
+  state.SetItemsProcessed(state.iterations() * childrenCount);
+}
+BENCHMARK(BM_RemoveChildFromTopLevel)
+  ->ArgName("children")
+  ->Arg(16)
+  ->Arg(256)
+  ->Arg(4096);
+
+void countChild(
+  size_t* counter
+  , ECS::Registry&
+  , ECS::Entity
+  , ECS::Entity)
+{
+  ++(*counter);
+}
+
+void BM_ForeachTopLevelChild(benchmark::State& state) {
+  const size_t childrenCount = state.range(0);
+
+  ECS::Registry registry;
+  const ECS::Entity parentId = registry.create();
+  const std::vector<ECS::Entity> children
+    = createEntities(registry, childrenCount);
+  prependAll(registry, parentId, children);
+
+  size_t counter = 0;
+  const ECS::foreachTopLevelChildCb callback
+    = ::base::BindRepeating(&countChild, ::base::Unretained(&counter));
+
+  for (auto _ : state) {
+    ECS::foreachTopLevelChild<TagType>(
+      REFERENCED(registry)
+      , parentId
+      , callback);
+  }
+
+  CHECK_EQ(counter, state.iterations() * childrenCount);
+  state.SetItemsProcessed(state.iterations() * childrenCount);
+}
+BENCHMARK(BM_ForeachTopLevelChild)
+  ->ArgName("children")
+  ->Arg(16)
+  ->Arg(256)
+  ->Arg(4096);
+
+// Same as `prependAll`, but for fused `HierarchyNode` layout.
+void prependAllNodes(
+  ECS::Registry& registry
+  , ECS::Entity parentId
+  , const std::vector<ECS::Entity>& children)
+{
+  for(ECS::Entity childId : children) {
+    ECS::prependChildNode<TagType>(
+      REFERENCED(registry)
+      , parentId
+      , childId);
+  }
+}
+
+// Same as `removeAll`, but for fused `HierarchyNode` layout.
+void removeAllNodes(
+  ECS::Registry& registry
+  , ECS::Entity parentId
+  , const std::vector<ECS::Entity>& children)
+{
+  for(ECS::Entity childId : children) {
+    const bool removed
+      = ECS::removeChildNode<TagType>(
+          REFERENCED(registry)
+          , parentId
+          , childId);
+    DCHECK(removed);
+    UNREFERENCED_PARAMETER(removed);
+  }
+}
+
+void BM_PrependChildNode(benchmark::State& state) {
+  const size_t childrenCount = state.range(0);
+
+  ECS::Registry registry;
+  const ECS::Entity parentId = registry.create();
+  const std::vector<ECS::Entity> children
+    = createEntities(registry, childrenCount);
+
+  for (auto _ : state) {
+    prependAllNodes(registry, parentId, children);
+
+    state.PauseTiming();
+    removeAllNodes(registry, parentId, children);
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * childrenCount);
+}
+BENCHMARK(BM_PrependChildNode)
+  ->ArgName("children")
+  ->Arg(16)
+  ->Arg(256)
+  ->Arg(4096);
+
+void BM_RemoveChildNode(benchmark::State& state) {
+  const size_t childrenCount = state.range(0);
+
+  ECS::Registry registry;
+  const ECS::Entity parentId = registry.create();
+  const std::vector<ECS::Entity> children
+    = createEntities(registry, childrenCount);
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    prependAllNodes(registry, parentId, children);
+    state.ResumeTiming();
+
+    removeAllNodes(registry, parentId, children);
+  }
+
+  state.SetItemsProcessed(state.iterations() * childrenCount);
+}
+BENCHMARK(BM_RemoveChildNode)
+  ->ArgName("children")
+  ->Arg(16)
+  ->Arg(256)
+  ->Arg(4096);
+
+void BM_ForeachChildNode(benchmark::State& state) {
+  const size_t childrenCount = state.range(0);
+
+  ECS::Registry registry;
+  const ECS::Entity parentId = registry.create();
+  const std::vector<ECS::Entity> children
+    = createEntities(registry, childrenCount);
+  prependAllNodes(registry, parentId, children);
+
+  size_t counter = 0;
+  const ECS::foreachTopLevelChildCb callback
+    = ::base::BindRepeating(&countChild, ::base::Unretained(&counter));
+
+  for (auto _ : state) {
+    ECS::foreachChildNode<TagType>(
+      REFERENCED(registry)
+      , parentId
+      , callback);
+  }
+
+  CHECK_EQ(counter, state.iterations() * childrenCount);
+  state.SetItemsProcessed(state.iterations() * childrenCount);
+}
+BENCHMARK(BM_ForeachChildNode)
+  ->ArgName("children")
+  ->Arg(16)
+  ->Arg(256)
+  ->Arg(4096);
+
+}  // namespace
+
+}  // namespace ECS
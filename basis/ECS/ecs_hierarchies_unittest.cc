@@ -20,6 +20,7 @@
 #include <basis/ECS/helpers/relationship/remove_top_level_children_from_view.h>
 #include <basis/ECS/helpers/relationship/remove_child_from_top_level.h>
 #include <basis/ECS/helpers/relationship/has_child_at_top_level.h>
+#include <basis/ECS/helpers/relationship/are_children_of.h>
 
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -189,6 +190,15 @@ TEST(ECSChildrenTest, test_hierarchies_in_ECS_model)
     DCHECK(hasChildAtTopLevel<TagType>(registry, parentId, childThreeId));
     DCHECK(!hasChildAtTopLevel<TagType>(registry, parentId, registry.create()));
 
+    DCHECK(hasChildInTopLevelList<TagType>(registry, parentId, childId));
+    DCHECK(hasChildInTopLevelList<TagType>(registry, parentId, childThreeId));
+    DCHECK(!hasChildInTopLevelList<TagType>(registry, parentId, registry.create()));
+
+    DCHECK(areChildrenOf<TagType>(registry, parentId
+      , std::vector<ECS::Entity>{childId, childTwoId, childThreeId}));
+    DCHECK(!areChildrenOf<TagType>(registry, childId
+      , std::vector<ECS::Entity>{childTwoId}));
+
     DCHECK_EQ(registry.get<ParentComponent>(childId).parentId, parentId);
     DCHECK_EQ(registry.get<ChildrenComponent>(childId).nextId, ECS::NULL_ENTITY);
     DCHECK_EQ(registry.get<ChildrenComponent>(childId).prevId, childTwoId);
@@ -253,6 +263,12 @@ TEST(ECSChildrenTest, test_hierarchies_in_ECS_model)
     DCHECK(!hasChildAtTopLevel<TagType>(registry, parentId, childTwoId));
     DCHECK(!hasChildAtTopLevel<TagType>(registry, parentId, registry.create()));
 
+    std::vector<bool> isChild;
+    DCHECK(!areChildrenOf<TagType>(registry, parentId
+      , std::vector<ECS::Entity>{childId, childTwoId, ECS::NULL_ENTITY, childThreeId}
+      , &isChild));
+    DCHECK(isChild == (std::vector<bool>{true, false, false, true}));
+
     DCHECK_EQ(registry.get<ParentComponent>(childId).parentId, parentId);
     DCHECK_EQ(registry.get<ChildrenComponent>(childId).nextId, ECS::NULL_ENTITY);
     DCHECK_EQ(registry.get<ChildrenComponent>(childId).prevId, childThreeId);
@@ -0,0 +1,85 @@
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/helpers/relationship/prepend_child_node.h>
+#include <basis/ECS/helpers/relationship/remove_child_node.h>
+#include <basis/ECS/helpers/relationship/foreach_child_node.h>
+#include <basis/ECS/helpers/relationship/is_child_node_of.h>
+
+#include <base/bind.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <vector>
+
+namespace {
+
+class NodeTestTypeTag {};
+
+}  // namespace
+
+ECS_DEFINE_METATYPE_TEMPLATE(ECS::HierarchyNode<NodeTestTypeTag>);
+
+namespace ECS {
+namespace {
+
+using Node = HierarchyNode<NodeTestTypeTag>;
+
+std::vector<ECS::Entity> childrenOf(ECS::Registry& registry,
+                                    ECS::Entity parentId) {
+  std::vector<ECS::Entity> children;
+  foreachChildNode<NodeTestTypeTag>(
+      registry, parentId,
+      base::BindRepeating(
+          [](std::vector<ECS::Entity>* children, ECS::Registry&, ECS::Entity,
+             ECS::Entity childId) { children->push_back(childId); },
+          base::Unretained(&children)));
+  return children;
+}
+
+TEST(ECSHierarchyNodeTest, PrependAndRemove) {
+  ECS::Registry registry;
+
+  const ECS::Entity parentId = registry.create();
+  const ECS::Entity first = registry.create();
+  const ECS::Entity second = registry.create();
+  const ECS::Entity third = registry.create();
+
+  prependChildNode<NodeTestTypeTag>(registry, parentId, first);
+  prependChildNode<NodeTestTypeTag>(registry, parentId, second);
+  prependChildNode<NodeTestTypeTag>(registry, parentId, third);
+
+  // one component per entity
+  EXPECT_EQ(4u, registry.size<Node>());
+  EXPECT_EQ(3u, registry.get<Node>(parentId).childrenCount);
+  EXPECT_EQ((std::vector<ECS::Entity>{third, second, first}),
+            childrenOf(registry, parentId));
+
+  EXPECT_TRUE(isChildNodeOf<NodeTestTypeTag>(registry, parentId, second));
+  EXPECT_FALSE(isChildNodeOf<NodeTestTypeTag>(registry, first, second));
+  EXPECT_FALSE(
+      isChildNodeOf<NodeTestTypeTag>(registry, parentId, ECS::NULL_ENTITY));
+
+  // remove from middle of list
+  EXPECT_TRUE(removeChildNode<NodeTestTypeTag>(registry, parentId, second));
+  EXPECT_FALSE(removeChildNode<NodeTestTypeTag>(registry, parentId, second));
+  EXPECT_FALSE(registry.has<Node>(second));
+  EXPECT_EQ((std::vector<ECS::Entity>{third, first}),
+            childrenOf(registry, parentId));
+  EXPECT_EQ(first, registry.get<Node>(third).nextId);
+  EXPECT_EQ(third, registry.get<Node>(first).prevId);
+
+  // child that is also parent keeps its node
+  prependChildNode<NodeTestTypeTag>(registry, first, second);
+  EXPECT_TRUE(removeChildNode<NodeTestTypeTag>(registry, parentId, first));
+  EXPECT_TRUE(registry.has<Node>(first));
+  EXPECT_FALSE(registry.get<Node>(first).hasParent());
+  EXPECT_EQ((std::vector<ECS::Entity>{second}), childrenOf(registry, first));
+
+  // parent without children loses its node
+  EXPECT_TRUE(removeChildNode<NodeTestTypeTag>(registry, parentId, third));
+  EXPECT_FALSE(registry.has<Node>(parentId));
+  EXPECT_FALSE(registry.has<Node>(third));
+  EXPECT_TRUE(childrenOf(registry, parentId).empty());
+}
+
+}  // namespace
+}  // namespace ECS
@@ -0,0 +1,12 @@
+#include "basis/ECS/entity_migration.h" // IWYU pragma: associated
+
+#include <base/metrics/histogram_macros.h>
+
+namespace ECS {
+
+void recordEntityMigrationTime(::base::TimeDelta duration)
+{
+  UMA_HISTOGRAM_TIMES("Basis.ECS.EntityMigration.Time", duration);
+}
+
+} // namespace ECS
@@ -0,0 +1,381 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/safe_registry.h>
+#include <basis/ECS/components/relationship/child_siblings.h>
+#include <basis/ECS/components/relationship/first_child_in_linked_list.h>
+#include <basis/ECS/components/relationship/parent_entity.h>
+#include <basis/ECS/components/relationship/top_level_children_count.h>
+#include <basis/ECS/helpers/relationship/foreach_top_level_child.h>
+#include <basis/ECS/helpers/relationship/prepend_child_entity.h>
+#include <basis/ECS/helpers/relationship/remove_child_from_top_level.h>
+
+#include <base/bind.h>
+#include <base/callback.h>
+#include <base/location.h>
+#include <base/logging.h>
+#include <base/macros.h>
+#include <base/memory/ref_counted.h>
+#include <base/memory/scoped_refptr.h>
+#include <base/time/time.h>
+#include <base/trace_event/trace_event.h>
+
+#include <basic/macros.h>
+#include <basic/rvalue_cast.h>
+
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ECS {
+
+// Entities and components extracted from source registry
+// by `extractEntityTree` (components are moved, not copied).
+template <typename... Components>
+struct EntityMigrationPackage
+{
+  static constexpr size_t kNoParentIndex
+    = std::numeric_limits<size_t>::max();
+
+  EntityMigrationPackage() = default;
+
+  EntityMigrationPackage(EntityMigrationPackage&& other) = default;
+  EntityMigrationPackage& operator=(EntityMigrationPackage&& other) = default;
+
+  // Identifiers in source registry,
+  // root first, then children in breadth-first order.
+  std::vector<ECS::Entity> sourceIds;
+
+  // Index (in `sourceIds`) of parent of each entity.
+  // `kNoParentIndex` for root.
+  std::vector<size_t> parentIndices;
+
+  // Per component type: (index in `sourceIds`, moved component)
+  std::tuple<std::vector<std::pair<size_t, Components>>...> components;
+
+  // Time when extraction started.
+  ::base::TimeTicks startTime;
+
+  DISALLOW_COPY_AND_ASSIGN(EntityMigrationPackage);
+};
+
+struct EntityMigrationResult
+{
+  // Identifier of root in destination registry.
+  ECS::Entity rootId;
+
+  // (source identifier, destination identifier) for each migrated entity.
+  std::vector<std::pair<ECS::Entity, ECS::Entity>> remappedIds;
+
+  // Time from start of extraction until insertion is done
+  // (includes time spent in task queue of destination).
+  ::base::TimeDelta duration;
+};
+
+// Records `Basis.ECS.EntityMigration.Time` histogram.
+void recordEntityMigrationTime(::base::TimeDelta duration);
+
+namespace entity_migration_internal {
+
+template <typename TagType, typename Component>
+constexpr bool isRelationshipComponent()
+{
+  return std::is_same_v<Component, ParentEntity<TagType>>
+    || std::is_same_v<Component, ChildSiblings<TagType>>
+    || std::is_same_v<Component, FirstChildInLinkedList<TagType>>
+    || std::is_same_v<Component, TopLevelChildrenCount<TagType, size_t>>;
+}
+
+template <typename Component, typename Package>
+void extractComponent(
+  ECS::Registry& registry
+  , size_t index
+  , Package& package)
+{
+  const ECS::Entity entityId = package.sourceIds[index];
+
+  auto& storage
+    = std::get<std::vector<std::pair<size_t, Component>>>(package.components);
+
+  // tags do not store instances
+  if constexpr (std::is_empty_v<Component>)
+  {
+    if(registry.has<Component>(entityId))
+    {
+      storage.emplace_back(index, Component{});
+    }
+  }
+  else
+  {
+    if(Component* component = registry.try_get<Component>(entityId))
+    {
+      storage.emplace_back(index, RVALUE_CAST(*component));
+    }
+  }
+}
+
+template <typename Component, typename Package>
+void insertComponents(
+  ECS::Registry& registry
+  , const std::vector<ECS::Entity>& destinationIds
+  , Package& package)
+{
+  auto& storage
+    = std::get<std::vector<std::pair<size_t, Component>>>(package.components);
+
+  for(std::pair<size_t, Component>& element: storage)
+  {
+    DCHECK_LT(element.first, destinationIds.size());
+    registry.emplace<Component>(
+      destinationIds[element.first]
+      , RVALUE_CAST(element.second));
+  }
+}
+
+} // namespace entity_migration_internal
+
+// Moves `rootId` and its children (recursively, using relationship
+// with `TagType`) out of `registry`:
+// * `Components` of each entity are moved into package
+// * `rootId` is removed from children of its parent (if any)
+// * entities are destroyed in `registry`
+//
+/// \note relationship components of `TagType` must not be listed
+/// in `Components`, hierarchy is rebuilt by `insertEntityTree`.
+/// \note components not listed in `Components` are destroyed.
+/// \note entity identifiers stored inside of `Components`
+/// are NOT remapped (use `EntityMigrationResult::remappedIds`).
+template <
+  typename TagType // unique type tag for all children
+  , typename... Components
+>
+MUST_USE_RETURN_VALUE
+EntityMigrationPackage<Components...> extractEntityTree(
+  ECS::Registry& registry
+  , ECS::Entity rootId
+  , ECS::include_t<Components...> = {})
+{
+  using Package = EntityMigrationPackage<Components...>;
+  using ParentComponent = ParentEntity<TagType>;
+
+  static_assert(
+    !(entity_migration_internal::isRelationshipComponent<
+        TagType, Components>() || ...)
+    , "relationship components are rebuilt in destination registry");
+
+  TRACE_EVENT0("headless", "ECS::extractEntityTree");
+
+  DCHECK_ECS_ENTITY(rootId, &registry);
+
+  Package package;
+  package.startTime = ::base::TimeTicks::Now();
+  package.sourceIds.push_back(rootId);
+  package.parentIndices.push_back(Package::kNoParentIndex);
+
+  // collect hierarchy in breadth-first order
+  for(size_t index = 0; index < package.sourceIds.size(); ++index)
+  {
+    foreachTopLevelChild<TagType>(
+      REFERENCED(registry)
+      , package.sourceIds[index]
+      , ::base::BindRepeating(
+          [](
+            Package* package
+            , size_t parentIndex
+            , ECS::Registry&
+            , ECS::Entity
+            , ECS::Entity childId
+          ){
+            package->sourceIds.push_back(childId);
+            package->parentIndices.push_back(parentIndex);
+          }
+          , ::base::Unretained(&package)
+          , index));
+  }
+
+  // detach subtree from rest of hierarchy
+  if(const ParentComponent* parentComp
+       = registry.try_get<ParentComponent>(rootId))
+  {
+    const bool removed
+      = removeChildFromTopLevel<TagType>(
+          REFERENCED(registry)
+          , parentComp->parentId
+          , rootId);
+    DCHECK(removed);
+    UNREFERENCED_PARAMETER(removed);
+  }
+
+  for(size_t index = 0; index < package.sourceIds.size(); ++index)
+  {
+    (entity_migration_internal::extractComponent<Components>(
+       registry, index, package), ...);
+  }
+
+  // subtree is detached, so links inside of it can be destroyed
+  // together with entities
+  for(const ECS::Entity& entityId: package.sourceIds)
+  {
+    registry.destroy(entityId);
+  }
+
+  return package;
+}
+
+// Creates entities from `package` in `registry`,
+// moves components into them and rebuilds hierarchy
+// (order of children is preserved).
+template <
+  typename TagType // unique type tag for all children
+  , typename... Components
+>
+MUST_USE_RETURN_VALUE
+EntityMigrationResult insertEntityTree(
+  ECS::Registry& registry
+  , EntityMigrationPackage<Components...>&& package)
+{
+  using Package = EntityMigrationPackage<Components...>;
+
+  TRACE_EVENT0("headless", "ECS::insertEntityTree");
+
+  DCHECK(!package.sourceIds.empty());
+  DCHECK_EQ(package.sourceIds.size(), package.parentIndices.size());
+
+  std::vector<ECS::Entity> destinationIds(package.sourceIds.size());
+  registry.create(destinationIds.begin(), destinationIds.end());
+
+  (entity_migration_internal::insertComponents<Components>(
+     registry, destinationIds, package), ...);
+
+  // children of same parent are stored in order of linked list,
+  // so prepend them in reverse order
+  for(size_t index = package.sourceIds.size(); index-- > 1;)
+  {
+    const size_t parentIndex = package.parentIndices[index];
+    DCHECK_NE(parentIndex, Package::kNoParentIndex);
+    DCHECK_LT(parentIndex, index);
+
+    prependChildEntity<TagType>(
+      REFERENCED(registry)
+      , destinationIds[parentIndex]
+      , destinationIds[index]);
+  }
+
+  EntityMigrationResult result;
+  result.rootId = destinationIds.front();
+  result.remappedIds.reserve(destinationIds.size());
+  for(size_t index = 0; index < destinationIds.size(); ++index)
+  {
+    result.remappedIds.emplace_back(
+      package.sourceIds[index]
+      , destinationIds[index]);
+  }
+  result.duration = ::base::TimeTicks::Now() - package.startTime;
+
+  recordEntityMigrationTime(result.duration);
+
+  return result;
+}
+
+// Moves entity (with children) from `source` to `destination`
+// using single task posted to sequence of `destination`.
+//
+// `done` runs on sequence of `destination`
+// (identifiers in `EntityMigrationResult` are valid there).
+//
+// Returns `false` if task can not be posted to `destination`
+// (for example, its task runner is shutting down).
+// In that case entities are inserted back into `source`
+// as new top-level tree: they get NEW identifiers,
+// link to former parent is lost and `done` is not called.
+//
+/// \note must be called on sequence of `source`.
+/// \note `destination` must outlive posted task.
+/// \see `extractEntityTree` for limitations
+//
+// USAGE
+//
+//  // on sequence of `shardA`
+//  const bool posted = ECS::migrateEntity<SceneTag>(FROM_HERE
+//    , REFERENCED(shardA)
+//    , REFERENCED(shardB)
+//    , playerId
+//    , ::base::BindOnce(&onPlayerMigrated)
+//    , ECS::include<Transform, Inventory>);
+//  if(!posted)
+//  {
+//    LOG(WARNING) << "player stays in shardA";
+//  }
+template <
+  typename TagType // unique type tag for all children
+  , typename... Components
+>
+MUST_USE_RETURN_VALUE
+bool migrateEntity(
+  const ::base::Location& from_here
+  , ECS::SafeRegistry& source
+  , ECS::SafeRegistry& destination
+  , ECS::Entity rootId
+  , ::base::OnceCallback<void(EntityMigrationResult)> done
+  , ECS::include_t<Components...> = {})
+{
+  using Package = EntityMigrationPackage<Components...>;
+  // Shared with posted task, so package is not lost if post fails.
+  using PackageHolder = ::base::RefCountedData<Package>;
+
+  DCHECK_RUN_ON_REGISTRY(&source);
+
+  DCHECK_NE(&source, &destination);
+
+  scoped_refptr<PackageHolder> packageHolder
+    = ::base::MakeRefCounted<PackageHolder>(
+        extractEntityTree<TagType, Components...>(*source, rootId));
+
+  const bool posted = destination.taskRunner()->PostTask(
+    from_here
+    , ::base::BindOnce(
+        [](
+          ECS::SafeRegistry* destination
+          , scoped_refptr<PackageHolder> packageHolder
+          , ::base::OnceCallback<void(EntityMigrationResult)> done
+        ){
+          DCHECK_RUN_ON_REGISTRY(destination);
+
+          EntityMigrationResult result
+            = insertEntityTree<TagType, Components...>(
+                **destination
+                , RVALUE_CAST(packageHolder->data));
+
+          if(done)
+          {
+            RVALUE_CAST(done).Run(RVALUE_CAST(result));
+          }
+        }
+        , ::base::Unretained(&destination)
+        , packageHolder
+        , RVALUE_CAST(done)));
+
+  if(!posted)
+  {
+    // Posted task is destroyed without run,
+    // so `source` is only owner of package.
+    DCHECK(packageHolder->HasOneRef());
+
+    LOG(WARNING)
+      << "entity migration posted from "
+      << from_here.ToString()
+      << " is rejected by destination,"
+      << " entities are inserted back into source";
+
+    ignore_result(insertEntityTree<TagType, Components...>(
+      *source
+      , RVALUE_CAST(packageHolder->data)));
+  }
+
+  return posted;
+}
+
+} // namespace ECS
@@ -0,0 +1,114 @@
+#include "basis/ECS/entity_migration.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+class MigrationTestTag {};
+
+}  // namespace
+
+ECS_DEFINE_METATYPE_TEMPLATE(ECS::ChildSiblings<MigrationTestTag>);
+ECS_DEFINE_METATYPE_TEMPLATE(
+    ECS::TopLevelChildrenCount<MigrationTestTag, size_t>);
+ECS_DEFINE_METATYPE_TEMPLATE(ECS::ParentEntity<MigrationTestTag>);
+ECS_DEFINE_METATYPE_TEMPLATE(ECS::FirstChildInLinkedList<MigrationTestTag>);
+
+namespace ECS {
+namespace {
+
+using ParentComponent = ParentEntity<MigrationTestTag>;
+
+struct Name {
+  std::string value;
+};
+
+// move-only, so components can not be copied
+struct Buffer {
+  std::unique_ptr<int> data;
+};
+
+struct HotTag {};
+
+std::vector<ECS::Entity> childrenOf(ECS::Registry& registry,
+                                    ECS::Entity parentId) {
+  std::vector<ECS::Entity> children;
+  foreachTopLevelChild<MigrationTestTag>(
+      registry, parentId,
+      base::BindRepeating(
+          [](std::vector<ECS::Entity>* children, ECS::Registry&, ECS::Entity,
+             ECS::Entity childId) { children->push_back(childId); },
+          base::Unretained(&children)));
+  return children;
+}
+
+TEST(EntityMigrationTest, MovesSubtreeBetweenRegistries) {
+  ECS::Registry source;
+  ECS::Registry destination;
+
+  // source: world -> root -> (first, second -> grandchild)
+  const ECS::Entity world = source.create();
+  const ECS::Entity root = source.create();
+  const ECS::Entity first = source.create();
+  const ECS::Entity second = source.create();
+  const ECS::Entity grandchild = source.create();
+
+  prependChildEntity<MigrationTestTag>(source, world, root);
+  // prepend in reverse to get (first, second)
+  prependChildEntity<MigrationTestTag>(source, root, second);
+  prependChildEntity<MigrationTestTag>(source, root, first);
+  prependChildEntity<MigrationTestTag>(source, second, grandchild);
+
+  source.emplace<Name>(root, "root");
+  source.emplace<Name>(first, "first");
+  source.emplace<Name>(grandchild, "grandchild");
+  source.emplace<Buffer>(second, std::make_unique<int>(42));
+  source.emplace<HotTag>(first);
+
+  // occupy identifiers, so ids in destination differ
+  destination.create();
+  destination.create();
+
+  EntityMigrationPackage<Name, Buffer, HotTag> package =
+      extractEntityTree<MigrationTestTag>(source, root,
+                                          ECS::include<Name, Buffer, HotTag>);
+  ASSERT_EQ(4u, package.sourceIds.size());
+
+  // subtree is removed from source, rest of hierarchy is intact
+  EXPECT_TRUE(source.valid(world));
+  for (const ECS::Entity& entityId : {root, first, second, grandchild}) {
+    EXPECT_FALSE(source.valid(entityId));
+  }
+  EXPECT_FALSE(source.has<FirstChildInLinkedList<MigrationTestTag>>(world));
+
+  EntityMigrationResult result =
+      insertEntityTree<MigrationTestTag>(destination, std::move(package));
+  ASSERT_EQ(4u, result.remappedIds.size());
+  EXPECT_EQ(root, result.remappedIds[0].first);
+  EXPECT_EQ(result.rootId, result.remappedIds[0].second);
+  EXPECT_GE(result.duration, base::TimeDelta());
+
+  const ECS::Entity newRoot = result.rootId;
+  EXPECT_EQ("root", destination.get<Name>(newRoot).value);
+  EXPECT_FALSE(destination.has<ParentComponent>(newRoot));
+
+  const std::vector<ECS::Entity> children = childrenOf(destination, newRoot);
+  ASSERT_EQ(2u, children.size());
+  EXPECT_EQ("first", destination.get<Name>(children[0]).value);
+  EXPECT_TRUE(destination.has<HotTag>(children[0]));
+  EXPECT_EQ(42, *destination.get<Buffer>(children[1]).data);
+
+  const std::vector<ECS::Entity> grandchildren =
+      childrenOf(destination, children[1]);
+  ASSERT_EQ(1u, grandchildren.size());
+  EXPECT_EQ("grandchild", destination.get<Name>(grandchildren[0]).value);
+  EXPECT_EQ(children[1],
+            destination.get<ParentComponent>(grandchildren[0]).parentId);
+}
+
+}  // namespace
+}  // namespace ECS
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+
+#include <base/logging.h>
+#include <base/macros.h>
+
+#include <basic/macros.h>
+
+namespace ECS {
+
+template<typename... Type>
+struct owned_t: entt::type_list<Type...> {};
+
+template<typename... Type>
+inline constexpr owned_t<Type...> owned{};
+
+// Declares owning group (archetype-like storage) for common set of components.
+//
+// Owning group keeps owned pools sorted, so all entities that have
+// `Owned...` (and `Get...`, but not `Exclude...`) are tightly packed
+// at the beginning of each owned pool.
+// Iteration of owning group does not perform sparse set intersection
+// (unlike `registry.view`).
+//
+/// \note Component can be owned only by one group
+/// (unless groups are nested), so prefer to own only components of hot systems.
+/// \note Owned pools can not be sorted (`registry.sort`).
+/// \note Do not add or remove owned components while iterating
+/// `registry.view` over owned pool (group rearranges pool on each change),
+/// see `DCHECK_NOT_OWNED_BY_GROUP`.
+/// \see https://github.com/skypjack/entt/wiki/Crash-Course:-entity-component-system#groups
+//
+// USAGE
+//
+//  using MovementGroup
+//    = ECS::GroupPreset<
+//        ECS::owned_t<Position, Velocity>
+//        , ECS::get_t<Mass>
+//        , ECS::exclude_t<ECS::NeedToDestroyTag>
+//      >;
+//
+//  ECS::SafeRegistry registry{ECS::GroupPresets<MovementGroup>{}};
+//
+//  // on sequence of registry (each tick)
+//  MovementGroup::group(*registry).each(
+//    [](ECS::Entity entityId, Position& pos, Velocity& vel, Mass& mass)
+//    {
+//      // ...
+//    });
+template<
+  typename OwnedList
+  , typename GetList = ECS::get_t<>
+  , typename ExcludeList = ECS::exclude_t<>
+>
+struct GroupPreset;
+
+template<
+  typename... Owned
+  , typename... Get
+  , typename... Exclude
+>
+struct GroupPreset<
+  ECS::owned_t<Owned...>
+  , ECS::get_t<Get...>
+  , ECS::exclude_t<Exclude...>
+>
+{
+  static_assert(sizeof...(Owned) > 0
+    , "Owning group must own at least one component");
+
+  // Creates group on first call (pools are rearranged only once).
+  /// \note create group before emplacing many components,
+  /// so pools are not rearranged after they are populated.
+  MUST_USE_RETURN_VALUE
+  static auto group(ECS::Registry& registry)
+  {
+    return registry.group<Owned...>(
+      entt::get<Get...>
+      , entt::exclude<Exclude...>);
+  }
+
+  static void registerIn(ECS::Registry& registry)
+  {
+    ignore_result(group(registry));
+
+    DCHECK(!registry.sortable<Owned...>());
+  }
+};
+
+// List of `GroupPreset` used to create `SafeRegistry`.
+template<typename... Presets>
+struct GroupPresets
+{
+  static void registerIn(ECS::Registry& registry)
+  {
+    (Presets::registerIn(registry), ...);
+  }
+};
+
+// Returns true if any of `Components` is owned by any group.
+template<typename... Components>
+MUST_USE_RETURN_VALUE
+bool isOwnedByGroup(const ECS::Registry& registry)
+{
+  /// \note `sortable` returns false if any of components
+  /// is owned by group
+  return !registry.sortable<Components...>();
+}
+
+// Use it in helpers that add or remove components
+// while iterating `registry.view` over same components.
+//
+// USAGE
+//
+// DCHECK_NOT_OWNED_BY_GROUP(registry, FirstChildComponent, ChildrenSizeComponent);
+#define DCHECK_NOT_OWNED_BY_GROUP(__registry__, ...) \
+  DCHECK(!ECS::isOwnedByGroup<__VA_ARGS__>(__registry__)) \
+    << "helper modifies components owned by group: " \
+    << STRINGIFY_VA_ARG(__VA_ARGS__)
+
+} // namespace ECS
@@ -0,0 +1,129 @@
+#include "basis/ECS/group_presets.h"
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+namespace ECS {
+
+namespace {
+
+struct PerfPosition {
+  float x = 0.0f;
+  float y = 0.0f;
+  float z = 0.0f;
+};
+
+struct PerfVelocity {
+  float dx = 1.0f;
+  float dy = 1.0f;
+  float dz = 1.0f;
+};
+
+struct PerfMass {
+  float value = 1.0f;
+};
+
+// Present in some entities only, so pools contain "holes"
+// that view must skip using sparse set lookups.
+struct PerfUnrelated {
+  uint64_t value = 0;
+};
+
+using MovementGroup
+  = GroupPreset<
+      owned_t<PerfPosition, PerfVelocity, PerfMass>
+    >;
+
+// Populates registry where only each `state.range(1)`-th entity
+// has all components of hot system.
+void populate(ECS::Registry& registry, benchmark::State& state) {
+  const int64_t entities = state.range(0);
+  const int64_t matchEvery = state.range(1);
+
+  for (int64_t i = 0; i < entities; ++i) {
+    const ECS::Entity entityId = registry.create();
+    registry.emplace<PerfPosition>(entityId);
+    registry.emplace<PerfUnrelated>(entityId);
+    if (i % matchEvery == 0) {
+      registry.emplace<PerfVelocity>(entityId);
+      registry.emplace<PerfMass>(entityId);
+    }
+  }
+}
+
+void BM_IterateView(benchmark::State& state) {
+  ECS::Registry registry;
+  populate(registry, state);
+
+  for (auto _ : state) {
+    registry.view<PerfPosition, PerfVelocity, PerfMass>().each(
+      [](PerfPosition& pos, const PerfVelocity& vel, const PerfMass& mass) {
+        pos.x += vel.dx * mass.value;
+        pos.y += vel.dy * mass.value;
+        pos.z += vel.dz * mass.value;
+      });
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(
+    state.iterations() * (state.range(0) / state.range(1)));
+}
+
+void BM_IterateOwningGroup(benchmark::State& state) {
+  ECS::Registry registry;
+  GroupPresets<MovementGroup>::registerIn(registry);
+  populate(registry, state);
+
+  for (auto _ : state) {
+    MovementGroup::group(registry).each(
+      [](PerfPosition& pos, const PerfVelocity& vel, const PerfMass& mass) {
+        pos.x += vel.dx * mass.value;
+        pos.y += vel.dy * mass.value;
+        pos.z += vel.dz * mass.value;
+      });
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(
+    state.iterations() * (state.range(0) / state.range(1)));
+}
+
+// Owning group makes emplace and remove of owned components more expensive
+// (entity is swapped into or out of group), so measure it too.
+template <bool kUseGroup>
+void BM_EmplaceRemove(benchmark::State& state) {
+  ECS::Registry registry;
+  if (kUseGroup) {
+    GroupPresets<MovementGroup>::registerIn(registry);
+  }
+  populate(registry, state);
+
+  const ECS::Entity entityId = registry.create();
+  registry.emplace<PerfPosition>(entityId);
+  registry.emplace<PerfVelocity>(entityId);
+
+  for (auto _ : state) {
+    registry.emplace<PerfMass>(entityId);
+    registry.remove<PerfMass>(entityId);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+void Arguments(benchmark::internal::Benchmark* bench) {
+  bench
+    ->Args({10000, 1})
+    ->Args({10000, 4})
+    ->Args({100000, 1})
+    ->Args({100000, 4});
+}
+
+BENCHMARK(BM_IterateView)->Apply(Arguments);
+BENCHMARK(BM_IterateOwningGroup)->Apply(Arguments);
+BENCHMARK_TEMPLATE(BM_EmplaceRemove, false)->Args({10000, 4});
+BENCHMARK_TEMPLATE(BM_EmplaceRemove, true)->Args({10000, 4});
+
+}  // namespace
+
+}  // namespace ECS
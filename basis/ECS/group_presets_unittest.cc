@@ -0,0 +1,99 @@
+#include "basis/ECS/group_presets.h"
+
+#include "basis/ECS/safe_registry.h"
+
+#include "base/test/task_environment.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace ECS {
+namespace {
+
+struct Position {
+  int x = 0;
+};
+
+struct Velocity {
+  int dx = 1;
+};
+
+struct Mass {
+  int value = 1;
+};
+
+struct Sprite {};
+
+struct FrozenTag {};
+
+using MovementGroup
+  = GroupPreset<
+      owned_t<Position, Velocity>
+      , get_t<Mass>
+      , exclude_t<FrozenTag>
+    >;
+
+using RenderGroup
+  = GroupPreset<
+      owned_t<Sprite>
+    >;
+
+TEST(GroupPresetsTest, RegistersOwningGroups) {
+  ECS::Registry registry;
+  EXPECT_FALSE((isOwnedByGroup<Position, Velocity, Mass, Sprite>(registry)));
+
+  GroupPresets<MovementGroup, RenderGroup>::registerIn(registry);
+
+  EXPECT_TRUE(isOwnedByGroup<Position>(registry));
+  EXPECT_TRUE(isOwnedByGroup<Velocity>(registry));
+  EXPECT_TRUE(isOwnedByGroup<Sprite>(registry));
+  // `get_t` components are not owned
+  EXPECT_FALSE(isOwnedByGroup<Mass>(registry));
+  // true if any of components is owned
+  EXPECT_TRUE((isOwnedByGroup<Mass, Sprite>(registry)));
+}
+
+TEST(GroupPresetsTest, GroupContainsMatchingEntities) {
+  ECS::Registry registry;
+  GroupPresets<MovementGroup>::registerIn(registry);
+
+  for (int i = 0; i < 10; ++i) {
+    const ECS::Entity entityId = registry.create();
+    registry.emplace<Position>(entityId);
+    registry.emplace<Velocity>(entityId);
+    if (i % 2 == 0) {
+      registry.emplace<Mass>(entityId);
+    }
+    if (i % 4 == 0) {
+      registry.emplace<FrozenTag>(entityId);
+    }
+  }
+
+  // entities 2 and 6 have `Mass` and are not frozen
+  EXPECT_EQ(2u, MovementGroup::group(registry).size());
+
+  int visited = 0;
+  MovementGroup::group(registry).each(
+      [&visited](ECS::Entity, Position& pos, Velocity& vel, Mass& mass) {
+        pos.x += vel.dx * mass.value;
+        ++visited;
+      });
+  EXPECT_EQ(2, visited);
+
+  // group is updated when owned component is removed
+  const ECS::Entity grouped = *MovementGroup::group(registry).begin();
+  registry.remove<Velocity>(grouped);
+  EXPECT_EQ(1u, MovementGroup::group(registry).size());
+}
+
+TEST(GroupPresetsTest, SafeRegistryCreatesGroups) {
+  base::test::TaskEnvironment task_environment;
+
+  ECS::SafeRegistry registry{GroupPresets<MovementGroup, RenderGroup>{}};
+
+  EXPECT_TRUE(isOwnedByGroup<Position>(registry.registry()));
+  EXPECT_TRUE(isOwnedByGroup<Sprite>(registry.registry()));
+  EXPECT_FALSE(isOwnedByGroup<Mass>(registry.registry()));
+}
+
+}  // namespace
+}  // namespace ECS
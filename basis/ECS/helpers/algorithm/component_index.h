@@ -0,0 +1,325 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+
+#include <base/logging.h>
+#include <base/macros.h>
+#include <base/sequence_checker.h>
+
+#include <basic/macros.h>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace ECS {
+
+namespace component_index_internal {
+
+template <typename T>
+struct field_traits;
+
+template <typename ComponentT, typename KeyT>
+struct field_traits<KeyT ComponentT::*>
+{
+  using component_type = ComponentT;
+  using key_type = KeyT;
+};
+
+template <typename T>
+struct is_ordered : std::false_type {};
+
+template <typename... Args>
+struct is_ordered<std::multimap<Args...>> : std::true_type {};
+
+} // namespace component_index_internal
+
+// Secondary index on field of component.
+// Replaces scans like `findEntity` (or ad-hoc maps that go stale)
+// for lookups by key (connection id, session token, etc.).
+//
+// Index is maintained automatically using
+// `on_construct`, `on_update` and `on_destroy` signals of `Field` component.
+//
+/// \note `on_update` is emitted only by `registry.patch`
+/// and `registry.replace` (or `emplace_or_replace`),
+/// so change indexed field only using them
+/// (modification using reference from `registry.get` is not tracked).
+/// \note stores copy of key per entity (to find old key on update),
+/// see `estimateMemoryUsage`.
+/// \note multiple entities may have same key.
+//
+// Prefer aliases `HashIndex` (O(1) lookup)
+// and `SortedIndex` (O(log n) lookup and range queries).
+//
+// USAGE
+//
+//  // on sequence of registry
+//  ECS::HashIndex<&TcpConnection::connectionId> byConnectionId_{registry};
+//  ECS::SortedIndex<&Session::expiresAt> byExpiration_{registry};
+//
+//  ECS::Entity entityId = byConnectionId_.find(connectionId);
+//
+//  byExpiration_.eachInRange(::base::Time(), ::base::Time::Now()
+//    , [](ECS::Entity entityId){ ... });
+template <
+  auto Field
+  , typename Storage
+>
+class ComponentIndex
+{
+ public:
+  using Component
+    = typename component_index_internal::field_traits<
+        decltype(Field)
+      >::component_type;
+
+  using Key
+    = typename component_index_internal::field_traits<
+        decltype(Field)
+      >::key_type;
+
+  using EntityInt
+    = typename ECS::Entity::entity_type;
+
+  static constexpr bool kIsOrdered
+    = component_index_internal::is_ordered<Storage>::value;
+
+  explicit ComponentIndex(ECS::Registry& registry)
+    : registry_(registry)
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    // index components created before index
+    for(const ECS::Entity& entityId: registry_.view<Component>())
+    {
+      insert(entityId, registry_.get<Component>(entityId).*Field);
+    }
+
+    registry_.on_construct<Component>().template connect<
+      &ComponentIndex::onConstruct>(*this);
+    registry_.on_update<Component>().template connect<
+      &ComponentIndex::onUpdate>(*this);
+    registry_.on_destroy<Component>().template connect<
+      &ComponentIndex::onDestroy>(*this);
+  }
+
+  ~ComponentIndex()
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    registry_.on_construct<Component>().disconnect(*this);
+    registry_.on_update<Component>().disconnect(*this);
+    registry_.on_destroy<Component>().disconnect(*this);
+  }
+
+  // Returns `ECS::NULL_ENTITY` if no entity has `key`.
+  /// \note returns any of entities if multiple entities have same `key`
+  MUST_USE_RETURN_VALUE
+  ECS::Entity find(const Key& key) const
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    auto it = entities_.find(key);
+    return it == entities_.end()
+      ? ECS::NULL_ENTITY
+      : it->second;
+  }
+
+  MUST_USE_RETURN_VALUE
+  size_t count(const Key& key) const
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    return entities_.count(key);
+  }
+
+  // Calls `func(ECS::Entity)` for each entity with `key`.
+  template <typename Func>
+  void each(const Key& key, Func&& func) const
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    auto range = entities_.equal_range(key);
+    for(auto it = range.first; it != range.second; ++it)
+    {
+      func(it->second);
+    }
+  }
+
+  // Calls `func(ECS::Entity)` for each entity with key in [`lower`, `upper`)
+  // in order of keys.
+  template <typename Func>
+  void eachInRange(const Key& lower, const Key& upper, Func&& func) const
+  {
+    static_assert(kIsOrdered
+      , "range queries require SortedIndex");
+
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    auto end = entities_.lower_bound(upper);
+    for(auto it = entities_.lower_bound(lower); it != end; ++it)
+    {
+      func(it->second);
+    }
+  }
+
+  // Number of indexed entities.
+  size_t size() const
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    DCHECK_EQ(entities_.size(), keys_.size());
+    return entities_.size();
+  }
+
+  // Approximate heap memory used by index (in bytes).
+  /// \note does not include memory allocated by `Key` itself
+  /// (like heap buffer of long `std::string`).
+  size_t estimateMemoryUsage() const
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    // each node of node-based container stores value
+    // and (at most) three pointers
+    constexpr size_t kNodeOverhead = 3 * sizeof(void*);
+
+    size_t bytes
+      = entities_.size()
+          * (sizeof(typename Storage::value_type) + kNodeOverhead)
+        + keys_.size()
+          * (sizeof(typename Keys::value_type) + kNodeOverhead)
+        + keys_.bucket_count() * sizeof(void*);
+
+    if constexpr (!kIsOrdered)
+    {
+      bytes += entities_.bucket_count() * sizeof(void*);
+    }
+
+    return bytes;
+  }
+
+ private:
+  using Keys
+    = std::unordered_map<EntityInt, Key>;
+
+  void onConstruct(ECS::Registry& registry, ECS::Entity entityId)
+  {
+    DCHECK_EQ(&registry, &registry_);
+
+    insert(entityId, registry.get<Component>(entityId).*Field);
+  }
+
+  void onUpdate(ECS::Registry& registry, ECS::Entity entityId)
+  {
+    DCHECK_EQ(&registry, &registry_);
+
+    const Key& key = registry.get<Component>(entityId).*Field;
+
+    auto it = keys_.find(entt::to_integral(entityId));
+    DCHECK(it != keys_.end());
+
+    // key not changed i.e. nothing to do
+    if(it->second == key)
+    {
+      return;
+    }
+
+    erase(entityId);
+    insert(entityId, key);
+  }
+
+  void onDestroy(ECS::Registry& registry, ECS::Entity entityId)
+  {
+    DCHECK_EQ(&registry, &registry_);
+
+    erase(entityId);
+  }
+
+  void insert(ECS::Entity entityId, const Key& key)
+  {
+    const bool inserted
+      = keys_.emplace(entt::to_integral(entityId), key).second;
+    DCHECK(inserted);
+    UNREFERENCED_PARAMETER(inserted);
+
+    entities_.emplace(key, entityId);
+  }
+
+  void erase(ECS::Entity entityId)
+  {
+    auto keyIt = keys_.find(entt::to_integral(entityId));
+    DCHECK(keyIt != keys_.end());
+
+    auto range = entities_.equal_range(keyIt->second);
+    for(auto it = range.first; it != range.second; ++it)
+    {
+      if(it->second == entityId)
+      {
+        entities_.erase(it);
+        break;
+      }
+    }
+
+    keys_.erase(keyIt);
+  }
+
+ private:
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  ECS::Registry& registry_;
+
+  // key -> entities with key
+  Storage entities_;
+
+  // entity -> indexed key
+  // (component is already changed when `on_update` is emitted)
+  Keys keys_;
+
+  DISALLOW_COPY_AND_ASSIGN(ComponentIndex);
+};
+
+// Secondary index with O(1) lookup by key.
+template <
+  auto Field
+  , typename Hash = std::hash<
+      typename component_index_internal::field_traits<
+        decltype(Field)
+      >::key_type>
+>
+using HashIndex
+  = ComponentIndex<
+      Field
+      , std::unordered_multimap<
+          typename component_index_internal::field_traits<
+            decltype(Field)
+          >::key_type
+          , ECS::Entity
+          , Hash
+        >
+    >;
+
+// Secondary index with O(log n) lookup by key and range queries.
+template <
+  auto Field
+  , typename Compare = std::less<
+      typename component_index_internal::field_traits<
+        decltype(Field)
+      >::key_type>
+>
+using SortedIndex
+  = ComponentIndex<
+      Field
+      , std::multimap<
+          typename component_index_internal::field_traits<
+            decltype(Field)
+          >::key_type
+          , ECS::Entity
+          , Compare
+        >
+    >;
+
+} // namespace ECS
@@ -0,0 +1,76 @@
+#include "basis/ECS/helpers/algorithm/component_index.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+namespace ECS {
+namespace {
+
+struct Session {
+  std::string token;
+  int expiresAt = 0;
+};
+
+TEST(ComponentIndexTest, HashIndexTracksSignals) {
+  ECS::Registry registry;
+
+  const ECS::Entity early = registry.create();
+  registry.emplace<Session>(early, "early", 0);
+
+  HashIndex<&Session::token> byToken(registry);
+  EXPECT_EQ(early, byToken.find("early"));
+
+  const ECS::Entity entityId = registry.create();
+  registry.emplace<Session>(entityId, "first", 0);
+  EXPECT_EQ(entityId, byToken.find("first"));
+  EXPECT_EQ(2u, byToken.size());
+  EXPECT_GT(byToken.estimateMemoryUsage(), 0u);
+
+  registry.patch<Session>(entityId,
+                          [](Session& session) { session.token = "second"; });
+  EXPECT_EQ(ECS::NULL_ENTITY, byToken.find("first"));
+  EXPECT_EQ(entityId, byToken.find("second"));
+
+  registry.replace<Session>(entityId, "third", 0);
+  EXPECT_EQ(0u, byToken.count("second"));
+  EXPECT_EQ(entityId, byToken.find("third"));
+
+  registry.remove<Session>(entityId);
+  EXPECT_EQ(ECS::NULL_ENTITY, byToken.find("third"));
+
+  registry.destroy(early);
+  EXPECT_EQ(ECS::NULL_ENTITY, byToken.find("early"));
+  EXPECT_EQ(0u, byToken.size());
+}
+
+TEST(ComponentIndexTest, SortedIndexRangeQuery) {
+  ECS::Registry registry;
+
+  SortedIndex<&Session::expiresAt> byExpiration(registry);
+
+  std::vector<ECS::Entity> entities;
+  for (int i = 0; i < 5; ++i) {
+    entities.push_back(registry.create());
+    registry.emplace<Session>(entities.back(), std::string(), 10 * i);
+  }
+
+  std::vector<ECS::Entity> expired;
+  byExpiration.eachInRange(
+      0, 25, [&expired](ECS::Entity entityId) { expired.push_back(entityId); });
+  EXPECT_EQ((std::vector<ECS::Entity>{entities[0], entities[1], entities[2]}),
+            expired);
+
+  // same key for multiple entities
+  registry.patch<Session>(entities[4],
+                          [](Session& session) { session.expiresAt = 0; });
+  EXPECT_EQ(2u, byExpiration.count(0));
+
+  size_t counter = 0;
+  byExpiration.each(0, [&counter](ECS::Entity) { ++counter; });
+  EXPECT_EQ(2u, counter);
+}
+
+}  // namespace
+}  // namespace ECS
@@ -9,6 +9,8 @@ namespace ECS {
 /// \note returns ECS::NULL_ENTITY if can not find
 /// entity with desired components
 /// \note will return only one entity that matches filter
+/// \note iterates view, for lookups by key
+/// prefer `HashIndex` or `SortedIndex` (see component_index.h)
 template<
   // Desired components.
   class... Include
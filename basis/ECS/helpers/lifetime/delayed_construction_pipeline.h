@@ -0,0 +1,308 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/tags.h>
+#include <basis/ECS/helpers/lifetime/populate_delayed_construction_components.h>
+
+#include <base/bind.h>
+#include <base/callback.h>
+#include <base/callback_helpers.h>
+#include <base/location.h>
+#include <base/logging.h>
+#include <base/macros.h>
+#include <base/memory/ref_counted.h>
+#include <base/sequence_checker.h>
+#include <base/synchronization/lock.h>
+#include <base/task/task_traits.h>
+#include <base/task/thread_pool.h>
+#include <base/thread_annotations.h>
+#include <base/trace_event/trace_event.h>
+
+#include <basic/macros.h>
+#include <basic/rvalue_cast.h>
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ECS {
+
+namespace delayed_construction_internal {
+
+template <typename T>
+struct is_tuple : std::false_type {};
+
+template <typename... Types>
+struct is_tuple<std::tuple<Types...>> : std::true_type {};
+
+} // namespace delayed_construction_internal
+
+// Builds heavy components of entities marked with `ECS::DelayedConstruction`
+// on `base::ThreadPool` and commits them into registry in one batch.
+//
+// Builders run in parallel without access to registry,
+// so sequence of registry spends time only on `commitReady`
+// (one `emplace_or_replace` per component).
+//
+// On commit (usually once per tick) for each built entity:
+// * `Payload` is emplaced into entity
+//   (if `Payload` is `std::tuple`, then each element of tuple is emplaced
+//   as separate component)
+// * `ECS::DelayedConstruction` is removed and entity is marked as live
+//   (see `finishDelayedConstruction`)
+// * `ECS::DelayedConstructionJustDone` is emplaced
+//   (and removed on next commit i.e. after one tick)
+//
+// All changes are made within one task on sequence of registry,
+// so other systems never see partially constructed batch.
+//
+/// \note Results for entities that were destroyed (or lost
+/// `ECS::DelayedConstruction`) while building are discarded.
+/// \note Schedule entity in only one pipeline
+/// (commit removes `ECS::DelayedConstruction`), use `std::tuple` as `Payload`
+/// if entity needs multiple heavy components.
+//
+// USAGE
+//
+//  using MeshPayload = std::tuple<MeshComponent, BoundingBoxComponent>;
+//
+//  ECS::DelayedConstructionPipeline<MeshPayload> meshPipeline_{registry};
+//
+//  // on sequence of registry
+//  ECS::populateDelayedConstructionComponents(registry, entityId);
+//  meshPipeline_.schedule(FROM_HERE
+//    , entityId
+//    , ::base::BindOnce(&loadMesh, meshPath));
+//
+//  // once per tick
+//  meshPipeline_.commitReady();
+template <typename Payload>
+class DelayedConstructionPipeline
+{
+ public:
+  // Called on `base::ThreadPool`, must not access registry.
+  using Builder
+    = ::base::OnceCallback<Payload()>;
+
+  explicit DelayedConstructionPipeline(
+    ECS::Registry& registry
+    , const ::base::TaskTraits& traits
+        = {::base::TaskPriority::USER_VISIBLE, ::base::MayBlock()})
+    : registry_(registry)
+    , traits_(traits)
+    , results_(::base::MakeRefCounted<ResultQueue>())
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  }
+
+  ~DelayedConstructionPipeline()
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    /// \note builders that are still running own `results_`,
+    /// their results are discarded
+  }
+
+  // Posts `builder` to `base::ThreadPool`.
+  /// \note entity must have `ECS::DelayedConstruction`
+  /// (see `populateDelayedConstructionComponents`).
+  void schedule(
+    const ::base::Location& from_here
+    , ECS::Entity entityId
+    , Builder builder)
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    DCHECK_ECS_ENTITY(entityId, &registry_);
+    DCHECK(registry_.has<ECS::DelayedConstruction>(entityId));
+    DCHECK(builder);
+
+    ++pendingCount_;
+
+    // Builder may be dropped without run (during shutdown),
+    // guard reports it, so `pendingCount_` is decremented anyway.
+    ::base::ScopedClosureRunner dropGuard(
+      ::base::BindOnce(&ResultQueue::pushDropped, results_));
+
+    ::base::ThreadPool::PostTask(
+      from_here
+      , traits_
+      , ::base::BindOnce(
+          &DelayedConstructionPipeline::build
+          , results_
+          , entityId
+          , RVALUE_CAST(builder)
+          , RVALUE_CAST(dropGuard)));
+  }
+
+  // Commits all built payloads.
+  // Returns number of entities that finished construction.
+  size_t commitReady()
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    TRACE_EVENT0("headless", "DelayedConstructionPipeline::commitReady");
+
+    // `DelayedConstructionJustDone` is expected to be removed after 1 tick
+    for(const ECS::Entity& entityId: justDone_)
+    {
+      if(registry_.valid(entityId))
+      {
+        registry_.remove_if_exists<ECS::DelayedConstructionJustDone>(entityId);
+      }
+    }
+    justDone_.clear();
+
+    size_t droppedCount = 0;
+    std::vector<Result> results = results_->take(&droppedCount);
+    DCHECK_GE(pendingCount_, results.size() + droppedCount);
+    pendingCount_ -= results.size() + droppedCount;
+
+    for(Result& result: results)
+    {
+      const ECS::Entity entityId = result.first;
+
+      // entity was destroyed or construction was cancelled
+      if(!registry_.valid(entityId)
+         || !registry_.has<ECS::DelayedConstruction>(entityId))
+      {
+        DVLOG(9)
+          << "discarded delayed construction of entity: "
+          << entityId;
+        continue;
+      }
+
+      emplacePayload(entityId, RVALUE_CAST(result.second));
+
+      finishDelayedConstruction(registry_, entityId);
+
+      if(!registry_.has<ECS::DelayedConstructionJustDone>(entityId))
+      {
+        registry_.emplace<ECS::DelayedConstructionJustDone>(entityId);
+      }
+
+      justDone_.push_back(entityId);
+    }
+
+    return justDone_.size();
+  }
+
+  // Number of scheduled builders that are not committed yet.
+  /// \note builders dropped without run (during shutdown)
+  /// are subtracted on next `commitReady`.
+  size_t pendingCount() const
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    return pendingCount_;
+  }
+
+ private:
+  using Result
+    = std::pair<ECS::Entity, Payload>;
+
+  // Shared with builders, so pipeline can be destroyed
+  // while builders are running.
+  class ResultQueue
+    : public ::base::RefCountedThreadSafe<ResultQueue>
+  {
+   public:
+    ResultQueue() = default;
+
+    void push(ECS::Entity entityId, Payload&& payload)
+    {
+      ::base::AutoLock lock(lock_);
+      results_.emplace_back(entityId, RVALUE_CAST(payload));
+    }
+
+    // Called if builder was destroyed without run.
+    void pushDropped()
+    {
+      ::base::AutoLock lock(lock_);
+      ++droppedCount_;
+    }
+
+    MUST_USE_RETURN_VALUE
+    std::vector<Result> take(size_t* droppedCount)
+    {
+      DCHECK(droppedCount);
+
+      std::vector<Result> results;
+      {
+        ::base::AutoLock lock(lock_);
+        results.swap(results_);
+        *droppedCount = droppedCount_;
+        droppedCount_ = 0;
+      }
+      return results;
+    }
+
+   private:
+    friend class ::base::RefCountedThreadSafe<ResultQueue>;
+
+    ~ResultQueue() = default;
+
+    ::base::Lock lock_;
+
+    std::vector<Result> results_
+      GUARDED_BY(lock_);
+
+    size_t droppedCount_
+      GUARDED_BY(lock_) = 0;
+
+    DISALLOW_COPY_AND_ASSIGN(ResultQueue);
+  };
+
+  static void build(
+    scoped_refptr<ResultQueue> results
+    , ECS::Entity entityId
+    , Builder builder
+    , ::base::ScopedClosureRunner dropGuard)
+  {
+    TRACE_EVENT0("headless", "DelayedConstructionPipeline::build");
+
+    results->push(entityId, RVALUE_CAST(builder).Run());
+
+    // builder was not dropped
+    ignore_result(dropGuard.Release());
+  }
+
+  void emplacePayload(ECS::Entity entityId, Payload&& payload)
+  {
+    if constexpr (delayed_construction_internal::is_tuple<Payload>::value)
+    {
+      std::apply(
+        [this, entityId](auto&&... components)
+        {
+          (registry_.emplace_or_replace<
+              std::decay_t<decltype(components)>
+            >(entityId, RVALUE_CAST(components)), ...);
+        }
+        , RVALUE_CAST(payload));
+    }
+    else
+    {
+      registry_.emplace_or_replace<Payload>(entityId, RVALUE_CAST(payload));
+    }
+  }
+
+ private:
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  ECS::Registry& registry_;
+
+  const ::base::TaskTraits traits_;
+
+  scoped_refptr<ResultQueue> results_;
+
+  size_t pendingCount_ = 0;
+
+  // Entities committed by previous `commitReady`.
+  std::vector<ECS::Entity> justDone_;
+
+  DISALLOW_COPY_AND_ASSIGN(DelayedConstructionPipeline);
+};
+
+} // namespace ECS
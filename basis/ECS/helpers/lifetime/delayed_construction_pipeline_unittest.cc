@@ -0,0 +1,102 @@
+#include "basis/ECS/helpers/lifetime/delayed_construction_pipeline.h"
+
+#include <basis/ECS/helpers/lifetime/lifecycle_state.h>
+#include <basis/ECS/helpers/lifetime/populate_delayed_construction_components.h>
+
+#include "base/bind.h"
+#include "base/test/task_environment.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <string>
+#include <tuple>
+
+namespace ECS {
+namespace {
+
+struct HeavyName {
+  std::string value;
+};
+
+struct HeavySize {
+  size_t value = 0;
+};
+
+using TestPayload = std::tuple<HeavyName, HeavySize>;
+
+TestPayload buildPayload(const std::string& name) {
+  return TestPayload{HeavyName{name}, HeavySize{name.size()}};
+}
+
+class DelayedConstructionPipelineTest : public testing::Test {
+ protected:
+  base::test::TaskEnvironment task_environment_;
+
+  ECS::Registry registry_;
+};
+
+TEST_F(DelayedConstructionPipelineTest, CommitsBuiltPayloadsInBatch) {
+  DelayedConstructionPipeline<TestPayload> pipeline(registry_);
+
+  const ECS::Entity first = registry_.create();
+  const ECS::Entity second = registry_.create();
+  const ECS::Entity destroyed = registry_.create();
+  for (const ECS::Entity& entityId : {first, second, destroyed}) {
+    populateDelayedConstructionComponents(registry_, entityId);
+  }
+
+  pipeline.schedule(FROM_HERE, first,
+                    base::BindOnce(&buildPayload, "first"));
+  pipeline.schedule(FROM_HERE, second,
+                    base::BindOnce(&buildPayload, "second"));
+  pipeline.schedule(FROM_HERE, destroyed,
+                    base::BindOnce(&buildPayload, "destroyed"));
+  EXPECT_EQ(3u, pipeline.pendingCount());
+
+  // entity destroyed while payload is building
+  registry_.destroy(destroyed);
+
+  // nothing is committed before builders finish
+  EXPECT_FALSE(registry_.has<HeavyName>(first));
+
+  task_environment_.RunUntilIdle();
+
+  EXPECT_EQ(2u, pipeline.commitReady());
+  EXPECT_EQ(0u, pipeline.pendingCount());
+
+  EXPECT_EQ("first", registry_.get<HeavyName>(first).value);
+  EXPECT_EQ(6u, registry_.get<HeavySize>(second).value);
+  for (const ECS::Entity& entityId : {first, second}) {
+    EXPECT_FALSE(registry_.has<ECS::DelayedConstruction>(entityId));
+    EXPECT_TRUE(registry_.has<ECS::DelayedConstructionJustDone>(entityId));
+    EXPECT_TRUE(isLive(registry_, entityId));
+  }
+
+  // `DelayedConstructionJustDone` lives one tick
+  EXPECT_EQ(0u, pipeline.commitReady());
+  EXPECT_FALSE(registry_.has<ECS::DelayedConstructionJustDone>(first));
+  EXPECT_FALSE(registry_.has<ECS::DelayedConstructionJustDone>(second));
+}
+
+TEST_F(DelayedConstructionPipelineTest, DiscardsCancelledConstruction) {
+  DelayedConstructionPipeline<HeavySize> pipeline(registry_);
+
+  const ECS::Entity entityId = registry_.create();
+  populateDelayedConstructionComponents(registry_, entityId);
+
+  pipeline.schedule(FROM_HERE, entityId, base::BindOnce([]() {
+                      return HeavySize{42};
+                    }));
+
+  // construction cancelled
+  registry_.remove<ECS::DelayedConstruction>(entityId);
+
+  task_environment_.RunUntilIdle();
+
+  EXPECT_EQ(0u, pipeline.commitReady());
+  EXPECT_FALSE(registry_.has<HeavySize>(entityId));
+  EXPECT_FALSE(registry_.has<ECS::DelayedConstructionJustDone>(entityId));
+}
+
+}  // namespace
+}  // namespace ECS
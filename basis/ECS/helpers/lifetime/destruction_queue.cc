@@ -0,0 +1,27 @@
+#include "basis/ECS/helpers/lifetime/destruction_queue.h" // IWYU pragma: associated
+
+#include <base/metrics/histogram.h>
+
+namespace ECS {
+
+DestructionQueueMetrics::DestructionQueueMetrics(const std::string& name)
+  : name_(name)
+  , backlogHistogram_(
+      ::base::Histogram::FactoryGet(
+        "Basis.ECS.DestructionQueue." + name + ".Backlog"
+        , 1
+        , 1000000
+        , 50
+        , ::base::HistogramBase::kUmaTargetedHistogramFlag))
+{
+  DCHECK(!name_.empty());
+}
+
+void DestructionQueueMetrics::recordBacklog(size_t backlog)
+{
+  backlogHistogram_->Add(static_cast<int>(
+    std::min<size_t>(backlog, std::numeric_limits<int>::max())));
+  TRACE_COUNTER_ID1("basis.ecs", "DestructionBacklog", this, backlog);
+}
+
+} // namespace ECS
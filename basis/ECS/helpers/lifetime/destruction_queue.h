@@ -0,0 +1,284 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/tags.h>
+
+#include <base/callback.h>
+#include <base/logging.h>
+#include <base/macros.h>
+#include <base/sequence_checker.h>
+#include <base/time/time.h>
+#include <base/trace_event/trace_event.h>
+
+#include <basic/macros.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace base {
+class HistogramBase;
+} // namespace base
+
+namespace ECS {
+
+// Limits work done by `DestructionQueue::process` per tick.
+struct DestructionBudget
+{
+  size_t maxEntities = std::numeric_limits<size_t>::max();
+
+  // Checked after each chunk of entities (see `kDestructionChunkSize`),
+  // so budget may be exceeded by time needed to destroy one chunk.
+  ::base::TimeDelta maxDuration = ::base::TimeDelta::Max();
+};
+
+// Number of entities destroyed between checks of time budget.
+constexpr size_t kDestructionChunkSize = 256;
+
+// Records backlog of `DestructionQueue` as
+// histogram `Basis.ECS.DestructionQueue.<name>.Backlog`
+// and trace counter `DestructionBacklog` (category `basis.ecs`).
+class DestructionQueueMetrics
+{
+ public:
+  explicit DestructionQueueMetrics(const std::string& name);
+
+  void recordBacklog(size_t backlog);
+
+  const std::string& name() const
+  {
+    return name_;
+  }
+
+ private:
+  const std::string name_;
+
+  // Owned by `base::StatisticsRecorder`.
+  ::base::HistogramBase* backlogHistogram_;
+
+  DISALLOW_COPY_AND_ASSIGN(DestructionQueueMetrics);
+};
+
+// Destroys entities marked with `ECS::NeedToDestroyTag`
+// under per-tick budget, so burst of destructions
+// (for example, 50k closed connections) is amortized over multiple ticks.
+//
+// Entities are collected using `on_construct<NeedToDestroyTag>` signal
+// (no per-tick sweep over view).
+//
+// Each chunk of entities is destroyed in "pool-major" order:
+// * `beforeDestroy` is called for each entity
+//   (use it to unlink relationships, see `removeChildFromTopLevel`)
+// * `PoolMajorComponents` are removed pool by pool
+//   (one pass over each pool instead of one pass over all pools per entity),
+//   entities are removed from each pool in descending order
+//   of their index in packed array of that pool, so swap-and-pop
+//   never moves entity that will be removed later
+//   and removal of entities at the tail of pool is plain pop
+// * entities are destroyed
+//
+// USAGE
+//
+//  ECS::DestructionQueue<TcpConnection, Buffers> destructionQueue_{
+//    "TcpConnections"
+//    , registry
+//    , ::base::BindRepeating(&unlinkConnection)};
+//
+//  // once per tick
+//  destructionQueue_.process(ECS::DestructionBudget{
+//    10000, ::base::TimeDelta::FromMilliseconds(2)});
+template <typename... PoolMajorComponents>
+class DestructionQueue
+{
+ public:
+  // Called before entity destruction.
+  using BeforeDestroyCallback
+    = ::base::RepeatingCallback<void(ECS::Registry&, ECS::Entity)>;
+
+  DestructionQueue(
+    const std::string& name
+    , ECS::Registry& registry
+    , BeforeDestroyCallback beforeDestroy = BeforeDestroyCallback())
+    : registry_(registry)
+    , beforeDestroy_(beforeDestroy)
+    , metrics_(name)
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    // entities marked before queue creation
+    for(const ECS::Entity& entityId: registry_.view<ECS::NeedToDestroyTag>())
+    {
+      queue_.push_back(entityId);
+    }
+
+    registry_.on_construct<ECS::NeedToDestroyTag>().template connect<
+      &DestructionQueue::onMarked>(*this);
+  }
+
+  ~DestructionQueue()
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    registry_.on_construct<ECS::NeedToDestroyTag>().disconnect(*this);
+  }
+
+  // Destroys marked entities within `budget`.
+  // Returns number of destroyed entities.
+  size_t process(const DestructionBudget& budget)
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    TRACE_EVENT0("headless", "DestructionQueue::process");
+
+    const ::base::TimeTicks deadline
+      = budget.maxDuration.is_max()
+        ? ::base::TimeTicks::Max()
+        : ::base::TimeTicks::Now() + budget.maxDuration;
+
+    size_t destroyed = 0;
+
+    while(!queue_.empty() && destroyed < budget.maxEntities)
+    {
+      const size_t chunkSize
+        = std::min({queue_.size()
+          , kDestructionChunkSize
+          , budget.maxEntities - destroyed});
+
+      destroyed += destroyChunk(chunkSize);
+
+      if(::base::TimeTicks::Now() >= deadline)
+      {
+        break;
+      }
+    }
+
+    metrics_.recordBacklog(queue_.size());
+
+    return destroyed;
+  }
+
+  // Number of marked entities that are not destroyed yet.
+  /// \note may include entities that lost `NeedToDestroyTag`
+  /// (they are skipped by `process`).
+  size_t backlog() const
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    return queue_.size();
+  }
+
+ private:
+  void onMarked(ECS::Registry& registry, ECS::Entity entityId)
+  {
+    DCHECK_EQ(&registry, &registry_);
+
+    queue_.push_back(entityId);
+  }
+
+  size_t destroyChunk(size_t chunkSize)
+  {
+    chunk_.clear();
+
+    for(size_t i = 0; i < chunkSize; ++i)
+    {
+      const ECS::Entity entityId = queue_.front();
+      queue_.pop_front();
+
+      // destroyed by someone else or not marked anymore
+      if(!registry_.valid(entityId)
+         || !registry_.has<ECS::NeedToDestroyTag>(entityId))
+      {
+        continue;
+      }
+
+      chunk_.push_back(entityId);
+    }
+
+    // entity may be marked twice (tag removed and emplaced again)
+    std::sort(chunk_.begin(), chunk_.end());
+    chunk_.erase(std::unique(chunk_.begin(), chunk_.end()), chunk_.end());
+
+    if(beforeDestroy_)
+    {
+      for(const ECS::Entity& entityId: chunk_)
+      {
+        beforeDestroy_.Run(registry_, entityId);
+      }
+    }
+
+    (removeFromPool<PoolMajorComponents>(), ...);
+
+    for(const ECS::Entity& entityId: chunk_)
+    {
+      // `beforeDestroy` is allowed to destroy entity
+      if(registry_.valid(entityId))
+      {
+        registry_.destroy(entityId);
+      }
+    }
+
+    return chunk_.size();
+  }
+
+  template <typename Component>
+  void removeFromPool()
+  {
+    auto view = registry_.view<Component>();
+
+    poolChunk_.clear();
+    for(const ECS::Entity& entityId: chunk_)
+    {
+      if(registry_.valid(entityId) && view.contains(entityId))
+      {
+        // index of entity in packed array of pool
+        const size_t packedIndex
+          = static_cast<size_t>(
+              std::addressof(*view.find(entityId)) - view.data());
+        poolChunk_.emplace_back(packedIndex, entityId);
+      }
+    }
+
+    std::sort(poolChunk_.begin(), poolChunk_.end()
+      , [](const PackedEntity& left, const PackedEntity& right)
+        {
+          return left.first > right.first;
+        });
+
+    for(const PackedEntity& packed: poolChunk_)
+    {
+      registry_.remove<Component>(packed.second);
+    }
+  }
+
+ private:
+  // Index in packed array of pool and entity.
+  using PackedEntity
+    = std::pair<size_t, ECS::Entity>;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  ECS::Registry& registry_;
+
+  BeforeDestroyCallback beforeDestroy_;
+
+  DestructionQueueMetrics metrics_;
+
+  std::deque<ECS::Entity> queue_;
+
+  // Re-used between chunks to avoid allocations.
+  std::vector<ECS::Entity> chunk_;
+
+  // Entities of `chunk_` that are stored in pool,
+  // re-used between pools to avoid allocations.
+  std::vector<PackedEntity> poolChunk_;
+
+  DISALLOW_COPY_AND_ASSIGN(DestructionQueue);
+};
+
+} // namespace ECS
@@ -0,0 +1,109 @@
+#include "basis/ECS/helpers/lifetime/destruction_queue.h"
+
+#include "base/bind.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <vector>
+
+namespace ECS {
+namespace {
+
+struct Payload {
+  int value = 0;
+};
+
+TEST(DestructionQueueTest, DestroysWithinCountBudget) {
+  ECS::Registry registry;
+
+  // marked before queue creation
+  const ECS::Entity early = registry.create();
+  registry.emplace<ECS::NeedToDestroyTag>(early);
+
+  std::vector<ECS::Entity> unlinked;
+  DestructionQueue<Payload> queue(
+      "Test", registry,
+      base::BindRepeating(
+          [](std::vector<ECS::Entity>* unlinked, ECS::Registry& registry,
+             ECS::Entity entityId) {
+            EXPECT_TRUE(registry.valid(entityId));
+            unlinked->push_back(entityId);
+          },
+          base::Unretained(&unlinked)));
+
+  std::vector<ECS::Entity> entities;
+  for (int i = 0; i < 10; ++i) {
+    entities.push_back(registry.create());
+    registry.emplace<Payload>(entities.back(), i);
+    registry.emplace<ECS::NeedToDestroyTag>(entities.back());
+  }
+
+  // not marked anymore
+  registry.remove<ECS::NeedToDestroyTag>(entities[9]);
+
+  EXPECT_EQ(11u, queue.backlog());
+
+  DestructionBudget budget;
+  budget.maxEntities = 4;
+  EXPECT_EQ(4u, queue.process(budget));
+  EXPECT_FALSE(registry.valid(early));
+  EXPECT_EQ(7u, queue.backlog());
+
+  ASSERT_EQ(4u, unlinked.size());
+  EXPECT_EQ(early, unlinked[0]);
+  EXPECT_EQ(entities[2], unlinked[3]);
+
+  EXPECT_EQ(6u, queue.process(DestructionBudget{}));
+  EXPECT_EQ(0u, queue.backlog());
+
+  for (int i = 0; i < 9; ++i) {
+    EXPECT_FALSE(registry.valid(entities[i]));
+  }
+  EXPECT_TRUE(registry.valid(entities[9]));
+  EXPECT_EQ(9, registry.get<Payload>(entities[9]).value);
+}
+
+// Records order of removal from pool of `Payload`.
+struct PayloadRemovals {
+  void onDestroy(ECS::Registry&, ECS::Entity entityId) {
+    removed.push_back(entityId);
+  }
+
+  std::vector<ECS::Entity> removed;
+};
+
+TEST(DestructionQueueTest, RemovesFromPoolInDescendingPackedOrder) {
+  ECS::Registry registry;
+
+  std::vector<ECS::Entity> entities(6);
+  registry.create(entities.begin(), entities.end());
+  // packed order of pool differs from order of identifiers
+  for (auto it = entities.rbegin(); it != entities.rend(); ++it) {
+    registry.emplace<Payload>(*it);
+  }
+
+  PayloadRemovals removals;
+  registry.on_destroy<Payload>().connect<&PayloadRemovals::onDestroy>(
+      removals);
+
+  DestructionQueue<Payload> queue("TestPackedOrder", registry);
+
+  // packed indexes: entities[4] -> 1, entities[0] -> 5, entities[2] -> 3
+  registry.emplace<ECS::NeedToDestroyTag>(entities[4]);
+  registry.emplace<ECS::NeedToDestroyTag>(entities[0]);
+  registry.emplace<ECS::NeedToDestroyTag>(entities[2]);
+
+  EXPECT_EQ(3u, queue.process(DestructionBudget{}));
+
+  ASSERT_EQ(3u, removals.removed.size());
+  EXPECT_EQ(entities[0], removals.removed[0]);
+  EXPECT_EQ(entities[2], removals.removed[1]);
+  EXPECT_EQ(entities[4], removals.removed[2]);
+
+  EXPECT_EQ(3u, registry.size<Payload>());
+
+  registry.on_destroy<Payload>().disconnect(removals);
+}
+
+}  // namespace
+}  // namespace ECS
@@ -0,0 +1,84 @@
+#include "basis/ECS/helpers/lifetime/lifecycle_state.h" // IWYU pragma: associated
+
+#include <base/logging.h>
+
+namespace ECS {
+
+void markLive(
+  ECS::Registry& registry
+  , ECS::Entity entityId)
+{
+  DCHECK_ECS_ENTITY(entityId, &registry);
+
+  DCHECK(!registry.has<ECS::DelayedConstruction>(entityId));
+  DCHECK(!registry.has<ECS::NeedToDestroyTag>(entityId));
+  DCHECK(!registry.has<ECS::UnusedTag>(entityId));
+
+  if(!registry.has<ECS::LiveTag>(entityId))
+  {
+    registry.emplace<ECS::LiveTag>(entityId);
+  }
+}
+
+void markNotLive(
+  ECS::Registry& registry
+  , ECS::Entity entityId)
+{
+  DCHECK_ECS_ENTITY(entityId, &registry);
+
+  registry.remove_if_exists<ECS::LiveTag>(entityId);
+}
+
+void markNeedToDestroy(
+  ECS::Registry& registry
+  , ECS::Entity entityId)
+{
+  markNotLive(registry, entityId);
+
+  if(!registry.has<ECS::NeedToDestroyTag>(entityId))
+  {
+    registry.emplace<ECS::NeedToDestroyTag>(entityId);
+  }
+}
+
+void markUnused(
+  ECS::Registry& registry
+  , ECS::Entity entityId)
+{
+  markNotLive(registry, entityId);
+
+  if(!registry.has<ECS::UnusedTag>(entityId))
+  {
+    registry.emplace<ECS::UnusedTag>(entityId);
+  }
+}
+
+LifecycleState lifecycleState(
+  const ECS::Registry& registry
+  , ECS::Entity entityId)
+{
+  DCHECK_ECS_ENTITY(entityId, &registry);
+
+  if(registry.has<ECS::LiveTag>(entityId))
+  {
+    DCHECK(!registry.has<ECS::DelayedConstruction>(entityId));
+    DCHECK(!registry.has<ECS::NeedToDestroyTag>(entityId));
+    DCHECK(!registry.has<ECS::UnusedTag>(entityId));
+    return LifecycleState::Live;
+  }
+
+  // destruction has priority over other states
+  if(registry.has<ECS::NeedToDestroyTag>(entityId))
+  {
+    return LifecycleState::Destroying;
+  }
+
+  if(registry.has<ECS::UnusedTag>(entityId))
+  {
+    return LifecycleState::Unused;
+  }
+
+  return LifecycleState::Constructing;
+}
+
+} // namespace ECS
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/tags.h>
+
+#include <basic/macros.h>
+
+namespace ECS {
+
+// Lifecycle state of entity.
+//
+// Only `Live` entities have `ECS::LiveTag`,
+// so hot systems iterate only live entities without exclusion tests:
+//
+// BEFORE
+//
+//  registry.view<Position, Velocity>(ECS::exclude_not_constructed<>)
+//
+// AFTER
+//
+//  ECS::viewLive<Position, Velocity>(registry)
+//
+/// \note Tags (`DelayedConstruction`, `NeedToDestroyTag`, `UnusedTag`)
+/// are still used to find entities in other states,
+/// so helpers below keep tags and `ECS::LiveTag` consistent.
+enum class LifecycleState
+{
+  // Has `DelayedConstruction` (or not marked as live yet).
+  Constructing
+  // Has `LiveTag`.
+  , Live
+  // Has `UnusedTag` (stored in memory pool).
+  , Unused
+  // Has `NeedToDestroyTag`.
+  , Destroying
+};
+
+// Marks fully constructed entity as live.
+/// \note entity must not have `DelayedConstruction`,
+/// `NeedToDestroyTag` or `UnusedTag`.
+void markLive(
+  ECS::Registry& registry
+  , ECS::Entity entityId);
+
+// Removes entity from set of live entities.
+void markNotLive(
+  ECS::Registry& registry
+  , ECS::Entity entityId);
+
+// Marks entity as scheduled for destruction
+// (emplaces `NeedToDestroyTag` and removes `LiveTag`).
+void markNeedToDestroy(
+  ECS::Registry& registry
+  , ECS::Entity entityId);
+
+// Marks entity as unused i.e. stored in memory pool
+// (emplaces `UnusedTag` and removes `LiveTag`).
+void markUnused(
+  ECS::Registry& registry
+  , ECS::Entity entityId);
+
+MUST_USE_RETURN_VALUE
+LifecycleState lifecycleState(
+  const ECS::Registry& registry
+  , ECS::Entity entityId);
+
+MUST_USE_RETURN_VALUE
+inline bool isLive(
+  const ECS::Registry& registry
+  , ECS::Entity entityId)
+{
+  return registry.has<ECS::LiveTag>(entityId);
+}
+
+// View of live entities that have `Components`.
+//
+// USAGE
+//
+//  ECS::viewLive<Position, Velocity>(registry).each(
+//    [](ECS::Entity entityId, Position& pos, Velocity& vel){ ... });
+//
+//  // user excludes are still supported
+//  ECS::viewLive<Position>(registry, ECS::exclude<Frozen>);
+template<
+  typename... Components
+  , typename... Exclude
+>
+MUST_USE_RETURN_VALUE
+auto viewLive(
+  ECS::Registry& registry
+  , ECS::exclude_t<Exclude...> = {})
+{
+  return registry.view<ECS::LiveTag, Components...>(
+    entt::exclude<Exclude...>);
+}
+
+} // namespace ECS
@@ -0,0 +1,126 @@
+#include "basis/ECS/helpers/lifetime/lifecycle_state.h"
+#include "basis/ECS/helpers/lifetime/exclude_not_constructed.h"
+
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+namespace ECS {
+
+namespace {
+
+struct PerfPosition {
+  float x = 0.0f;
+  float y = 0.0f;
+};
+
+struct PerfVelocity {
+  float dx = 1.0f;
+  float dy = 1.0f;
+};
+
+// Each `state.range(1)`-th entity is not live
+// (rotates between constructing, destroying and unused).
+void populate(ECS::Registry& registry, benchmark::State& state) {
+  const int64_t entities = state.range(0);
+  const int64_t notLiveEvery = state.range(1);
+
+  for (int64_t i = 0; i < entities; ++i) {
+    const ECS::Entity entityId = registry.create();
+    registry.emplace<PerfPosition>(entityId);
+    registry.emplace<PerfVelocity>(entityId);
+
+    if (i % notLiveEvery != 0) {
+      markLive(registry, entityId);
+      continue;
+    }
+
+    switch ((i / notLiveEvery) % 3) {
+      case 0:
+        registry.emplace<ECS::DelayedConstruction>(entityId);
+        break;
+      case 1:
+        markNeedToDestroy(registry, entityId);
+        break;
+      default:
+        markUnused(registry, entityId);
+        break;
+    }
+  }
+}
+
+void BM_IterateExcludeNotConstructed(benchmark::State& state) {
+  ECS::Registry registry;
+  populate(registry, state);
+
+  for (auto _ : state) {
+    registry.view<PerfPosition, const PerfVelocity>(
+      ECS::exclude_not_constructed<>).each(
+        [](PerfPosition& pos, const PerfVelocity& vel) {
+          pos.x += vel.dx;
+          pos.y += vel.dy;
+        });
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_IterateLive(benchmark::State& state) {
+  ECS::Registry registry;
+  populate(registry, state);
+
+  for (auto _ : state) {
+    viewLive<PerfPosition, const PerfVelocity>(registry).each(
+      [](PerfPosition& pos, const PerfVelocity& vel) {
+        pos.x += vel.dx;
+        pos.y += vel.dy;
+      });
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Cost of state transition: constructing -> live -> constructing.
+void BM_TagTransition(benchmark::State& state) {
+  ECS::Registry registry;
+  populate(registry, state);
+  const ECS::Entity entityId = registry.create();
+
+  for (auto _ : state) {
+    registry.emplace<ECS::DelayedConstruction>(entityId);
+    registry.remove<ECS::DelayedConstruction>(entityId);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_LiveTransition(benchmark::State& state) {
+  ECS::Registry registry;
+  populate(registry, state);
+  const ECS::Entity entityId = registry.create();
+
+  for (auto _ : state) {
+    markLive(registry, entityId);
+    markNotLive(registry, entityId);
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+
+void Arguments(benchmark::internal::Benchmark* bench) {
+  bench
+    ->Args({10000, 10})
+    ->Args({100000, 10})
+    ->Args({100000, 2});
+}
+
+BENCHMARK(BM_IterateExcludeNotConstructed)->Apply(Arguments);
+BENCHMARK(BM_IterateLive)->Apply(Arguments);
+BENCHMARK(BM_TagTransition)->Args({10000, 10});
+BENCHMARK(BM_LiveTransition)->Args({10000, 10});
+
+}  // namespace
+
+}  // namespace ECS
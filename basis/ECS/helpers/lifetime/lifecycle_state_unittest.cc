@@ -0,0 +1,107 @@
+#include "basis/ECS/helpers/lifetime/lifecycle_state.h"
+
+#include "basis/ECS/helpers/lifetime/populate_delayed_construction_components.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace ECS {
+namespace {
+
+struct Position {
+  int x = 0;
+};
+
+size_t countLive(ECS::Registry& registry) {
+  size_t count = 0;
+  for (const ECS::Entity entityId : viewLive<Position>(registry)) {
+    ignore_result(entityId);
+    ++count;
+  }
+  return count;
+}
+
+TEST(LifecycleStateTest, MarkLive) {
+  ECS::Registry registry;
+  const ECS::Entity entityId = registry.create();
+  registry.emplace<Position>(entityId);
+
+  EXPECT_EQ(LifecycleState::Constructing, lifecycleState(registry, entityId));
+  EXPECT_FALSE(isLive(registry, entityId));
+  EXPECT_EQ(0u, countLive(registry));
+
+  markLive(registry, entityId);
+  // second call does nothing
+  markLive(registry, entityId);
+
+  EXPECT_EQ(LifecycleState::Live, lifecycleState(registry, entityId));
+  EXPECT_TRUE(isLive(registry, entityId));
+  EXPECT_EQ(1u, countLive(registry));
+
+  markNotLive(registry, entityId);
+  EXPECT_EQ(LifecycleState::Constructing, lifecycleState(registry, entityId));
+  EXPECT_EQ(0u, countLive(registry));
+}
+
+TEST(LifecycleStateTest, MarkNeedToDestroy) {
+  ECS::Registry registry;
+  const ECS::Entity entityId = registry.create();
+  registry.emplace<Position>(entityId);
+  markLive(registry, entityId);
+
+  markNeedToDestroy(registry, entityId);
+  // second call does nothing
+  markNeedToDestroy(registry, entityId);
+
+  EXPECT_EQ(LifecycleState::Destroying, lifecycleState(registry, entityId));
+  EXPECT_TRUE(registry.has<ECS::NeedToDestroyTag>(entityId));
+  EXPECT_FALSE(isLive(registry, entityId));
+  EXPECT_EQ(0u, countLive(registry));
+}
+
+TEST(LifecycleStateTest, MarkUnused) {
+  ECS::Registry registry;
+  const ECS::Entity entityId = registry.create();
+  markLive(registry, entityId);
+
+  markUnused(registry, entityId);
+  EXPECT_EQ(LifecycleState::Unused, lifecycleState(registry, entityId));
+  EXPECT_FALSE(isLive(registry, entityId));
+
+  // destruction has priority over other states
+  markNeedToDestroy(registry, entityId);
+  EXPECT_EQ(LifecycleState::Destroying, lifecycleState(registry, entityId));
+}
+
+TEST(LifecycleStateTest, DelayedConstructionMarksLive) {
+  ECS::Registry registry;
+  const ECS::Entity entityId = registry.create();
+  markLive(registry, entityId);
+
+  populateDelayedConstructionComponents(registry, entityId);
+  registry.emplace<Position>(entityId);
+
+  EXPECT_EQ(LifecycleState::Constructing, lifecycleState(registry, entityId));
+  EXPECT_EQ(0u, countLive(registry));
+
+  finishDelayedConstruction(registry, entityId);
+
+  EXPECT_FALSE(registry.has<ECS::DelayedConstruction>(entityId));
+  EXPECT_EQ(LifecycleState::Live, lifecycleState(registry, entityId));
+  EXPECT_EQ(1u, countLive(registry));
+}
+
+TEST(LifecycleStateTest, DestroyedWhileConstructingIsNotLive) {
+  ECS::Registry registry;
+  const ECS::Entity entityId = registry.create();
+
+  populateDelayedConstructionComponents(registry, entityId);
+  markNeedToDestroy(registry, entityId);
+
+  finishDelayedConstruction(registry, entityId);
+
+  EXPECT_EQ(LifecycleState::Destroying, lifecycleState(registry, entityId));
+  EXPECT_FALSE(isLive(registry, entityId));
+}
+
+}  // namespace
+}  // namespace ECS
@@ -1,5 +1,6 @@
 ﻿#include "basis/ECS/helpers/lifetime/populate_delayed_construction_components.h" // IWYU pragma: associated
 #include <basis/ECS/tags.h>
+#include <basis/ECS/helpers/lifetime/lifecycle_state.h>
 
 namespace ECS {
 
@@ -8,8 +9,19 @@ void populateDelayedConstructionComponents(
   , ECS::Entity entityId)
 {
   // mark entity as not fully created
-  registry.template emplace_or_replace<
-      ECS::DelayedConstruction
+  /// \note `emplace_or_replace` would emit `on_update`
+  /// for already marked entity, so check tag first
+  if(!registry.template has<ECS::DelayedConstruction>(entityId))
+  {
+    registry.template emplace<
+        ECS::DelayedConstruction
+      >(entityId);
+  }
+
+  // entity in construction can not be updated by hot systems
+  // (see `ECS::viewLive`)
+  registry.template remove_if_exists<
+      ECS::LiveTag
     >(entityId);
 
   // mark entity as not fully created
@@ -18,4 +30,23 @@ void populateDelayedConstructionComponents(
     >(entityId);
 }
 
+void finishDelayedConstruction(
+  ECS::Registry& registry
+  , ECS::Entity entityId)
+{
+  DCHECK_ECS_ENTITY(entityId, &registry);
+
+  registry.template remove_if_exists<
+      ECS::DelayedConstruction
+    >(entityId);
+
+  if(registry.template has<ECS::NeedToDestroyTag>(entityId)
+     || registry.template has<ECS::UnusedTag>(entityId))
+  {
+    return;
+  }
+
+  markLive(registry, entityId);
+}
+
 } // namespace ECS
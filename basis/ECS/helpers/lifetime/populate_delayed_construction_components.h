@@ -8,6 +8,7 @@ namespace ECS {
 // So upon construction, entity must have `ECS::DelayedConstruction` component.
 // We assume that `entity` will be constructed within 1 tick,
 // then delete `ECS::DelayedConstruction` component
+// (see `finishDelayedConstruction`).
 // \note Do not forget to skip entity updates
 // if it has `ECS::DelayedConstruction` component.
 // \note Do not forget to properly free entity during termination
@@ -21,4 +22,14 @@ void populateDelayedConstructionComponents(
   ECS::Registry& registry
   , ECS::Entity entityId);
 
+// Call it when all custom components were added to entity
+// (counterpart of `populateDelayedConstructionComponents`).
+// Removes `ECS::DelayedConstruction` and marks entity as live
+// (see `ECS::markLive`), so entity becomes visible to `ECS::viewLive`.
+/// \note entity scheduled for destruction (or stored in memory pool)
+/// while it was constructed is not marked as live.
+void finishDelayedConstruction(
+  ECS::Registry& registry
+  , ECS::Entity entityId);
+
 } // namespace ECS
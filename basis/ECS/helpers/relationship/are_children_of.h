@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/components/relationship/parent_entity.h>
+#include <basis/ECS/helpers/relationship/has_child_at_top_level.h>
+
+#include <base/logging.h>
+#include <base/macros.h>
+
+#include <basic/macros.h>
+
+#include <vector>
+
+namespace ECS {
+
+/// \note does not iterate hierarchy recursively
+/// i.e. does not iterate children of children of children...
+//
+// Bulk version of `hasChildAtTopLevel`.
+// Returns `true` if each of `candidates` is child of `parentId` (at top level).
+//
+// Storage of `ParentComponent` is looked up once for all `candidates`,
+// then each candidate costs one sparse set lookup.
+//
+// If `isChild` is not null, then it will contain result for each candidate
+// (in same order as `candidates`).
+//
+/// \note `NULL_ENTITY` is never child of any entity.
+//
+// USAGE
+//
+//  std::vector<bool> isChild;
+//  bool allChildren = ECS::areChildrenOf<TagType>(
+//    registry, parentId, selectedEntities, &isChild);
+template <
+  typename TagType // unique type tag for all children
+  , typename Container // any iterable container of `ECS::Entity`
+>
+MUST_USE_RETURN_VALUE
+bool areChildrenOf(
+  ECS::Registry& registry
+  , ECS::Entity parentId
+  , const Container& candidates
+  , std::vector<bool>* isChild = nullptr)
+{
+  using ParentComponent = ParentEntity<TagType>;
+
+  if(isChild)
+  {
+    isChild->clear();
+  }
+
+  auto parentView = registry.view<ParentComponent>();
+
+  bool allChildren = true;
+
+  for(const ECS::Entity& candidateId: candidates)
+  {
+    const bool candidateIsChild
+      = parentId != ECS::NULL_ENTITY
+        && candidateId != ECS::NULL_ENTITY
+        && parentView.contains(candidateId)
+        && parentView.get(candidateId).parentId == parentId;
+
+    DCHECK_CHILD_IN_TOP_LEVEL_LIST(
+      REFERENCED(registry)
+      , parentId
+      , candidateId
+      , candidateIsChild
+      , TagType);
+
+    allChildren = allChildren && candidateIsChild;
+
+    if(isChild)
+    {
+      isChild->push_back(candidateIsChild);
+    }
+    else if(!allChildren)
+    {
+      // no need to check other candidates
+      break;
+    }
+  }
+
+  return allChildren;
+}
+
+} // namespace ECS
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/components/relationship/hierarchy_node.h>
+#include <basis/ECS/helpers/relationship/foreach_top_level_child.h>
+
+#include <base/logging.h>
+#include <base/callback.h>
+
+#include <basic/macros.h>
+
+namespace ECS {
+
+/// \note does not iterate hierarchy recursively
+/// i.e. does not iterate children of children of children...
+//
+// Same as `foreachTopLevelChild`, but for fused `HierarchyNode` layout
+// i.e. each step touches one pool instead of two.
+//
+/// \note callback may remove `HierarchyNode` of iterated child
+/// (id of next child is cached before callback).
+template <
+  typename TagType // unique type tag for all children
+>
+void foreachChildNode(
+  ECS::Registry& registry
+  , ECS::Entity parentId
+  , foreachTopLevelChildCb callback)
+{
+  using Node = HierarchyNode<TagType>;
+
+  if(parentId == ECS::NULL_ENTITY)
+  {
+    return;
+  }
+
+  DCHECK_ECS_ENTITY(parentId, &registry);
+
+  // sanity check
+  DCHECK(callback);
+
+  // pool is looked up once for all nodes
+  auto nodes = registry.view<Node>();
+
+  if(!nodes.contains(parentId))
+  {
+    return;
+  }
+
+  ECS::Entity currChild = nodes.get(parentId).firstChildId;
+
+  while(currChild != ECS::NULL_ENTITY)
+  {
+    DCHECK_ECS_ENTITY(currChild, &registry);
+
+    // sanity check
+    DCHECK(currChild != parentId);
+
+    DCHECK(nodes.contains(currChild));
+
+    // cache some data because callback may free compoments
+    const ECS::Entity nextCurrChild
+      = nodes.get(currChild).nextId;
+
+    DCHECK_EQ(nodes.get(currChild).parentId, parentId);
+
+    /// \note callback may destroy `currChild` or any components
+    callback.Run(REFERENCED(registry), parentId, currChild);
+
+    // sanity check
+    DCHECK((nextCurrChild != ECS::NULL_ENTITY)
+      ? registry.valid(nextCurrChild)
+      // no check for ECS::NULL_ENTITY
+      : true);
+
+    currChild = nextCurrChild;
+  }
+}
+
+} // namespace ECS
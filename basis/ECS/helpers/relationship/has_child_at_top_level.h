@@ -12,23 +12,44 @@
 
 #include <basic/macros.h>
 
+// Define `ECS_VALIDATE_RELATIONSHIP_LISTS=1`
+// (see CMake option `ENABLE_ECS_VALIDATE_RELATIONSHIP_LISTS`)
+// to cross-check O(1) relationship queries against walk over linked list.
+/// \note disabled by default even if `DCHECK_IS_ON()`,
+/// because walk is O(children) per query.
+#if !defined(ECS_VALIDATE_RELATIONSHIP_LISTS)
+#define ECS_VALIDATE_RELATIONSHIP_LISTS 0
+#endif
+
+// USAGE
+//
+// DCHECK_CHILD_IN_TOP_LEVEL_LIST(registry, parentId, childId, true, TagType);
+#if ECS_VALIDATE_RELATIONSHIP_LISTS
+#define DCHECK_CHILD_IN_TOP_LEVEL_LIST(__registry__, __parent__, __child__, __expected__, __tag_type__) \
+  DCHECK_EQ(__expected__ \
+    , ::ECS::hasChildInTopLevelList<__tag_type__>(__registry__, __parent__, __child__))
+#else
+#define DCHECK_CHILD_IN_TOP_LEVEL_LIST(__registry__, __parent__, __child__, __expected__, __tag_type__)
+#endif
+
 namespace ECS {
 
 /// \note does not iterate hierarchy recursively
 /// i.e. does not iterate children of children of children...
 //
-// Unlike `isParentAtTopLevelOf` or `isChildAtTopLevelOf` it will iterate all
-// nodes in linked list (only at top level) until `childIdToFind` found,
-// even if `ParentComponent` alrady points to `parentId`.
-/// \note prefer `isParentAtTopLevelOf` or `isChildAtTopLevelOf` because of performance reasons
-/// (you can check if element is part of hierarchy without iteration).
+// Walks all nodes in linked list (only at top level)
+// until `childIdToFind` found i.e. O(children) per call.
+//
+/// \note use it only for validation of linked list
+/// (see `ECS_VALIDATE_RELATIONSHIP_LISTS`),
+/// prefer `hasChildAtTopLevel` or `areChildrenOf`.
 /// \note returns `false` if child not found
 /// \note expects no child element duplication in linked list
 template <
   typename TagType // unique type tag for all children
 >
 MUST_USE_RETURN_VALUE
-bool hasChildAtTopLevel(
+bool hasChildInTopLevelList(
   ECS::Registry& registry
   , ECS::Entity parentId
   , ECS::Entity childIdToFind)
@@ -102,4 +123,46 @@ bool hasChildAtTopLevel(
   return false;
 }
 
+/// \note does not iterate hierarchy recursively
+/// i.e. does not iterate children of children of children...
+//
+// Checks only `ParentComponent` of `childIdToFind` i.e. O(1) per call.
+//
+/// \note returns `false` if child not found
+template <
+  typename TagType // unique type tag for all children
+>
+MUST_USE_RETURN_VALUE
+bool hasChildAtTopLevel(
+  ECS::Registry& registry
+  , ECS::Entity parentId
+  , ECS::Entity childIdToFind)
+{
+  using FirstChildComponent = FirstChildInLinkedList<TagType>;
+  using ParentComponent = ParentEntity<TagType>;
+
+  if(parentId == ECS::NULL_ENTITY
+     || childIdToFind == ECS::NULL_ENTITY)
+  {
+    return false;
+  }
+
+  DCHECK_ECS_ENTITY(parentId, &registry);
+
+  DCHECK_ECS_ENTITY(childIdToFind, &registry);
+
+  const ParentComponent* parentComp
+    = registry.try_get<ParentComponent>(childIdToFind);
+
+  const bool isChild
+    = parentComp && parentComp->parentId == parentId;
+
+  DCHECK(!isChild || registry.has<FirstChildComponent>(parentId));
+
+  DCHECK_CHILD_IN_TOP_LEVEL_LIST(
+    registry, parentId, childIdToFind, isChild, TagType);
+
+  return isChild;
+}
+
 } // namespace ECS
@@ -19,7 +19,7 @@ namespace ECS {
 /// \note does not iterate hierarchy recursively
 /// i.e. does not iterate children of children of children...
 //
-// Unlike `hasChildAtTopLevel` it will not iterate nodes in linked list,
+// Unlike `hasChildInTopLevelList` it will not iterate nodes in linked list,
 // but check only `ParentComponent`.
 template <
   typename TagType // unique type tag for all children
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/components/relationship/hierarchy_node.h>
+
+#include <base/logging.h>
+
+#include <basic/macros.h>
+
+namespace ECS {
+
+/// \note does not iterate hierarchy recursively
+/// i.e. does not iterate children of children of children...
+//
+// Same as `isChildAtTopLevelOf`, but for fused `HierarchyNode` layout
+// i.e. one lookup in one pool.
+template <
+  typename TagType // unique type tag for all children
+>
+MUST_USE_RETURN_VALUE
+bool isChildNodeOf(
+  ECS::Registry& registry
+  , ECS::Entity parentId
+  , ECS::Entity childId)
+{
+  using Node = HierarchyNode<TagType>;
+
+  if(parentId == ECS::NULL_ENTITY
+     || childId == ECS::NULL_ENTITY)
+  {
+    return false;
+  }
+
+  DCHECK_ECS_ENTITY(parentId, &registry);
+
+  DCHECK_ECS_ENTITY(childId, &registry);
+
+  const Node* childNode
+    = registry.try_get<Node>(childId);
+
+  return childNode && childNode->parentId == parentId;
+}
+
+} // namespace ECS
@@ -19,7 +19,7 @@ namespace ECS {
 /// \note does not iterate hierarchy recursively
 /// i.e. does not iterate children of children of children...
 //
-// Unlike `hasChildAtTopLevel` it will not iterate nodes in linked list,
+// Unlike `hasChildInTopLevelList` it will not iterate nodes in linked list,
 // but check only `ParentComponent`.
 template <
   typename TagType // unique type tag for all children
@@ -69,9 +69,8 @@ bool isParentAtTopLevelOf(
   const bool isParentByComponent
     = registry.get<ParentComponent>(childId).parentId == parentId;
 
-  DCHECK(isParentByComponent
-    ? hasChildAtTopLevel<TagType>(REFERENCED(registry), parentId, childId)
-    : !hasChildAtTopLevel<TagType>(REFERENCED(registry), parentId, childId));
+  DCHECK_CHILD_IN_TOP_LEVEL_LIST(
+    REFERENCED(registry), parentId, childId, isParentByComponent, TagType);
 
   return isParentByComponent;
 }
@@ -22,6 +22,8 @@ namespace ECS {
 /// \note expects no child element duplication in linked list
 /// \note Prefer to use it if order of children does not matter
 /// (for performance reasons).
+/// \note Existing components are modified using `patch`,
+/// so `on_update` is emitted (see `RegistryDeltaTracker`).
 template <
   typename TagType // unique type tag for all children
 >
@@ -51,7 +53,7 @@ void prependChildEntity(
 
   DCHECK_ECS_ENTITY(childId, &registry);
 
-  FirstChildComponent* firstChild
+  const FirstChildComponent* firstChild
     = registry.try_get<FirstChildComponent>(parentId);
 
   // mark child as part of linked list
@@ -83,33 +85,44 @@ void prependChildEntity(
     // increment size of linked list
     {
       DCHECK(registry.has<ChildrenSizeComponent>(parentId));
-      ChildrenSizeComponent& childrenSize
-        = registry.get<ChildrenSizeComponent>(parentId);
-      /// \note runtime check (affects performance!)
-      CHECK(childrenSize.size
-        < std::numeric_limits<typename ChildrenSizeComponent::SizeType>::max())
-        << "Unable to represent size of childrens in size_t";
-      childrenSize.size++;
-      // size can not be 0
-      // because empty list do not have `ChildrenSizeComponent`
-      DCHECK(childrenSize.size > 0);
+      registry.patch<ChildrenSizeComponent>(
+        parentId
+        , [](ChildrenSizeComponent& childrenSize)
+          {
+            /// \note runtime check (affects performance!)
+            CHECK(childrenSize.size
+              < std::numeric_limits<
+                  typename ChildrenSizeComponent::SizeType>::max())
+              << "Unable to represent size of childrens in size_t";
+            childrenSize.size++;
+            // size can not be 0
+            // because empty list do not have `ChildrenSizeComponent`
+            DCHECK(childrenSize.size > 0);
+          });
     }
 
     // sanity check
     // first child must be marked child as part of linked list
     DCHECK(registry.has<ChildrenComponent>(firstChild->firstId));
 
-    ChildrenComponent& children
-      = registry.get<ChildrenComponent>(firstChild->firstId);
-
-    // sanity check
-    DCHECK(children.prevId == ECS::NULL_ENTITY);
-
     // change first element in list to `childId`
-    children.prevId = childId;
+    registry.patch<ChildrenComponent>(
+      firstChild->firstId
+      , [childId](ChildrenComponent& children)
+        {
+          // sanity check
+          DCHECK(children.prevId == ECS::NULL_ENTITY);
+
+          children.prevId = childId;
+        });
 
     // change first element in list to `childId`
-    firstChild->firstId = childId;
+    registry.patch<FirstChildComponent>(
+      parentId
+      , [childId](FirstChildComponent& firstChildComp)
+        {
+          firstChildComp.firstId = childId;
+        });
   } else {
     // set `childId` as first element in list
     DCHECK(!registry.has<FirstChildComponent>(parentId));
@@ -138,6 +151,9 @@ void prependChildEntity(
 
   DCHECK(hasChildAtTopLevel<TagType>(REFERENCED(registry), parentId, childId));
 
+  DCHECK_CHILD_IN_TOP_LEVEL_LIST(
+    REFERENCED(registry), parentId, childId, true, TagType);
+
 }
 
 } // namespace ECS
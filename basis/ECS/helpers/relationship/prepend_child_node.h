@@ -0,0 +1,91 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/components/relationship/hierarchy_node.h>
+#include <basis/ECS/helpers/relationship/is_child_node_of.h>
+
+#include <base/logging.h>
+
+#include <limits>
+
+namespace ECS {
+
+// Same as `prependChildEntity`, but for fused `HierarchyNode` layout.
+//
+// Adds id of existing entity to linked list (at toplevel depth)
+// as first element.
+//
+/// \note Assumes that `childId` does not have parent
+/// with provided `TagType`
+/// i.e. it can add only new child, not modify existing one
+template <
+  typename TagType // unique type tag for all children
+>
+void prependChildNode(
+  ECS::Registry& registry
+  , ECS::Entity parentId
+  , ECS::Entity childId)
+{
+  using Node = HierarchyNode<TagType>;
+
+  if(parentId == ECS::NULL_ENTITY
+     || childId == ECS::NULL_ENTITY)
+  {
+    return;
+  }
+
+  // sanity check
+  DCHECK(parentId != childId);
+
+  DCHECK_ECS_ENTITY(parentId, &registry);
+
+  DCHECK_ECS_ENTITY(childId, &registry);
+
+  /// \note emplace into pool may invalidate references
+  /// to components of same pool, so emplace both nodes
+  /// before taking references
+  registry.get_or_emplace<Node>(parentId);
+  registry.get_or_emplace<Node>(childId);
+
+  // pool is looked up once for all nodes
+  auto nodes = registry.view<Node>();
+
+  Node& parentNode = nodes.get(parentId);
+
+  Node& childNode = nodes.get(childId);
+
+  CHECK(!childNode.hasParent());
+
+  DCHECK(childNode.prevId == ECS::NULL_ENTITY);
+  DCHECK(childNode.nextId == ECS::NULL_ENTITY);
+
+  if(parentNode.firstChildId != ECS::NULL_ENTITY)
+  {
+    DCHECK_ECS_ENTITY(parentNode.firstChildId, &registry);
+
+    Node& prevFirstNode = nodes.get(parentNode.firstChildId);
+
+    // sanity check
+    DCHECK(prevFirstNode.prevId == ECS::NULL_ENTITY);
+    DCHECK_EQ(prevFirstNode.parentId, parentId);
+
+    prevFirstNode.prevId = childId;
+  }
+
+  childNode.parentId = parentId;
+  // `childId` will become first in list, so no `prev`
+  childNode.prevId = ECS::NULL_ENTITY;
+  childNode.nextId = parentNode.firstChildId;
+
+  /// \note runtime check (affects performance!)
+  CHECK(parentNode.childrenCount
+    < std::numeric_limits<size_t>::max())
+    << "Unable to represent size of childrens in size_t";
+
+  parentNode.firstChildId = childId;
+  parentNode.childrenCount++;
+
+  DCHECK(isChildNodeOf<TagType>(REFERENCED(registry), parentId, childId));
+}
+
+} // namespace ECS
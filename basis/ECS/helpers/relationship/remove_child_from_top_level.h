@@ -29,6 +29,9 @@ namespace ECS {
 // Returns `false` if entity can not be removed.
 //
 // Used to represent hierarchies in ECS model.
+//
+/// \note Existing components are modified using `patch`,
+/// so `on_update` is emitted (see `RegistryDeltaTracker`).
 template <
   typename TagType  // unique type tag for all children
 >
@@ -68,7 +71,7 @@ bool removeChildFromTopLevel(
   // check required components
   DCHECK_PARENT_ENTITY_COMPONENTS(parentId, &registry, TagType);
 
-  FirstChildComponent& firstChild
+  const FirstChildComponent& firstChild
     = registry.get<FirstChildComponent>(parentId);
 
   // sanity check
@@ -90,7 +93,7 @@ bool removeChildFromTopLevel(
   // sanity check
   DCHECK_CHILD_ENTITY_COMPONENTS(childIdToRemove, &registry, TagType);
 
-  ChildrenComponent& childrenCompToRemove
+  const ChildrenComponent& childrenCompToRemove
     = registry.get<ChildrenComponent>(childIdToRemove);
 
   if(!isChildAtTopLevelOf<TagType>(REFERENCED(registry), parentId, childIdToRemove))
@@ -110,15 +113,19 @@ bool removeChildFromTopLevel(
     DCHECK(hasChildAtTopLevel<TagType>(REFERENCED(registry), parentId, childIdToRemove));
 
     // mark as first element in list
-    firstChild.firstId = childrenCompToRemove.nextId;
+    registry.patch<FirstChildComponent>(
+      parentId
+      , [nextId = childrenCompToRemove.nextId](
+          FirstChildComponent& firstChildComp)
+        {
+          firstChildComp.firstId = nextId;
+        });
 
     // no more children related to `parentId`
     if(childrenCompToRemove.nextId == ECS::NULL_ENTITY)
     {
       DCHECK(registry.has<ChildrenSizeComponent>(parentId));
-      ChildrenSizeComponent& childrenSize
-        = registry.get<ChildrenSizeComponent>(parentId);
-      DCHECK_EQ(childrenSize.size, 1UL);
+      DCHECK_EQ(registry.get<ChildrenSizeComponent>(parentId).size, 1UL);
     }
   }
 
@@ -152,12 +159,15 @@ bool removeChildFromTopLevel(
   {
     DCHECK(isRemovedFromListLinks); // child entity found in list
     DCHECK(registry.has<ChildrenSizeComponent>(parentId));
-    ChildrenSizeComponent& childrenSize
-      = registry.get<ChildrenSizeComponent>(parentId);
-    childrenSize.size--;
+    registry.patch<ChildrenSizeComponent>(
+      parentId
+      , [](ChildrenSizeComponent& childrenSize)
+        {
+          childrenSize.size--;
+        });
     // size can not be 0
     // because empty list do not have `ChildrenSizeComponent`
-    if(childrenSize.size <= 0)
+    if(registry.get<ChildrenSizeComponent>(parentId).size <= 0)
     {
       // remove all components associated with `parent`
       removeParentComponents<TagType>(
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/components/relationship/hierarchy_node.h>
+#include <basis/ECS/helpers/relationship/is_child_node_of.h>
+
+#include <base/logging.h>
+
+#include <basic/macros.h>
+
+namespace ECS {
+
+/// \note does not iterate hierarchy recursively
+/// i.e. does not iterate children of children of children...
+//
+// Same as `removeChildFromTopLevel`, but for fused `HierarchyNode` layout
+// i.e. O(1) and touches only one pool.
+//
+// `HierarchyNode` is removed from parent or child entity
+// if it is neither parent nor child anymore.
+//
+// Returns `false` if `childIdToRemove` is not child of `parentId`.
+template <
+  typename TagType  // unique type tag for all children
+>
+MUST_USE_RETURN_VALUE
+bool removeChildNode(
+  ECS::Registry& registry
+  , ECS::Entity parentId
+  , ECS::Entity childIdToRemove)
+{
+  using Node = HierarchyNode<TagType>;
+
+  if(childIdToRemove == ECS::NULL_ENTITY
+     || parentId == ECS::NULL_ENTITY)
+  {
+    return false;
+  }
+
+  DCHECK_ECS_ENTITY(childIdToRemove, &registry);
+
+  DCHECK_ECS_ENTITY(parentId, &registry);
+
+  DCHECK(parentId != childIdToRemove);
+
+  // pool is looked up once for all nodes
+  auto nodes = registry.view<Node>();
+
+  if(!nodes.contains(childIdToRemove))
+  {
+    return false;
+  }
+
+  Node& childNode = nodes.get(childIdToRemove);
+
+  if(childNode.parentId != parentId)
+  {
+    // `childIdToRemove` not found i.e. nothing to do
+    return false;
+  }
+
+  DCHECK(nodes.contains(parentId));
+  Node& parentNode = nodes.get(parentId);
+
+  // update `prev` and `next` links
+  if(childNode.prevId != ECS::NULL_ENTITY)
+  {
+    DCHECK_ECS_ENTITY(childNode.prevId, &registry);
+    nodes.get(childNode.prevId).nextId = childNode.nextId;
+  }
+  else
+  {
+    DCHECK_EQ(parentNode.firstChildId, childIdToRemove);
+    parentNode.firstChildId = childNode.nextId;
+  }
+
+  if(childNode.nextId != ECS::NULL_ENTITY)
+  {
+    DCHECK_ECS_ENTITY(childNode.nextId, &registry);
+    nodes.get(childNode.nextId).prevId = childNode.prevId;
+  }
+
+  DCHECK_GT(parentNode.childrenCount, 0u);
+  parentNode.childrenCount--;
+  DCHECK(parentNode.hasChildren()
+    || parentNode.firstChildId == ECS::NULL_ENTITY);
+
+  childNode.parentId = ECS::NULL_ENTITY;
+  childNode.prevId = ECS::NULL_ENTITY;
+  childNode.nextId = ECS::NULL_ENTITY;
+
+  /// \note remove from pool invalidates references
+  /// to components of same pool, so decide before removal
+  const bool isParentUnused
+    = !parentNode.hasParent() && !parentNode.hasChildren();
+  const bool isChildUnused
+    = !childNode.hasChildren();
+
+  if(isChildUnused)
+  {
+    registry.remove<Node>(childIdToRemove);
+  }
+
+  if(isParentUnused)
+  {
+    registry.remove<Node>(parentId);
+  }
+
+  // child was removed from parent
+  DCHECK(!isChildNodeOf<TagType>(REFERENCED(registry), parentId, childIdToRemove));
+
+  return true;
+}
+
+} // namespace ECS
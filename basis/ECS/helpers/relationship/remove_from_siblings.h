@@ -21,6 +21,8 @@ namespace ECS {
 /// \note does not remove `ParentEntity` component from child
 /// \note does not remove child from parent components
 /// (for example, does not update children count in parent)
+/// \note links of siblings are modified using `patch`,
+/// so `on_update` is emitted (see `RegistryDeltaTracker`).
 template <
   typename TagType // unique type tag for all children
 >
@@ -50,12 +52,12 @@ bool removeFromSiblings(
   {
     DCHECK_CHILD_ENTITY_COMPONENTS(curr, &registry, TagType);
 
-    ChildrenComponent& currChildrenComp
+    const ChildrenComponent& currChildrenComp
       = registry.get<ChildrenComponent>(curr);
 
-    ECS::Entity& currPrevId = currChildrenComp.prevId;
+    const ECS::Entity currPrevId = currChildrenComp.prevId;
 
-    ECS::Entity& currNextId = currChildrenComp.nextId;
+    const ECS::Entity currNextId = currChildrenComp.nextId;
 
     // found element to remove
     if(childIdToRemove == curr)
@@ -71,10 +73,12 @@ bool removeFromSiblings(
         DCHECK_EQ(registry.get<ParentComponent>(currPrevId).parentId
           , registry.get<ParentComponent>(curr).parentId);
 
-        ChildrenComponent& prevChildrenComp
-          = registry.get<ChildrenComponent>(currPrevId);
-
-        prevChildrenComp.nextId = currNextId;
+        registry.patch<ChildrenComponent>(
+          currPrevId
+          , [currNextId](ChildrenComponent& prevChildrenComp)
+            {
+              prevChildrenComp.nextId = currNextId;
+            });
       }
 
       // next element must not point to removed element
@@ -88,10 +92,12 @@ bool removeFromSiblings(
         DCHECK_EQ(registry.get<ParentComponent>(currNextId).parentId
           , registry.get<ParentComponent>(curr).parentId);
 
-        ChildrenComponent& nextChildrenComp
-          = registry.get<ChildrenComponent>(currNextId);
-
-        nextChildrenComp.prevId = currPrevId;
+        registry.patch<ChildrenComponent>(
+          currNextId
+          , [currPrevId](ChildrenComponent& nextChildrenComp)
+            {
+              nextChildrenComp.prevId = currPrevId;
+            });
       }
 
       return true;
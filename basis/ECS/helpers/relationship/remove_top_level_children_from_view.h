@@ -1,6 +1,7 @@
 #pragma once
 
 #include <basis/ECS/ecs.h>
+#include <basis/ECS/group_presets.h>
 #include <basis/ECS/components/relationship/child_siblings.h>
 #include <basis/ECS/components/relationship/first_child_in_linked_list.h>
 #include <basis/ECS/components/relationship/parent_entity.h>
@@ -60,6 +61,14 @@ void removeTopLevelChildrenFromView(
   /// \note we assume that size of all children can be stored in `size_t`
   using ChildrenSizeComponent = TopLevelChildrenCount<TagType, size_t>;
 
+  // components are removed during iteration of `targetView`
+  DCHECK_NOT_OWNED_BY_GROUP(registry
+    , ParentComponent
+    , FirstChildComponent
+    , ChildrenSizeComponent
+    , ChildSiblings<TagType>
+    , Internal_ChildrenToRemove);
+
   auto targetView
     = registry.view<
         FirstChildComponent
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/components/relationship/child_siblings.h>
+#include <basis/ECS/components/relationship/first_child_in_linked_list.h>
+#include <basis/ECS/components/relationship/parent_entity.h>
+#include <basis/ECS/components/relationship/top_level_children_count.h>
+
+#include <base/logging.h>
+#include <base/macros.h>
+
+#include <basic/macros.h>
+
+#include <cstddef>
+
+namespace ECS {
+
+// Checks that hierarchy (with unique type tag `TagType`) is consistent:
+// * each `ParentEntity` points to valid entity with children list
+// * each `ChildSiblings` link points to valid entity
+//   that links back (`next.prevId == self` and `prev.nextId == self`)
+// * each children list (starting from `FirstChildInLinkedList`)
+//   contains only children of that parent
+//   and its length is equal to `TopLevelChildrenCount`
+//
+/// \note iterates all entities in hierarchy,
+/// so use it only after bulk modifications
+/// (for example, after restoring registry from snapshot).
+//
+// USAGE
+//
+// CHECK(ECS::validateRelationships<TagType>(registry));
+//
+template <
+  typename TagType // unique type tag for all children
+>
+MUST_USE_RETURN_VALUE
+bool validateRelationships(
+  const ECS::Registry& registry)
+{
+  using FirstChildComponent = ECS::FirstChildInLinkedList<TagType>;
+  using ChildrenComponent = ECS::ChildSiblings<TagType>;
+  /// \note we assume that size of all children can be stored in `size_t`
+  using ChildrenSizeComponent = ECS::TopLevelChildrenCount<TagType, size_t>;
+  using ParentComponent = ECS::ParentEntity<TagType>;
+
+  const auto isValidLink
+    = [&registry](ECS::Entity entityId)
+      {
+        return entityId == ECS::NULL_ENTITY
+          || (registry.valid(entityId)
+              && registry.has<ChildrenComponent>(entityId));
+      };
+
+  bool result = true;
+
+  registry.view<const ParentComponent>().each(
+    [&](const ECS::Entity childId, const ParentComponent& parentComp)
+    {
+      if(parentComp.parentId == ECS::NULL_ENTITY
+         || !registry.valid(parentComp.parentId)
+         || !registry.has<FirstChildComponent>(parentComp.parentId)
+         || !registry.has<ChildrenComponent>(childId))
+      {
+        DVLOG(9)
+          << "invalid parent of entity: "
+          << childId;
+        result = false;
+      }
+    });
+
+  registry.view<const ChildrenComponent>().each(
+    [&](const ECS::Entity childId, const ChildrenComponent& siblings)
+    {
+      if(!registry.has<ParentComponent>(childId)
+         || !isValidLink(siblings.prevId)
+         || !isValidLink(siblings.nextId))
+      {
+        DVLOG(9)
+          << "invalid siblings of entity: "
+          << childId;
+        result = false;
+        return;
+      }
+
+      if((siblings.nextId != ECS::NULL_ENTITY
+          && registry.get<ChildrenComponent>(siblings.nextId).prevId != childId)
+         || (siblings.prevId != ECS::NULL_ENTITY
+          && registry.get<ChildrenComponent>(siblings.prevId).nextId != childId))
+      {
+        DVLOG(9)
+          << "broken back link of entity: "
+          << childId;
+        result = false;
+      }
+    });
+
+  // Stop here because iteration of broken linked list may not terminate.
+  if(!result)
+  {
+    return false;
+  }
+
+  registry.view<const FirstChildComponent>().each(
+    [&](const ECS::Entity parentId, const FirstChildComponent& firstChild)
+    {
+      if(!registry.has<ChildrenSizeComponent>(parentId)
+         || !isValidLink(firstChild.firstId)
+         || firstChild.firstId == ECS::NULL_ENTITY)
+      {
+        DVLOG(9)
+          << "invalid children list of entity: "
+          << parentId;
+        result = false;
+        return;
+      }
+
+      const size_t expectedSize
+        = registry.get<ChildrenSizeComponent>(parentId).size;
+
+      size_t size = 0;
+
+      ECS::Entity curr = firstChild.firstId;
+
+      // `size <= expectedSize` guards against cycles
+      while(curr != ECS::NULL_ENTITY && size <= expectedSize)
+      {
+        if(registry.get<ParentComponent>(curr).parentId != parentId)
+        {
+          DVLOG(9)
+            << "entity: "
+            << curr
+            << " is not child of entity: "
+            << parentId;
+          result = false;
+          return;
+        }
+
+        ++size;
+
+        curr = registry.get<ChildrenComponent>(curr).nextId;
+      }
+
+      if(size != expectedSize)
+      {
+        DVLOG(9)
+          << "wrong children count of entity: "
+          << parentId;
+        result = false;
+      }
+    });
+
+  return result;
+}
+
+} // namespace ECS
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include <basis/ECS/ecs.h>
+#include <basis/ECS/group_presets.h>
 #include <basis/ECS/components/relationship/child_siblings.h>
 #include <basis/ECS/components/relationship/top_level_children_count.h>
 #include <basis/ECS/components/relationship/first_child_in_linked_list.h>
@@ -33,6 +34,9 @@ public:
   {
     DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
+    // tags are removed during iteration of view
+    DCHECK_NOT_OWNED_BY_GROUP(registry_, TagType);
+
     for(const ECS::Entity& childId:
       registry_.template view<TagType>())
     {
@@ -0,0 +1,83 @@
+#include "basis/ECS/registry_compactor.h" // IWYU pragma: associated
+
+#include <base/trace_event/trace_event.h>
+
+#include <algorithm>
+
+namespace ECS {
+
+RegistryCompactor::~RegistryCompactor()
+{
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+void RegistryCompactor::start()
+{
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  nextPool_ = 0;
+  results_.clear();
+  results_.reserve(pools_.size());
+}
+
+bool RegistryCompactor::isRunning() const
+{
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  return nextPool_ < pools_.size();
+}
+
+bool RegistryCompactor::step(ECS::Registry& registry, size_t maxPools)
+{
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  TRACE_EVENT0("headless", "RegistryCompactor::step");
+
+  DCHECK_GT(maxPools, 0u);
+
+  const size_t endPool
+    = std::min(pools_.size(), nextPool_ + maxPools);
+
+  for(; nextPool_ < endPool; ++nextPool_)
+  {
+    results_.push_back(
+      pools_[nextPool_].compact(REFERENCED(registry), headroom_));
+
+    const PoolCompactionResult& result = results_.back();
+
+    DVLOG(1)
+      << "compacted pool "
+      << result.name
+      << " size: "
+      << result.size
+      << " capacity: "
+      << result.capacityBefore
+      << " -> "
+      << result.capacityAfter
+      << " reclaimed bytes: "
+      << result.bytesReclaimed;
+  }
+
+  return !isRunning();
+}
+
+const std::vector<PoolCompactionResult>& RegistryCompactor::results() const
+{
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  return results_;
+}
+
+size_t RegistryCompactor::totalBytesReclaimed() const
+{
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  size_t total = 0;
+  for(const PoolCompactionResult& result: results_)
+  {
+    total += result.bytesReclaimed;
+  }
+  return total;
+}
+
+} // namespace ECS
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+
+#include <base/logging.h>
+#include <base/macros.h>
+#include <base/sequence_checker.h>
+
+#include <basic/macros.h>
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ECS {
+
+// Result of compaction of single pool.
+struct PoolCompactionResult
+{
+  ENTT_ID_TYPE typeId = 0;
+
+  std::string name;
+
+  size_t size = 0;
+
+  size_t capacityBefore = 0;
+
+  size_t capacityAfter = 0;
+
+  // Approximate (packed array of entities and components),
+  // does not include sparse array.
+  size_t bytesReclaimed = 0;
+};
+
+// Shrinks pools of `ECS::Registry` after churn spikes
+// (entt pools keep their peak capacity forever).
+//
+// Capacity of each tracked pool is reduced to `size * (1 + headroom)`,
+// so pool will not reallocate again on small fluctuations of load.
+//
+// Runs incrementally: each `step` compacts at most `maxPools` pools,
+// so work can be spread over several ticks.
+//
+/// \note entity identifiers are NOT compacted:
+/// identifiers are stored in components (like `ParentEntity`)
+/// and outside of registry, and entt keeps released identifiers
+/// for recycling, so renumbering would break references.
+//
+// USAGE
+//
+//  ECS::RegistryCompactor compactor_{
+//    ECS::RegistryCompactor::Tracked<TcpConnection, Buffers>{}
+//    , /* headroom */ 0.25};
+//
+//  // on sequence of `ECS::SafeRegistry` when load is low
+//  compactor_.start();
+//
+//  // once per tick
+//  if(compactor_.isRunning()
+//     && compactor_.step(REFERENCED(*safeRegistry), 1))
+//  {
+//    LOG(INFO) << "reclaimed " << compactor_.totalBytesReclaimed();
+//  }
+class RegistryCompactor
+{
+ public:
+  template <typename... Components>
+  struct Tracked {};
+
+  template <typename... Components>
+  explicit RegistryCompactor(
+    Tracked<Components...>
+    , double headroom = 0.25)
+    : headroom_(headroom)
+    , pools_{Pool{&compactPool<Components>}...}
+    , nextPool_(pools_.size())
+  {
+    DCHECK_GE(headroom_, 0.0);
+  }
+
+  ~RegistryCompactor();
+
+  // Starts new pass over all tracked pools
+  // (resets results of previous pass).
+  void start();
+
+  MUST_USE_RETURN_VALUE
+  bool isRunning() const;
+
+  // Compacts at most `maxPools` pools.
+  // Returns `true` if pass is complete.
+  MUST_USE_RETURN_VALUE
+  bool step(ECS::Registry& registry, size_t maxPools);
+
+  // Results of current (or last finished) pass.
+  const std::vector<PoolCompactionResult>& results() const;
+
+  size_t totalBytesReclaimed() const;
+
+ private:
+  using CompactPoolFn
+    = PoolCompactionResult (*)(ECS::Registry&, double headroom);
+
+  struct Pool
+  {
+    CompactPoolFn compact;
+  };
+
+  template <typename Component>
+  static PoolCompactionResult compactPool(
+    ECS::Registry& registry
+    , double headroom)
+  {
+    // tags do not store instances
+    constexpr size_t kBytesPerElement
+      = sizeof(ECS::Entity)
+        + (std::is_empty_v<Component> ? 0 : sizeof(Component));
+
+    PoolCompactionResult result;
+    result.typeId = entt::type_info<Component>::id();
+    result.name = componentTypeName<Component>();
+    result.size = registry.size<Component>();
+    result.capacityBefore = registry.capacity<Component>();
+
+    const size_t targetCapacity
+      = result.size
+        + static_cast<size_t>(result.size * headroom);
+
+    if(result.capacityBefore > targetCapacity)
+    {
+      registry.shrink_to_fit<Component>();
+
+      if(targetCapacity > registry.capacity<Component>())
+      {
+        registry.reserve<Component>(targetCapacity);
+      }
+    }
+
+    result.capacityAfter = registry.capacity<Component>();
+
+    result.bytesReclaimed
+      = result.capacityBefore > result.capacityAfter
+        ? (result.capacityBefore - result.capacityAfter) * kBytesPerElement
+        : 0;
+
+    return result;
+  }
+
+ private:
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  const double headroom_;
+
+  const std::vector<Pool> pools_;
+
+  // Index of next pool to compact.
+  // Equal to `pools_.size()` if not running.
+  size_t nextPool_;
+
+  std::vector<PoolCompactionResult> results_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegistryCompactor);
+};
+
+} // namespace ECS
@@ -0,0 +1,69 @@
+#include "basis/ECS/registry_compactor.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <vector>
+
+namespace ECS {
+namespace {
+
+struct Payload {
+  char data[64];
+};
+
+struct Marker {};
+
+TEST(RegistryCompactorTest, ShrinksPoolsIncrementally) {
+  ECS::Registry registry;
+
+  // churn spike
+  std::vector<ECS::Entity> entities(1000);
+  registry.create(entities.begin(), entities.end());
+  for (const ECS::Entity& entityId : entities) {
+    registry.emplace<Payload>(entityId);
+    registry.emplace<Marker>(entityId);
+  }
+  registry.destroy(entities.begin() + 100, entities.end());
+  ASSERT_EQ(100u, registry.size<Payload>());
+  ASSERT_GE(registry.capacity<Payload>(), 1000u);
+
+  RegistryCompactor compactor(RegistryCompactor::Tracked<Payload, Marker>{},
+                              /* headroom */ 0.5);
+  EXPECT_FALSE(compactor.isRunning());
+
+  compactor.start();
+  EXPECT_TRUE(compactor.isRunning());
+
+  // one pool per tick
+  EXPECT_FALSE(compactor.step(registry, 1));
+  ASSERT_EQ(1u, compactor.results().size());
+  EXPECT_TRUE(compactor.step(registry, 1));
+  EXPECT_FALSE(compactor.isRunning());
+  ASSERT_EQ(2u, compactor.results().size());
+
+  const PoolCompactionResult& payload = compactor.results()[0];
+  EXPECT_EQ(entt::type_info<Payload>::id(), payload.typeId);
+  EXPECT_FALSE(payload.name.empty());
+  EXPECT_EQ(150u, payload.capacityAfter);
+  EXPECT_EQ(150u, registry.capacity<Payload>());
+  EXPECT_EQ((payload.capacityBefore - 150u)
+                * (sizeof(ECS::Entity) + sizeof(Payload)),
+            payload.bytesReclaimed);
+
+  // tag pool stores only entities
+  const PoolCompactionResult& marker = compactor.results()[1];
+  EXPECT_EQ((marker.capacityBefore - marker.capacityAfter)
+                * sizeof(ECS::Entity),
+            marker.bytesReclaimed);
+
+  EXPECT_EQ(payload.bytesReclaimed + marker.bytesReclaimed,
+            compactor.totalBytesReclaimed());
+
+  // nothing to reclaim on second pass
+  compactor.start();
+  EXPECT_TRUE(compactor.step(registry, 2));
+  EXPECT_EQ(0u, compactor.totalBytesReclaimed());
+}
+
+}  // namespace
+}  // namespace ECS
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/safe_registry.h>
+#include <basis/memory/scoped_memory_dump_provider.h>
+
+#include <base/bind.h>
+#include <base/logging.h>
+
+#include <basic/macros.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace base {
+namespace trace_event {
+class ProcessMemoryDump;
+} // namespace trace_event
+} // namespace base
+
+namespace ECS {
+
+namespace registry_memory_dump_internal {
+
+// Name of allocator dump for pool of `Component`.
+/// \note uses `componentTypeName` (not `setOrFindTypeMeta`),
+/// because dumps are created on sequences of different registries
+/// and `setOrFindTypeMeta` modifies map that is not synchronized.
+template <typename Component>
+std::string poolDumpName(const std::string& dumpName)
+{
+  std::string typeName = componentTypeName<Component>();
+
+  // `/` separates levels of hierarchy in memory-infra
+  std::replace(typeName.begin(), typeName.end(), '/', '_');
+
+  return dumpName + "/" + typeName;
+}
+
+template <typename Component>
+void dumpPool(
+  const ECS::Registry& registry
+  , const std::string& dumpName
+  , ::base::trace_event::ProcessMemoryDump* pmd)
+{
+  // tags do not store instances
+  constexpr size_t kBytesPerElement
+    = sizeof(ECS::Entity)
+      + (std::is_empty_v<Component> ? 0 : sizeof(Component));
+
+  ::basis::addAllocatorDump(pmd
+    , poolDumpName<Component>(dumpName)
+    , registry.capacity<Component>() * kBytesPerElement
+    , registry.size<Component>());
+}
+
+} // namespace registry_memory_dump_internal
+
+// Adds allocator dumps to `pmd`:
+// * `<dumpName>/entities` - storage of entity identifiers
+// * `<dumpName>/<component type name>` - pool of each of `Components`
+//   (capacity in bytes and number of stored components)
+//
+/// \note entt pools are type-erased at run time,
+/// so only listed `Components` are reported.
+/// \note does not include sparse arrays of pools
+/// and heap memory owned by components.
+template <typename... Components>
+void dumpRegistryMemoryStats(
+  const ECS::Registry& registry
+  , const std::string& dumpName
+  , ::base::trace_event::ProcessMemoryDump* pmd
+  , ECS::include_t<Components...> = {})
+{
+  ::basis::addAllocatorDump(pmd
+    , dumpName + "/entities"
+    , registry.capacity() * sizeof(ECS::Entity)
+    , registry.alive());
+
+  (registry_memory_dump_internal::dumpPool<Components>(
+     registry, dumpName, pmd), ...);
+}
+
+// Registers memory dump provider that runs on sequence of `registry`
+// (see `dumpRegistryMemoryStats`).
+//
+/// \note `registry` must outlive provider,
+/// destroy provider on sequence of `registry`.
+/// \note `name` must be string literal.
+//
+// USAGE
+//
+//  registryDumpProvider_
+//    = ECS::createRegistryMemoryDumpProvider(
+//        REFERENCED(registry_)
+//        , "NetworkRegistry"
+//        , "basis/ecs/network"
+//        , ECS::include<TcpConnection, Buffers>);
+template <typename... Components>
+MUST_USE_RETURN_VALUE
+std::unique_ptr<::basis::ScopedMemoryDumpProvider>
+  createRegistryMemoryDumpProvider(
+    ECS::SafeRegistry& registry
+    , const char* name
+    , const std::string& dumpName
+    , ECS::include_t<Components...> = {})
+{
+  return std::make_unique<::basis::ScopedMemoryDumpProvider>(
+    name
+    , registry.taskRunner()
+    , ::base::BindRepeating(
+        [](
+          ECS::SafeRegistry* registry
+          , const std::string& dumpName
+          , ::base::trace_event::ProcessMemoryDump* pmd
+        ){
+          DCHECK_RUN_ON_REGISTRY(registry);
+
+          dumpRegistryMemoryStats<Components...>(
+            registry->registry()
+            , dumpName
+            , pmd);
+        }
+        , ::base::Unretained(&registry)
+        , dumpName));
+}
+
+} // namespace ECS
@@ -0,0 +1,72 @@
+#include "basis/ECS/registry_memory_dump.h"
+
+#include "base/trace_event/memory_allocator_dump.h"
+#include "base/trace_event/memory_dump_request_args.h"
+#include "base/trace_event/process_memory_dump.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <string>
+
+namespace ECS {
+namespace {
+
+struct DumpPayload {
+  char data[32];
+};
+
+struct DumpMarker {};
+
+uint64_t scalarOf(const base::trace_event::MemoryAllocatorDump* dump,
+                  const std::string& name) {
+  for (const auto& entry : dump->entries()) {
+    if (entry.name == name) {
+      return entry.value_uint64;
+    }
+  }
+  ADD_FAILURE() << "no scalar " << name;
+  return 0;
+}
+
+TEST(RegistryMemoryDumpTest, DumpsPoolsAndEntities) {
+  ECS::Registry registry;
+  for (int i = 0; i < 10; ++i) {
+    const ECS::Entity entityId = registry.create();
+    registry.emplace<DumpPayload>(entityId);
+    if (i % 2) {
+      registry.emplace<DumpMarker>(entityId);
+    }
+  }
+
+  base::trace_event::MemoryDumpArgs args = {
+      base::trace_event::MemoryDumpLevelOfDetail::DETAILED};
+  base::trace_event::ProcessMemoryDump pmd(args);
+
+  dumpRegistryMemoryStats(registry, "basis/ecs/test", &pmd,
+                          ECS::include<DumpPayload, DumpMarker>);
+
+  const base::trace_event::MemoryAllocatorDump* entities =
+      pmd.GetAllocatorDump("basis/ecs/test/entities");
+  ASSERT_TRUE(entities);
+  EXPECT_EQ(10u, scalarOf(entities, "object_count"));
+
+  const base::trace_event::MemoryAllocatorDump* payload =
+      pmd.GetAllocatorDump(
+          registry_memory_dump_internal::poolDumpName<DumpPayload>(
+              "basis/ecs/test"));
+  ASSERT_TRUE(payload);
+  EXPECT_EQ(10u, scalarOf(payload, "object_count"));
+  EXPECT_EQ(registry.capacity<DumpPayload>()
+                * (sizeof(ECS::Entity) + sizeof(DumpPayload)),
+            scalarOf(payload, "size"));
+
+  const base::trace_event::MemoryAllocatorDump* marker =
+      pmd.GetAllocatorDump(
+          registry_memory_dump_internal::poolDumpName<DumpMarker>(
+              "basis/ecs/test"));
+  ASSERT_TRUE(marker);
+  EXPECT_EQ(5u, scalarOf(marker, "object_count"));
+}
+
+}  // namespace
+}  // namespace ECS
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "basis/ECS/ecs.h"
+#include "basis/ECS/group_presets.h"
 
 #include "basic/memory/unowned_ptr.h" // IWYU pragma: keep
 #include "basic/annotations/guard_annotations.h" // IWYU pragma: keep
@@ -45,6 +46,21 @@ class LOCKABLE SafeRegistry {
 public:
   SafeRegistry();
 
+  // Creates owning groups before any component is emplaced,
+  // so pools are never rearranged to satisfy group.
+  //
+  // USAGE
+  //
+  // ECS::SafeRegistry registry{ECS::GroupPresets<MovementGroup, RenderGroup>{}};
+  template<typename... Presets>
+  explicit SafeRegistry(ECS::GroupPresets<Presets...> presets)
+    : SafeRegistry()
+  {
+    /// \note registry is not accessible from other sequences
+    /// during construction
+    presets.registerIn(registry_);
+  }
+
   ~SafeRegistry();
 
   using TaskRunnerType
@@ -0,0 +1,204 @@
+#include "basis/ECS/snapshot/registry_delta.h" // IWYU pragma: associated
+
+#include <base/pickle.h>
+
+#include <cstring>
+#include <limits>
+
+namespace ECS {
+
+namespace {
+
+// "BECD" in little-endian
+constexpr uint32_t kDeltaMagic = 0x44434542;
+
+constexpr uint32_t kDeltaVersion = 1;
+
+// Limits size of column, so size in bytes fits into `int` used by `base::Pickle`.
+constexpr uint32_t kMaxColumnBytes
+  = static_cast<uint32_t>(std::numeric_limits<int>::max());
+
+void writeColumn(
+  ::base::Pickle& pickle
+  , const std::vector<SnapshotEntityValue>& column)
+{
+  const size_t size = column.size() * sizeof(SnapshotEntityValue);
+  CHECK_LE(size, kMaxColumnBytes);
+  pickle.WriteUInt32(static_cast<uint32_t>(column.size()));
+  pickle.WriteBytes(column.data(), static_cast<int>(size));
+}
+
+bool readColumn(
+  ::base::PickleIterator& iter
+  , std::vector<SnapshotEntityValue>& column)
+{
+  uint32_t count = 0;
+  if(!iter.ReadUInt32(&count)
+     || count > kMaxColumnBytes / sizeof(SnapshotEntityValue))
+  {
+    return false;
+  }
+
+  const int size = static_cast<int>(count * sizeof(SnapshotEntityValue));
+  const char* data = nullptr;
+  if(!iter.ReadBytes(&data, size))
+  {
+    return false;
+  }
+
+  column.resize(count);
+  if(size > 0)
+  {
+    std::memcpy(column.data(), data, size);
+  }
+  return true;
+}
+
+} // namespace
+
+namespace registry_delta_internal {
+
+bool ensureEntity(ECS::Registry& registry, SnapshotEntityValue value)
+{
+  const ECS::Entity entityId{value};
+
+  if(registry.valid(entityId))
+  {
+    return true;
+  }
+
+  // Uses `entityId` as hint, so identifier and version are preserved
+  // unless identifier is used by another (outdated) entity.
+  return registry.create(entityId) == entityId;
+}
+
+} // namespace registry_delta_internal
+
+RegistryDelta::RegistryDelta() = default;
+
+RegistryDelta::RegistryDelta(RegistryDelta&& other) = default;
+
+RegistryDelta& RegistryDelta::operator=(RegistryDelta&& other) = default;
+
+RegistryDelta::~RegistryDelta() = default;
+
+bool RegistryDelta::empty() const
+{
+  return destroyed.empty() && components.empty();
+}
+
+const RegistryDelta::ComponentChanges* RegistryDelta::findComponentChanges(
+  uint64_t typeId) const
+{
+  for(const ComponentChanges& changes: components)
+  {
+    if(changes.typeId == typeId)
+    {
+      return &changes;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<uint8_t> RegistryDelta::serialize() const
+{
+  ::base::Pickle pickle;
+
+  pickle.WriteUInt32(kDeltaMagic);
+  pickle.WriteUInt32(kDeltaVersion);
+  pickle.WriteUInt32(sizeof(SnapshotEntityValue));
+  pickle.WriteUInt64(sequenceNumber);
+
+  writeColumn(pickle, destroyed);
+
+  pickle.WriteUInt32(static_cast<uint32_t>(components.size()));
+  for(const ComponentChanges& changes: components)
+  {
+    DCHECK_EQ(changes.data.size()
+      , static_cast<size_t>(changes.elementSize) * changes.upserted.size());
+    CHECK_LE(changes.data.size(), kMaxColumnBytes);
+
+    pickle.WriteUInt64(changes.typeId);
+    pickle.WriteUInt32(changes.elementSize);
+    writeColumn(pickle, changes.upserted);
+    pickle.WriteBytes(changes.data.data()
+      , static_cast<int>(changes.data.size()));
+    writeColumn(pickle, changes.removed);
+  }
+
+  const uint8_t* data = static_cast<const uint8_t*>(pickle.data());
+  return std::vector<uint8_t>(data, data + pickle.size());
+}
+
+// static
+::base::Optional<RegistryDelta> RegistryDelta::deserialize(
+  const uint8_t* data
+  , size_t size)
+{
+  if(!data || size > kMaxColumnBytes)
+  {
+    return ::base::nullopt;
+  }
+
+  const ::base::Pickle pickle(
+    reinterpret_cast<const char*>(data), static_cast<int>(size));
+  ::base::PickleIterator iter(pickle);
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t entityValueSize = 0;
+  RegistryDelta delta;
+
+  if(!iter.ReadUInt32(&magic)
+     || magic != kDeltaMagic
+     || !iter.ReadUInt32(&version)
+     || version != kDeltaVersion
+     || !iter.ReadUInt32(&entityValueSize)
+     || entityValueSize != sizeof(SnapshotEntityValue)
+     || !iter.ReadUInt64(&delta.sequenceNumber)
+     || !readColumn(iter, delta.destroyed))
+  {
+    return ::base::nullopt;
+  }
+
+  uint32_t componentCount = 0;
+  if(!iter.ReadUInt32(&componentCount))
+  {
+    return ::base::nullopt;
+  }
+
+  for(uint32_t i = 0; i < componentCount; ++i)
+  {
+    ComponentChanges changes;
+
+    if(!iter.ReadUInt64(&changes.typeId)
+       || !iter.ReadUInt32(&changes.elementSize)
+       || !readColumn(iter, changes.upserted))
+    {
+      return ::base::nullopt;
+    }
+
+    const uint64_t dataSize
+      = static_cast<uint64_t>(changes.elementSize) * changes.upserted.size();
+    const char* rows = nullptr;
+    if(dataSize > kMaxColumnBytes
+       || !iter.ReadBytes(&rows, static_cast<int>(dataSize)))
+    {
+      return ::base::nullopt;
+    }
+    changes.data.assign(
+      reinterpret_cast<const uint8_t*>(rows)
+      , reinterpret_cast<const uint8_t*>(rows) + dataSize);
+
+    if(!readColumn(iter, changes.removed))
+    {
+      return ::base::nullopt;
+    }
+
+    delta.components.push_back(RVALUE_CAST(changes));
+  }
+
+  return ::base::Optional<RegistryDelta>(RVALUE_CAST(delta));
+}
+
+} // namespace ECS
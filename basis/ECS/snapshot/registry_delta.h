@@ -0,0 +1,400 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/snapshot/registry_snapshot.h>
+
+#include <base/logging.h>
+#include <base/macros.h>
+#include <base/optional.h>
+#include <base/sequence_checker.h>
+
+#include <basic/macros.h>
+#include <basic/rvalue_cast.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace ECS {
+
+// Changes of registry made since previous delta
+// (see `RegistryDeltaTracker`).
+//
+// Stores current values of changed components (not history of changes),
+// so size of delta is proportional to number of changed components,
+// not to number of changes or size of registry.
+//
+// Rows use same encoding as `RegistrySnapshot` (see `SnapshotCodec`).
+class RegistryDelta
+{
+ public:
+  struct ComponentChanges
+  {
+    // `TypeMetaRegistrator<Component>::id()`
+    uint64_t typeId = 0;
+
+    // Size of one row in `data`, zero for empty types (tags).
+    uint32_t elementSize = 0;
+
+    // Entities that got component or changed value of component.
+    std::vector<SnapshotEntityValue> upserted;
+
+    // Values of component, one row per entity in `upserted`.
+    std::vector<uint8_t> data;
+
+    // Alive entities that lost component.
+    std::vector<SnapshotEntityValue> removed;
+  };
+
+  RegistryDelta();
+
+  RegistryDelta(RegistryDelta&& other);
+
+  RegistryDelta& operator=(RegistryDelta&& other);
+
+  ~RegistryDelta();
+
+  MUST_USE_RETURN_VALUE
+  bool empty() const;
+
+  // Returns `nullptr` if there are no changes of component.
+  MUST_USE_RETURN_VALUE
+  const ComponentChanges* findComponentChanges(uint64_t typeId) const;
+
+  // Compact binary representation (see `base::Pickle`)
+  // that can be sent to replica or written to `RegistryDeltaLog`.
+  MUST_USE_RETURN_VALUE
+  std::vector<uint8_t> serialize() const;
+
+  // Returns `base::nullopt` if data is corrupted.
+  MUST_USE_RETURN_VALUE
+  static ::base::Optional<RegistryDelta> deserialize(
+    const uint8_t* data
+    , size_t size);
+
+ public:
+  // Incremented by tracker on each delta,
+  // allows replica to detect lost deltas.
+  uint64_t sequenceNumber = 0;
+
+  // Entities destroyed since previous delta.
+  /// \note Destroyed entities are applied before component changes,
+  /// so entity may be destroyed and created again (with new version)
+  /// in same delta.
+  std::vector<SnapshotEntityValue> destroyed;
+
+  std::vector<ComponentChanges> components;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(RegistryDelta);
+};
+
+// Tracks changes of `Components` using entt signals
+// (`on_construct`, `on_update`, `on_destroy`)
+// and collects them into `RegistryDelta`.
+//
+// Only set of dirty entities is stored per component
+// (values are read from registry in `takeDelta`),
+// so tracking adds one `push_back` per signal.
+//
+/// \note `on_update` is emitted only by `patch`, `replace`
+/// and `emplace_or_replace`. If component was modified
+/// using reference returned by `get`, then call `markDirty`.
+/// Relationship helpers (`prependChildEntity`, `removeChildFromTopLevel`)
+/// modify components using `patch`, so they need no `markDirty`.
+/// \note Entities without tracked components are not created on replica
+/// until they get tracked component.
+//
+// USAGE
+//
+//  ECS::RegistryDeltaTracker<Position, ECS::ParentEntity<TagType>> tracker(
+//    REFERENCED(registry));
+//  // ...
+//  // once per tick
+//  ECS::RegistryDelta delta = tracker.takeDelta();
+//  if(!delta.empty())
+//  {
+//    sendToReplica(delta.serialize());
+//  }
+//
+//  // on replica
+//  CHECK(ECS::applyRegistryDelta<Position, ECS::ParentEntity<TagType>>(
+//    *ECS::RegistryDelta::deserialize(data, size), replicaRegistry));
+template <typename... Components>
+class RegistryDeltaTracker
+{
+ public:
+  explicit RegistryDeltaTracker(ECS::Registry& registry)
+    : registry_(registry)
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    (connect<Components>(), ...);
+  }
+
+  ~RegistryDeltaTracker()
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    (disconnect<Components>(), ...);
+  }
+
+  template <typename Component>
+  void markDirty(ECS::Entity entityId)
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    std::get<DirtyEntities<Component>>(dirty_).entities.push_back(
+      static_cast<SnapshotEntityValue>(entityId));
+  }
+
+  // Collects changes made since previous call.
+  MUST_USE_RETURN_VALUE
+  RegistryDelta takeDelta()
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    RegistryDelta delta;
+    delta.sequenceNumber = ++sequenceNumber_;
+
+    (collect<Components>(delta), ...);
+
+    std::sort(delta.destroyed.begin(), delta.destroyed.end());
+    delta.destroyed.erase(
+      std::unique(delta.destroyed.begin(), delta.destroyed.end())
+      , delta.destroyed.end());
+
+    return delta;
+  }
+
+  // Number of deltas made by `takeDelta`.
+  uint64_t sequenceNumber() const
+  {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+    return sequenceNumber_;
+  }
+
+ private:
+  template <typename Component>
+  struct DirtyEntities
+  {
+    // may contain duplicates
+    std::vector<SnapshotEntityValue> entities;
+  };
+
+  template <typename Component>
+  void connect()
+  {
+    registry_.on_construct<Component>().template connect<
+      &RegistryDeltaTracker::onChanged<Component>>(*this);
+    registry_.on_update<Component>().template connect<
+      &RegistryDeltaTracker::onChanged<Component>>(*this);
+    registry_.on_destroy<Component>().template connect<
+      &RegistryDeltaTracker::onChanged<Component>>(*this);
+  }
+
+  template <typename Component>
+  void disconnect()
+  {
+    registry_.on_construct<Component>().disconnect(*this);
+    registry_.on_update<Component>().disconnect(*this);
+    registry_.on_destroy<Component>().disconnect(*this);
+  }
+
+  template <typename Component>
+  void onChanged(ECS::Registry& registry, ECS::Entity entityId)
+  {
+    DCHECK_EQ(&registry, &registry_);
+
+    markDirty<Component>(entityId);
+  }
+
+  template <typename Component>
+  void collect(RegistryDelta& delta)
+  {
+    std::vector<SnapshotEntityValue>& dirty
+      = std::get<DirtyEntities<Component>>(dirty_).entities;
+
+    if(dirty.empty())
+    {
+      return;
+    }
+
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+    RegistryDelta::ComponentChanges changes;
+    changes.typeId = ECS::TypeMetaRegistrator<Component>::id();
+    changes.elementSize
+      = registry_snapshot_internal::snapshotElementSize<Component>();
+
+    for(const SnapshotEntityValue value: dirty)
+    {
+      const ECS::Entity entityId{value};
+
+      /// \note `on_destroy` is emitted before component is removed,
+      /// so we read current state of entity instead of signal type.
+      if(!registry_.valid(entityId))
+      {
+        delta.destroyed.push_back(value);
+        continue;
+      }
+
+      if(!registry_.has<Component>(entityId))
+      {
+        changes.removed.push_back(value);
+        continue;
+      }
+
+      changes.upserted.push_back(value);
+
+      if constexpr (!std::is_empty<Component>::value)
+      {
+        using Codec = SnapshotCodec<Component>;
+
+        const size_t offset = changes.data.size();
+        changes.data.resize(offset + Codec::kSize);
+        Codec::encode(registry_.get<Component>(entityId)
+          , changes.data.data() + offset);
+      }
+    }
+
+    // keep capacity for next tick
+    dirty.clear();
+
+    if(!changes.upserted.empty() || !changes.removed.empty())
+    {
+      delta.components.push_back(RVALUE_CAST(changes));
+    }
+  }
+
+ private:
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  ECS::Registry& registry_;
+
+  std::tuple<DirtyEntities<Components>...> dirty_;
+
+  uint64_t sequenceNumber_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(RegistryDeltaTracker);
+};
+
+namespace registry_delta_internal {
+
+// Creates entity with same identifier (and version) as on primary registry.
+MUST_USE_RETURN_VALUE
+bool ensureEntity(ECS::Registry& registry, SnapshotEntityValue value);
+
+template <typename Component>
+MUST_USE_RETURN_VALUE
+bool applyComponentChanges(
+  const RegistryDelta& delta
+  , ECS::Registry& registry)
+{
+  using Meta = ECS::TypeMetaRegistrator<Component>;
+
+  const RegistryDelta::ComponentChanges* changes
+    = delta.findComponentChanges(Meta::id());
+
+  if(!changes)
+  {
+    return true;
+  }
+
+  if(changes->elementSize
+       != registry_snapshot_internal::snapshotElementSize<Component>()
+     || changes->data.size()
+       != static_cast<size_t>(changes->elementSize) * changes->upserted.size())
+  {
+    LOG(ERROR)
+      << "unexpected size of component: "
+      << Meta::name()
+      << " in registry delta";
+    return false;
+  }
+
+  for(const SnapshotEntityValue value: changes->removed)
+  {
+    const ECS::Entity entityId{value};
+    if(registry.valid(entityId))
+    {
+      registry.remove_if_exists<Component>(entityId);
+    }
+  }
+
+  for(size_t i = 0; i < changes->upserted.size(); ++i)
+  {
+    const SnapshotEntityValue value = changes->upserted[i];
+
+    if(!ensureEntity(registry, value))
+    {
+      LOG(ERROR)
+        << "replica diverged from primary registry, entity: "
+        << ECS::Entity{value};
+      return false;
+    }
+
+    const ECS::Entity entityId{value};
+
+    if constexpr (std::is_empty<Component>::value)
+    {
+      if(!registry.has<Component>(entityId))
+      {
+        registry.emplace<Component>(entityId);
+      }
+    }
+    else
+    {
+      Component component{};
+      SnapshotCodec<Component>::decode(
+        changes->data.data() + i * changes->elementSize
+        , component);
+      registry.emplace_or_replace<Component>(entityId
+        , RVALUE_CAST(component));
+    }
+  }
+
+  return true;
+}
+
+} // namespace registry_delta_internal
+
+// Applies changes made by `RegistryDeltaTracker` to replica registry.
+//
+// Replica must be restored from snapshot of primary registry
+// (see `loadRegistrySnapshot`) or from same sequence of deltas,
+// so entity identifiers on replica and primary registry are equal.
+//
+/// \note Changes of components that are not listed in `Components` are skipped.
+template <typename... Components>
+MUST_USE_RETURN_VALUE
+bool applyRegistryDelta(
+  const RegistryDelta& delta
+  , ECS::Registry& registry)
+{
+  for(const SnapshotEntityValue value: delta.destroyed)
+  {
+    const ECS::Entity entityId{value};
+    if(registry.valid(entityId))
+    {
+      registry.destroy(entityId);
+    }
+  }
+
+  bool ok = true;
+
+  ((ok = ok
+    && registry_delta_internal::applyComponentChanges<Components>(
+         delta, registry))
+    , ...);
+
+  return ok;
+}
+
+} // namespace ECS
@@ -0,0 +1,235 @@
+#include "basis/ECS/snapshot/registry_delta_log.h" // IWYU pragma: associated
+
+#include <base/files/file_util.h>
+#include <base/logging.h>
+#include <base/strings/string_number_conversions.h>
+#include <base/threading/scoped_blocking_call.h>
+#include <base/trace_event/trace_event.h>
+
+#include <basic/rvalue_cast.h>
+
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace ECS {
+
+RegistryDeltaLog::RegistryDeltaLog(
+  const ::base::FilePath& basePath
+  , int64_t maxFileSize
+  , int maxRotatedFiles)
+  : basePath_(basePath)
+  , maxFileSize_(maxFileSize)
+  , maxRotatedFiles_(maxRotatedFiles)
+{
+  DCHECK(!basePath_.empty());
+  DCHECK_GT(maxFileSize_, 0);
+  DCHECK_GE(maxRotatedFiles_, 0);
+}
+
+RegistryDeltaLog::~RegistryDeltaLog()
+{
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+}
+
+// static
+::base::FilePath RegistryDeltaLog::rotatedFilePath(
+  const ::base::FilePath& basePath
+  , int index)
+{
+  DCHECK_GE(index, 0);
+
+  if(index == 0)
+  {
+    return basePath;
+  }
+
+  return basePath.AddExtensionASCII(::base::NumberToString(index));
+}
+
+bool RegistryDeltaLog::openIfNeeded()
+{
+  if(file_.IsValid())
+  {
+    return true;
+  }
+
+  file_.Initialize(basePath_
+    , ::base::File::FLAG_OPEN_ALWAYS | ::base::File::FLAG_APPEND);
+
+  if(!file_.IsValid())
+  {
+    LOG(ERROR)
+      << "unable to open registry delta log: "
+      << basePath_
+      << " error: "
+      << ::base::File::ErrorToString(file_.error_details());
+    return false;
+  }
+
+  fileSize_ = file_.GetLength();
+  return fileSize_ >= 0;
+}
+
+bool RegistryDeltaLog::rotate()
+{
+  TRACE_EVENT0("headless", "RegistryDeltaLog::rotate");
+
+  file_.Close();
+  fileSize_ = 0;
+
+  if(maxRotatedFiles_ == 0)
+  {
+    return ::base::DeleteFile(basePath_, false);
+  }
+
+  // oldest file is dropped
+  ignore_result(::base::DeleteFile(
+    rotatedFilePath(basePath_, maxRotatedFiles_), false));
+
+  for(int index = maxRotatedFiles_ - 1; index >= 0; --index)
+  {
+    const ::base::FilePath from = rotatedFilePath(basePath_, index);
+    if(!::base::PathExists(from))
+    {
+      continue;
+    }
+
+    if(!::base::ReplaceFile(from
+        , rotatedFilePath(basePath_, index + 1)
+        , nullptr))
+    {
+      LOG(ERROR)
+        << "unable to rotate registry delta log: "
+        << from;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool RegistryDeltaLog::append(const RegistryDelta& delta)
+{
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  ::base::ScopedBlockingCall scoped_blocking_call(
+    FROM_HERE, ::base::BlockingType::MAY_BLOCK);
+
+  const std::vector<uint8_t> record = delta.serialize();
+  CHECK_LE(record.size(), std::numeric_limits<uint32_t>::max());
+  const uint32_t recordSize = static_cast<uint32_t>(record.size());
+
+  if(fileSize_ > 0
+     && fileSize_ + static_cast<int64_t>(sizeof(recordSize) + recordSize)
+          > maxFileSize_
+     && !rotate())
+  {
+    return false;
+  }
+
+  if(!openIfNeeded())
+  {
+    return false;
+  }
+
+  std::string buffer(sizeof(recordSize) + record.size(), '\0');
+  std::memcpy(&buffer[0], &recordSize, sizeof(recordSize));
+  std::memcpy(&buffer[sizeof(recordSize)], record.data(), record.size());
+
+  if(file_.WriteAtCurrentPos(buffer.data(), static_cast<int>(buffer.size()))
+       != static_cast<int>(buffer.size()))
+  {
+    LOG(ERROR)
+      << "unable to write registry delta log: "
+      << basePath_;
+    // do not append records after partially written record
+    file_.Close();
+    return false;
+  }
+
+  fileSize_ += static_cast<int64_t>(buffer.size());
+  return true;
+}
+
+bool RegistryDeltaLog::flush()
+{
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  ::base::ScopedBlockingCall scoped_blocking_call(
+    FROM_HERE, ::base::BlockingType::MAY_BLOCK);
+
+  return !file_.IsValid() || file_.Flush();
+}
+
+// static
+bool RegistryDeltaLog::replay(
+  const ::base::FilePath& basePath
+  , int maxRotatedFiles
+  , const ReplayCallback& callback)
+{
+  DCHECK(callback);
+
+  TRACE_EVENT0("headless", "RegistryDeltaLog::replay");
+
+  ::base::ScopedBlockingCall scoped_blocking_call(
+    FROM_HERE, ::base::BlockingType::MAY_BLOCK);
+
+  for(int index = maxRotatedFiles; index >= 0; --index)
+  {
+    const ::base::FilePath path = rotatedFilePath(basePath, index);
+
+    std::string contents;
+    if(!::base::ReadFileToString(path, &contents))
+    {
+      // rotated files may not exist yet
+      continue;
+    }
+
+    size_t pos = 0;
+    while(pos < contents.size())
+    {
+      uint32_t recordSize = 0;
+      if(contents.size() - pos < sizeof(recordSize))
+      {
+        LOG(ERROR)
+          << "truncated registry delta log: "
+          << path;
+        return false;
+      }
+      std::memcpy(&recordSize, contents.data() + pos, sizeof(recordSize));
+      pos += sizeof(recordSize);
+
+      if(contents.size() - pos < recordSize)
+      {
+        LOG(ERROR)
+          << "truncated registry delta log: "
+          << path;
+        return false;
+      }
+
+      ::base::Optional<RegistryDelta> delta
+        = RegistryDelta::deserialize(
+            reinterpret_cast<const uint8_t*>(contents.data() + pos)
+            , recordSize);
+      pos += recordSize;
+
+      if(!delta)
+      {
+        LOG(ERROR)
+          << "corrupted registry delta log: "
+          << path;
+        return false;
+      }
+
+      if(!callback.Run(RVALUE_CAST(delta.value())))
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+} // namespace ECS
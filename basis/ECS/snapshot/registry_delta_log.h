@@ -0,0 +1,96 @@
+#pragma once
+
+#include <basis/ECS/snapshot/registry_delta.h>
+
+#include <base/callback.h>
+#include <base/files/file.h>
+#include <base/files/file_path.h>
+#include <base/macros.h>
+#include <base/sequence_checker.h>
+
+#include <basic/macros.h>
+
+#include <cstdint>
+
+namespace ECS {
+
+// Rolling log of `RegistryDelta` records.
+//
+// Records are appended to `basePath`.
+// If size of `basePath` exceeds `maxFileSize`, then file is rotated:
+// `basePath` is renamed to `basePath.1`, `basePath.1` to `basePath.2` etc.
+// (files older than `basePath.<maxRotatedFiles>` are deleted).
+//
+// Each record is `uint32_t` size followed by `RegistryDelta::serialize()`.
+//
+/// \note performs blocking I/O, so use it on task runner with
+/// `base::MayBlock()` trait.
+//
+// USAGE
+//
+//  // hot standby restores latest snapshot and then replays log
+//  ECS::RegistryDeltaLog::replay(logPath
+//    , kMaxRotatedFiles
+//    , ::base::BindRepeating(
+//        [](ECS::Registry* registry, ECS::RegistryDelta delta)
+//        {
+//          return ECS::applyRegistryDelta<Position>(delta, *registry);
+//        }
+//        , ::base::Unretained(&registry)));
+class RegistryDeltaLog
+{
+ public:
+  // Returns `false` to stop replay.
+  using ReplayCallback
+    = ::base::RepeatingCallback<bool(RegistryDelta)>;
+
+  RegistryDeltaLog(
+    const ::base::FilePath& basePath
+    , int64_t maxFileSize
+    , int maxRotatedFiles);
+
+  ~RegistryDeltaLog();
+
+  MUST_USE_RETURN_VALUE
+  bool append(const RegistryDelta& delta);
+
+  // Forces buffered records to disk.
+  MUST_USE_RETURN_VALUE
+  bool flush();
+
+  // Reads records from rotated files (oldest first) and from `basePath`.
+  // Stops on first corrupted record.
+  MUST_USE_RETURN_VALUE
+  static bool replay(
+    const ::base::FilePath& basePath
+    , int maxRotatedFiles
+    , const ReplayCallback& callback);
+
+  // Path of rotated file with `index` (zero index means `basePath`).
+  MUST_USE_RETURN_VALUE
+  static ::base::FilePath rotatedFilePath(
+    const ::base::FilePath& basePath
+    , int index);
+
+ private:
+  bool openIfNeeded();
+
+  bool rotate();
+
+ private:
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  const ::base::FilePath basePath_;
+
+  const int64_t maxFileSize_;
+
+  const int maxRotatedFiles_;
+
+  ::base::File file_;
+
+  int64_t fileSize_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(RegistryDeltaLog);
+};
+
+} // namespace ECS
@@ -0,0 +1,269 @@
+#include "basis/ECS/snapshot/registry_delta.h"
+#include "basis/ECS/snapshot/registry_delta_log.h"
+
+#include <basis/ECS/helpers/relationship/prepend_child_entity.h>
+#include <basis/ECS/helpers/relationship/remove_child_from_top_level.h>
+#include <basis/ECS/helpers/relationship/validate_relationships.h>
+
+#include <base/bind.h>
+#include <base/files/file_path.h>
+#include <base/files/file_util.h>
+#include <base/files/scoped_temp_dir.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+struct DeltaTestHealth
+{
+  int32_t value;
+};
+
+CREATE_ECS_TAG(DeltaTestMarker);
+
+class DeltaTestTag{};
+
+using ParentComponent = ECS::ParentEntity<DeltaTestTag>;
+using ChildrenComponent = ECS::ChildSiblings<DeltaTestTag>;
+using FirstChildComponent = ECS::FirstChildInLinkedList<DeltaTestTag>;
+using ChildrenSizeComponent
+  = ECS::TopLevelChildrenCount<DeltaTestTag, size_t>;
+
+} // namespace
+
+ECS_DECLARE_METATYPE(DeltaTestHealth);
+ECS_DEFINE_METATYPE(DeltaTestHealth);
+ECS_DECLARE_METATYPE(DeltaTestMarker);
+ECS_DEFINE_METATYPE(DeltaTestMarker);
+ECS_DEFINE_METATYPE_TEMPLATE(ParentComponent);
+ECS_DEFINE_METATYPE_TEMPLATE(ChildrenComponent);
+ECS_DEFINE_METATYPE_TEMPLATE(FirstChildComponent);
+ECS_DEFINE_METATYPE_TEMPLATE(ChildrenSizeComponent);
+
+namespace ECS {
+
+namespace {
+
+#define DELTA_TEST_COMPONENTS \
+  DeltaTestHealth \
+  , DeltaTestMarker \
+  , ParentComponent \
+  , ChildrenComponent \
+  , FirstChildComponent \
+  , ChildrenSizeComponent
+
+using TestTracker
+  = RegistryDeltaTracker<DELTA_TEST_COMPONENTS>;
+
+// Transfers delta through serialized representation.
+void replicate(
+  TestTracker& tracker
+  , ECS::Registry& replica)
+{
+  const std::vector<uint8_t> data = tracker.takeDelta().serialize();
+  ::base::Optional<RegistryDelta> delta
+    = RegistryDelta::deserialize(data.data(), data.size());
+  ASSERT_TRUE(delta);
+  ASSERT_TRUE(
+    (applyRegistryDelta<DELTA_TEST_COMPONENTS>(*delta, replica)));
+}
+
+} // namespace
+
+TEST(RegistryDeltaTest, ReplicatesChanges)
+{
+  ECS::Registry primary;
+  ECS::Registry replica;
+  TestTracker tracker(primary);
+
+  const ECS::Entity parentId = primary.create();
+  primary.emplace<DeltaTestHealth>(parentId, 100);
+  primary.emplace<DeltaTestMarker>(parentId);
+
+  std::vector<ECS::Entity> childIds;
+  for(int i = 0; i < 3; ++i)
+  {
+    childIds.push_back(primary.create());
+    primary.emplace<DeltaTestHealth>(childIds.back(), i);
+    ECS::prependChildEntity<DeltaTestTag>(
+      REFERENCED(primary)
+      , parentId
+      , childIds.back());
+  }
+
+  replicate(tracker, replica);
+
+  EXPECT_TRUE(validateRelationships<DeltaTestTag>(replica));
+  EXPECT_EQ(replica.get<DeltaTestHealth>(parentId).value, 100);
+  EXPECT_TRUE(replica.has<DeltaTestMarker>(parentId));
+  EXPECT_EQ(replica.get<ChildrenSizeComponent>(parentId).size, 3u);
+
+  // nothing changed
+  EXPECT_TRUE(tracker.takeDelta().empty());
+
+  // update, removal and destruction in same tick
+  primary.replace<DeltaTestHealth>(parentId, 50);
+  primary.remove<DeltaTestMarker>(parentId);
+  ASSERT_TRUE(ECS::removeChildFromTopLevel<DeltaTestTag>(
+    REFERENCED(primary)
+    , parentId
+    , childIds[1]));
+  primary.destroy(childIds[1]);
+  const ECS::Entity changedId = childIds[2];
+  primary.get<DeltaTestHealth>(changedId).value = 42;
+  tracker.markDirty<DeltaTestHealth>(changedId);
+
+  RegistryDelta delta = tracker.takeDelta();
+  EXPECT_EQ(delta.sequenceNumber, 3u);
+  ASSERT_EQ(delta.destroyed.size(), 1u);
+  EXPECT_EQ(ECS::Entity{delta.destroyed[0]}, childIds[1]);
+
+  ASSERT_TRUE(
+    (applyRegistryDelta<DELTA_TEST_COMPONENTS>(delta, replica)));
+
+  EXPECT_TRUE(validateRelationships<DeltaTestTag>(replica));
+  EXPECT_EQ(replica.get<DeltaTestHealth>(parentId).value, 50);
+  EXPECT_FALSE(replica.has<DeltaTestMarker>(parentId));
+  EXPECT_FALSE(replica.valid(childIds[1]));
+  EXPECT_EQ(replica.get<ChildrenSizeComponent>(parentId).size, 2u);
+  EXPECT_EQ(replica.get<DeltaTestHealth>(changedId).value, 42);
+}
+
+// Relationship helpers modify existing components of parent and siblings,
+// so those changes must be replicated without `markDirty`.
+TEST(RegistryDeltaTest, ReplicatesRelationshipChangesInLaterTick)
+{
+  ECS::Registry primary;
+  ECS::Registry replica;
+  TestTracker tracker(primary);
+
+  const ECS::Entity parentId = primary.create();
+  primary.emplace<DeltaTestHealth>(parentId, 100);
+
+  std::vector<ECS::Entity> childIds;
+  for(int i = 0; i < 3; ++i)
+  {
+    childIds.push_back(primary.create());
+    primary.emplace<DeltaTestHealth>(childIds.back(), i);
+    ECS::prependChildEntity<DeltaTestTag>(
+      REFERENCED(primary)
+      , parentId
+      , childIds.back());
+  }
+
+  replicate(tracker, replica);
+  ASSERT_TRUE(validateRelationships<DeltaTestTag>(replica));
+
+  // prepend changes first child of parent, size of list
+  // and `prev` link of previous first child
+  const ECS::Entity newChildId = primary.create();
+  primary.emplace<DeltaTestHealth>(newChildId, 3);
+  ECS::prependChildEntity<DeltaTestTag>(
+    REFERENCED(primary)
+    , parentId
+    , newChildId);
+
+  replicate(tracker, replica);
+
+  EXPECT_TRUE(validateRelationships<DeltaTestTag>(replica));
+  EXPECT_EQ(replica.get<ChildrenSizeComponent>(parentId).size, 4u);
+  EXPECT_EQ(replica.get<FirstChildComponent>(parentId).firstId, newChildId);
+  EXPECT_EQ(replica.get<ChildrenComponent>(childIds.back()).prevId
+    , newChildId);
+
+  // remove first child and child from middle of list
+  ASSERT_TRUE(ECS::removeChildFromTopLevel<DeltaTestTag>(
+    REFERENCED(primary)
+    , parentId
+    , newChildId));
+  ASSERT_TRUE(ECS::removeChildFromTopLevel<DeltaTestTag>(
+    REFERENCED(primary)
+    , parentId
+    , childIds[1]));
+  primary.destroy(childIds[1]);
+
+  replicate(tracker, replica);
+
+  EXPECT_TRUE(validateRelationships<DeltaTestTag>(replica));
+  EXPECT_EQ(replica.get<ChildrenSizeComponent>(parentId).size, 2u);
+  EXPECT_EQ(replica.get<FirstChildComponent>(parentId).firstId
+    , childIds[2]);
+  EXPECT_EQ(replica.get<ChildrenComponent>(childIds[2]).nextId
+    , childIds[0]);
+  EXPECT_EQ(replica.get<ChildrenComponent>(childIds[0]).prevId
+    , childIds[2]);
+  // unlinked child is alive, but not in hierarchy
+  EXPECT_TRUE(replica.valid(newChildId));
+  EXPECT_FALSE(replica.has<ParentComponent>(newChildId));
+  EXPECT_FALSE(replica.valid(childIds[1]));
+}
+
+TEST(RegistryDeltaTest, RejectsCorruptedData)
+{
+  ECS::Registry primary;
+  TestTracker tracker(primary);
+
+  primary.emplace<DeltaTestHealth>(primary.create(), 1);
+
+  std::vector<uint8_t> data = tracker.takeDelta().serialize();
+  ASSERT_TRUE(RegistryDelta::deserialize(data.data(), data.size()));
+
+  data.resize(data.size() - 1);
+  EXPECT_FALSE(RegistryDelta::deserialize(data.data(), data.size()));
+}
+
+TEST(RegistryDeltaTest, ReplaysRotatedLog)
+{
+  ::base::ScopedTempDir tempDir;
+  ASSERT_TRUE(tempDir.CreateUniqueTempDir());
+  const ::base::FilePath logPath
+    = tempDir.GetPath().AppendASCII("registry.delta");
+  constexpr int kMaxRotatedFiles = 8;
+
+  ECS::Registry primary;
+  TestTracker tracker(primary);
+
+  {
+    // small file size forces rotation on each record
+    RegistryDeltaLog log(logPath, 1, kMaxRotatedFiles);
+
+    const ECS::Entity entityId = primary.create();
+    primary.emplace<DeltaTestHealth>(entityId, 0);
+    for(int32_t i = 1; i <= 3; ++i)
+    {
+      ASSERT_TRUE(log.append(tracker.takeDelta()));
+      primary.replace<DeltaTestHealth>(entityId, i);
+    }
+    ASSERT_TRUE(log.append(tracker.takeDelta()));
+    ASSERT_TRUE(log.flush());
+  }
+
+  EXPECT_TRUE(::base::PathExists(
+    RegistryDeltaLog::rotatedFilePath(logPath, 3)));
+
+  ECS::Registry replica;
+  std::vector<uint64_t> sequenceNumbers;
+  ASSERT_TRUE(RegistryDeltaLog::replay(logPath
+    , kMaxRotatedFiles
+    , ::base::BindRepeating(
+        [](ECS::Registry* registry
+           , std::vector<uint64_t>* sequenceNumbers
+           , RegistryDelta delta)
+        {
+          sequenceNumbers->push_back(delta.sequenceNumber);
+          return applyRegistryDelta<DELTA_TEST_COMPONENTS>(delta, *registry);
+        }
+        , ::base::Unretained(&replica)
+        , ::base::Unretained(&sequenceNumbers))));
+
+  EXPECT_EQ(sequenceNumbers, (std::vector<uint64_t>{1, 2, 3, 4}));
+
+  const auto view = replica.view<const DeltaTestHealth>();
+  ASSERT_EQ(view.size(), 1u);
+  EXPECT_EQ(view.get<const DeltaTestHealth>(*view.begin()).value, 3);
+}
+
+} // namespace ECS
@@ -0,0 +1,489 @@
+#include "basis/ECS/snapshot/registry_snapshot.h" // IWYU pragma: associated
+
+#include <base/bind.h>
+#include <base/files/file.h>
+#include <base/files/file_util.h>
+#include <base/task/post_task.h>
+#include <base/task/task_traits.h>
+#include <base/task/thread_pool.h>
+#include <base/threading/scoped_blocking_call.h>
+#include <base/trace_event/trace_event.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace ECS {
+
+namespace registry_snapshot_internal {
+
+const char kEntitiesSectionName[] = "entities";
+
+} // namespace registry_snapshot_internal
+
+namespace {
+
+// "BECS" in little-endian
+constexpr uint32_t kSnapshotMagic = 0x53434542;
+
+constexpr uint32_t kSnapshotVersion = 1;
+
+// Columns are aligned, so memory-mapped file can be read
+// without unaligned loads.
+constexpr uint64_t kSectionAlignment = 16;
+
+struct FileHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t sectionCount;
+  uint32_t entityValueSize;
+  uint64_t sectionTableOffset;
+  uint64_t fileSize;
+};
+
+struct SectionRecord
+{
+  uint64_t typeId;
+  uint64_t entitiesOffset;
+  uint64_t dataOffset;
+  uint64_t nameOffset;
+  uint32_t nameSize;
+  uint32_t elementSize;
+  uint32_t count;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) % kSectionAlignment == 0
+  , "FileHeader must keep sections aligned");
+
+static_assert(sizeof(SectionRecord) % 8 == 0
+  , "SectionRecord must keep section table aligned");
+
+uint64_t alignOffset(uint64_t offset)
+{
+  return (offset + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+}
+
+// Writes data at current position of file and tracks offset.
+class SnapshotFileWriter
+{
+ public:
+  explicit SnapshotFileWriter(::base::File* file)
+    : file_(file)
+  {
+    DCHECK(file_);
+  }
+
+  MUST_USE_RETURN_VALUE
+  bool write(const void* data, size_t size)
+  {
+    if(size == 0)
+    {
+      return true;
+    }
+
+    DCHECK_LE(size, static_cast<size_t>(std::numeric_limits<int>::max()));
+
+    const int written
+      = file_->WriteAtCurrentPos(static_cast<const char*>(data)
+          , static_cast<int>(size));
+
+    if(written < 0 || static_cast<size_t>(written) != size)
+    {
+      return false;
+    }
+
+    offset_ += size;
+    return true;
+  }
+
+  MUST_USE_RETURN_VALUE
+  bool padToAlignment()
+  {
+    static const uint8_t kZeros[kSectionAlignment] = {};
+
+    return write(kZeros, alignOffset(offset_) - offset_);
+  }
+
+  uint64_t offset() const
+  {
+    return offset_;
+  }
+
+ private:
+  ::base::File* file_;
+
+  uint64_t offset_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(SnapshotFileWriter);
+};
+
+bool writeSnapshotToOpenedFile(
+  ::base::File& file
+  , const RegistrySnapshot& snapshot)
+{
+  SnapshotFileWriter writer(&file);
+
+  // Header is patched after section table is written.
+  FileHeader header{};
+  if(!writer.write(&header, sizeof(header)))
+  {
+    return false;
+  }
+
+  std::vector<SectionRecord> records;
+  records.reserve(snapshot.sections().size());
+
+  for(const RegistrySnapshot::Section& section: snapshot.sections())
+  {
+    DCHECK_EQ(section.data.size()
+      , static_cast<size_t>(section.elementSize) * section.entities.size());
+
+    SectionRecord record{};
+    record.typeId = section.typeId;
+    record.elementSize = section.elementSize;
+    record.count = static_cast<uint32_t>(section.entities.size());
+
+    if(!writer.padToAlignment())
+    {
+      return false;
+    }
+    record.entitiesOffset = writer.offset();
+    if(!writer.write(section.entities.data()
+        , section.entities.size() * sizeof(SnapshotEntityValue)))
+    {
+      return false;
+    }
+
+    if(!writer.padToAlignment())
+    {
+      return false;
+    }
+    record.dataOffset = writer.offset();
+    if(!writer.write(section.data.data(), section.data.size()))
+    {
+      return false;
+    }
+
+    records.push_back(record);
+  }
+
+  if(!writer.padToAlignment())
+  {
+    return false;
+  }
+
+  const uint64_t sectionTableOffset = writer.offset();
+
+  // names are stored after section table
+  uint64_t nameOffset
+    = sectionTableOffset + records.size() * sizeof(SectionRecord);
+  for(size_t i = 0; i < records.size(); ++i)
+  {
+    records[i].nameOffset = nameOffset;
+    records[i].nameSize
+      = static_cast<uint32_t>(snapshot.sections()[i].name.size());
+    nameOffset += records[i].nameSize;
+  }
+
+  if(!writer.write(records.data(), records.size() * sizeof(SectionRecord)))
+  {
+    return false;
+  }
+
+  for(const RegistrySnapshot::Section& section: snapshot.sections())
+  {
+    if(!writer.write(section.name.data(), section.name.size()))
+    {
+      return false;
+    }
+  }
+
+  DCHECK_EQ(writer.offset(), nameOffset);
+
+  header.magic = kSnapshotMagic;
+  header.version = kSnapshotVersion;
+  header.sectionCount = static_cast<uint32_t>(records.size());
+  header.entityValueSize = sizeof(SnapshotEntityValue);
+  header.sectionTableOffset = sectionTableOffset;
+  header.fileSize = writer.offset();
+
+  return file.Write(0
+      , reinterpret_cast<const char*>(&header)
+      , sizeof(header)) == static_cast<int>(sizeof(header))
+    && file.Flush();
+}
+
+} // namespace
+
+RegistrySnapshot::RegistrySnapshot() = default;
+
+RegistrySnapshot::RegistrySnapshot(RegistrySnapshot&& other) = default;
+
+RegistrySnapshot& RegistrySnapshot::operator=(
+  RegistrySnapshot&& other) = default;
+
+RegistrySnapshot::~RegistrySnapshot() = default;
+
+RegistrySnapshot::Section& RegistrySnapshot::addSection(
+  uint64_t typeId
+  , const std::string& name
+  , uint32_t elementSize)
+{
+  DCHECK(std::none_of(sections_.begin(), sections_.end()
+    , [typeId](const Section& section)
+      {
+        return section.typeId == typeId;
+      }))
+    << "duplicated section: "
+    << name;
+
+  sections_.emplace_back();
+  Section& section = sections_.back();
+  section.typeId = typeId;
+  section.name = name;
+  section.elementSize = elementSize;
+  return section;
+}
+
+size_t RegistrySnapshot::payloadSize() const
+{
+  size_t result = 0;
+  for(const Section& section: sections_)
+  {
+    result += section.entities.size() * sizeof(SnapshotEntityValue)
+      + section.data.size();
+  }
+  return result;
+}
+
+bool writeRegistrySnapshotToFile(
+  const ::base::FilePath& path
+  , const RegistrySnapshot& snapshot)
+{
+  TRACE_EVENT0("headless", "writeRegistrySnapshotToFile");
+
+  ::base::ScopedBlockingCall scoped_blocking_call(
+    FROM_HERE, ::base::BlockingType::MAY_BLOCK);
+
+  const ::base::FilePath tmpPath
+    = path.AddExtension(FILE_PATH_LITERAL("tmp"));
+
+  {
+    ::base::File file(tmpPath
+      , ::base::File::FLAG_CREATE_ALWAYS | ::base::File::FLAG_WRITE);
+
+    if(!file.IsValid())
+    {
+      LOG(ERROR)
+        << "unable to create snapshot file: "
+        << tmpPath
+        << " error: "
+        << ::base::File::ErrorToString(file.error_details());
+      return false;
+    }
+
+    if(!writeSnapshotToOpenedFile(file, snapshot))
+    {
+      LOG(ERROR)
+        << "unable to write snapshot file: "
+        << tmpPath;
+      file.Close();
+      ignore_result(::base::DeleteFile(tmpPath, false));
+      return false;
+    }
+  }
+
+  ::base::File::Error error = ::base::File::FILE_OK;
+  if(!::base::ReplaceFile(tmpPath, path, &error))
+  {
+    LOG(ERROR)
+      << "unable to replace snapshot file: "
+      << path
+      << " error: "
+      << ::base::File::ErrorToString(error);
+    ignore_result(::base::DeleteFile(tmpPath, false));
+    return false;
+  }
+
+  return true;
+}
+
+void postRegistrySnapshotWrite(
+  const ::base::FilePath& path
+  , RegistrySnapshot snapshot
+  , ::base::OnceCallback<void(bool)> doneCallback)
+{
+  DCHECK(doneCallback);
+
+  ::base::ThreadPool::PostTaskAndReplyWithResult(
+    FROM_HERE
+    , {
+        ::base::MayBlock()
+        , ::base::TaskPriority::USER_VISIBLE
+        // `path` is replaced atomically,
+        // so it is safe to skip write on shutdown.
+        , ::base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN
+      }
+    , ::base::BindOnce(
+        [](const ::base::FilePath& path, RegistrySnapshot snapshot)
+        {
+          return writeRegistrySnapshotToFile(path, snapshot);
+        }
+        , path
+        , RVALUE_CAST(snapshot))
+    , RVALUE_CAST(doneCallback));
+}
+
+RegistrySnapshotReader::RegistrySnapshotReader() = default;
+
+RegistrySnapshotReader::~RegistrySnapshotReader() = default;
+
+bool RegistrySnapshotReader::initialize(const ::base::FilePath& path)
+{
+  DCHECK(!mappedFile_);
+  DCHECK(sections_.empty());
+
+  TRACE_EVENT0("headless", "RegistrySnapshotReader::initialize");
+
+  mappedFile_ = std::make_unique<::base::MemoryMappedFile>();
+  if(!mappedFile_->Initialize(path))
+  {
+    LOG(ERROR)
+      << "unable to map snapshot file: "
+      << path;
+    mappedFile_.reset();
+    return false;
+  }
+
+  if(!parseMappedFile())
+  {
+    LOG(ERROR)
+      << "corrupted snapshot file: "
+      << path;
+    mappedFile_.reset();
+    sections_.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool RegistrySnapshotReader::initialize(const RegistrySnapshot& snapshot)
+{
+  DCHECK(!mappedFile_);
+  DCHECK(sections_.empty());
+
+  sections_.reserve(snapshot.sections().size());
+  for(const RegistrySnapshot::Section& section: snapshot.sections())
+  {
+    SnapshotSectionView view;
+    view.typeId = section.typeId;
+    view.name = section.name;
+    view.elementSize = section.elementSize;
+    view.count = static_cast<uint32_t>(section.entities.size());
+    view.entities = section.entities.data();
+    view.data = section.data.data();
+    sections_.push_back(view);
+  }
+
+  return entitiesSection() != nullptr;
+}
+
+bool RegistrySnapshotReader::parseMappedFile()
+{
+  DCHECK(mappedFile_);
+
+  const uint8_t* fileData = mappedFile_->data();
+  const uint64_t fileSize = mappedFile_->length();
+
+  // Returns `false` if [offset, offset + size) is out of file.
+  const auto isInFile
+    = [fileSize](uint64_t offset, uint64_t size)
+      {
+        return offset <= fileSize && size <= fileSize - offset;
+      };
+
+  if(!isInFile(0, sizeof(FileHeader)))
+  {
+    return false;
+  }
+
+  FileHeader header;
+  std::memcpy(&header, fileData, sizeof(header));
+
+  if(header.magic != kSnapshotMagic
+     || header.version != kSnapshotVersion
+     || header.entityValueSize != sizeof(SnapshotEntityValue)
+     || header.fileSize != fileSize
+     || header.sectionTableOffset % alignof(SectionRecord) != 0
+     || !isInFile(header.sectionTableOffset
+          , static_cast<uint64_t>(header.sectionCount)
+              * sizeof(SectionRecord)))
+  {
+    return false;
+  }
+
+  const SectionRecord* records
+    = reinterpret_cast<const SectionRecord*>(
+        fileData + header.sectionTableOffset);
+
+  sections_.reserve(header.sectionCount);
+  for(uint32_t i = 0; i < header.sectionCount; ++i)
+  {
+    const SectionRecord& record = records[i];
+
+    if(record.entitiesOffset % kSectionAlignment != 0
+       || record.dataOffset % kSectionAlignment != 0
+       || !isInFile(record.entitiesOffset
+            , static_cast<uint64_t>(record.count)
+                * sizeof(SnapshotEntityValue))
+       || !isInFile(record.dataOffset
+            , static_cast<uint64_t>(record.count) * record.elementSize)
+       || !isInFile(record.nameOffset, record.nameSize))
+    {
+      return false;
+    }
+
+    SnapshotSectionView view;
+    view.typeId = record.typeId;
+    view.name = ::base::StringPiece(
+      reinterpret_cast<const char*>(fileData + record.nameOffset)
+      , record.nameSize);
+    view.elementSize = record.elementSize;
+    view.count = record.count;
+    view.entities = reinterpret_cast<const SnapshotEntityValue*>(
+      fileData + record.entitiesOffset);
+    view.data = fileData + record.dataOffset;
+    sections_.push_back(view);
+  }
+
+  return entitiesSection() != nullptr;
+}
+
+const SnapshotSectionView* RegistrySnapshotReader::entitiesSection() const
+{
+  if(sections_.empty()
+     || sections_.front().typeId != registry_snapshot_internal::kEntitiesTypeId)
+  {
+    return nullptr;
+  }
+  return &sections_.front();
+}
+
+const SnapshotSectionView* RegistrySnapshotReader::findSection(
+  uint64_t typeId) const
+{
+  DCHECK_NE(typeId, registry_snapshot_internal::kEntitiesTypeId);
+
+  for(const SnapshotSectionView& section: sections_)
+  {
+    if(section.typeId == typeId)
+    {
+      return &section;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace ECS
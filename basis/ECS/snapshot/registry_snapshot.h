@@ -0,0 +1,579 @@
+#pragma once
+
+#include <basis/ECS/ecs.h>
+#include <basis/ECS/safe_registry.h>
+#include <basis/ECS/components/relationship/child_siblings.h>
+#include <basis/ECS/components/relationship/first_child_in_linked_list.h>
+#include <basis/ECS/components/relationship/parent_entity.h>
+
+#include <base/callback.h>
+#include <base/files/file_path.h>
+#include <base/files/memory_mapped_file.h>
+#include <base/logging.h>
+#include <base/macros.h>
+#include <base/strings/string_piece.h>
+
+#include <basic/macros.h>
+#include <basic/rvalue_cast.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ECS {
+
+// Snapshot and restore of `ECS::Registry` in compact binary format.
+//
+// Snapshot is made using `entt::basic_snapshot`
+// (and restored using `entt::basic_snapshot_loader`),
+// so entity identifiers (and versions) are preserved
+// and relationship components (`ParentEntity`, `ChildSiblings`, etc.)
+// stay consistent after restore.
+//
+// File format is columnar (one section per component type):
+//
+//   FileHeader
+//   section payloads:
+//     entity column (`EntityValue[count]`, aligned to `kSectionAlignment`)
+//     data column (`element_size * count` bytes, aligned to `kSectionAlignment`)
+//   section table (`SectionRecord[section_count]`)
+//   section names
+//
+// First section always stores all entities of registry.
+// Section table is written last, so file can be written
+// section-by-section without seeking back
+// (except of `FileHeader` that is patched at the end).
+// Columns are aligned, so file can be memory-mapped
+// and read without copies (see `RegistrySnapshotReader`).
+//
+/// \note Format uses native byte order and is not portable between
+/// platforms with different endianness.
+//
+// USAGE
+//
+//  // on sequence of `safeRegistry`
+//  ECS::writeRegistrySnapshotAsync<
+//      Position, ECS::ParentEntity<TagType>, ECS::ChildSiblings<TagType>
+//    >(safeRegistry
+//      , filePath
+//      , ::base::BindOnce([](bool ok){ LOG_IF(WARNING, !ok) << "..."; }));
+//
+//  // later (on failover)
+//  ECS::RegistrySnapshotReader reader;
+//  CHECK(reader.initialize(filePath));
+//  CHECK(ECS::loadRegistrySnapshot<
+//      Position, ECS::ParentEntity<TagType>, ECS::ChildSiblings<TagType>
+//    >(reader, registry));
+//  CHECK(ECS::validateRelationships<TagType>(registry));
+
+// Integral value of `ECS::Entity` as stored in snapshot.
+using SnapshotEntityValue
+  = ECS::Entity::entity_type;
+
+// Converts component to fixed-size binary row (and back).
+//
+// Default implementation copies bytes of trivially copyable type.
+// Specialize it for components that can not be copied using `memcpy`.
+//
+/// \note `kSize` must not depend on value of component
+/// (rows of column have same size).
+template <typename Component, typename = void>
+struct SnapshotCodec
+{
+  static_assert(std::is_trivially_copyable<Component>::value,
+    "Specialize ECS::SnapshotCodec for non-trivially copyable component");
+
+  static constexpr uint32_t kSize = sizeof(Component);
+
+  static void encode(const Component& component, uint8_t* out)
+  {
+    std::memcpy(out, &component, kSize);
+  }
+
+  static void decode(const uint8_t* in, Component& component)
+  {
+    std::memcpy(&component, in, kSize);
+  }
+};
+
+namespace registry_snapshot_internal {
+
+inline void encodeEntity(ECS::Entity entityId, uint8_t* out)
+{
+  const SnapshotEntityValue value
+    = static_cast<SnapshotEntityValue>(entityId);
+  std::memcpy(out, &value, sizeof(value));
+}
+
+inline ECS::Entity decodeEntity(const uint8_t* in)
+{
+  SnapshotEntityValue value;
+  std::memcpy(&value, in, sizeof(value));
+  return ECS::Entity{value};
+}
+
+} // namespace registry_snapshot_internal
+
+// `ECS::Entity` is not trivially copyable,
+// so relationship components store entity ids as integral values.
+template <typename TagType>
+struct SnapshotCodec<ECS::ParentEntity<TagType>>
+{
+  static constexpr uint32_t kSize = sizeof(SnapshotEntityValue);
+
+  static void encode(const ECS::ParentEntity<TagType>& component, uint8_t* out)
+  {
+    registry_snapshot_internal::encodeEntity(component.parentId, out);
+  }
+
+  static void decode(const uint8_t* in, ECS::ParentEntity<TagType>& component)
+  {
+    component.parentId = registry_snapshot_internal::decodeEntity(in);
+  }
+};
+
+template <typename TagType>
+struct SnapshotCodec<ECS::FirstChildInLinkedList<TagType>>
+{
+  static constexpr uint32_t kSize = sizeof(SnapshotEntityValue);
+
+  static void encode(
+    const ECS::FirstChildInLinkedList<TagType>& component, uint8_t* out)
+  {
+    registry_snapshot_internal::encodeEntity(component.firstId, out);
+  }
+
+  static void decode(
+    const uint8_t* in, ECS::FirstChildInLinkedList<TagType>& component)
+  {
+    component.firstId = registry_snapshot_internal::decodeEntity(in);
+  }
+};
+
+template <typename TagType>
+struct SnapshotCodec<ECS::ChildSiblings<TagType>>
+{
+  static constexpr uint32_t kSize = 2 * sizeof(SnapshotEntityValue);
+
+  static void encode(const ECS::ChildSiblings<TagType>& component, uint8_t* out)
+  {
+    registry_snapshot_internal::encodeEntity(component.prevId, out);
+    registry_snapshot_internal::encodeEntity(component.nextId
+      , out + sizeof(SnapshotEntityValue));
+  }
+
+  static void decode(const uint8_t* in, ECS::ChildSiblings<TagType>& component)
+  {
+    component.prevId = registry_snapshot_internal::decodeEntity(in);
+    component.nextId = registry_snapshot_internal::decodeEntity(
+      in + sizeof(SnapshotEntityValue));
+  }
+};
+
+// Read-only view of one section (column pair) of snapshot.
+// Points either into `RegistrySnapshot` or into memory-mapped file.
+struct SnapshotSectionView
+{
+  // `TypeMetaRegistrator<Component>::id()`
+  uint64_t typeId = 0;
+
+  // `TypeMetaRegistrator<Component>::name()`
+  ::base::StringPiece name;
+
+  // Size of one row in data column.
+  // Zero for empty types (tags) and for section with entities.
+  uint32_t elementSize = 0;
+
+  // Number of rows.
+  uint32_t count = 0;
+
+  const SnapshotEntityValue* entities = nullptr;
+
+  const uint8_t* data = nullptr;
+};
+
+// Snapshot of registry stored in memory (columns are copied from pools).
+//
+// Made on sequence of registry (see `captureRegistrySnapshot`),
+// so it can be written to file on any thread
+// without access to registry.
+class RegistrySnapshot
+{
+ public:
+  struct Section
+  {
+    uint64_t typeId = 0;
+
+    std::string name;
+
+    uint32_t elementSize = 0;
+
+    std::vector<SnapshotEntityValue> entities;
+
+    std::vector<uint8_t> data;
+  };
+
+  RegistrySnapshot();
+
+  RegistrySnapshot(RegistrySnapshot&& other);
+
+  RegistrySnapshot& operator=(RegistrySnapshot&& other);
+
+  ~RegistrySnapshot();
+
+  Section& addSection(
+    uint64_t typeId
+    , const std::string& name
+    , uint32_t elementSize);
+
+  const std::vector<Section>& sections() const
+  {
+    return sections_;
+  }
+
+  // Total size of columns in bytes (without file headers).
+  MUST_USE_RETURN_VALUE
+  size_t payloadSize() const;
+
+ private:
+  std::vector<Section> sections_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegistrySnapshot);
+};
+
+// Writes snapshot to file (section-by-section).
+//
+// File is written into temporary file in same directory
+// and then renamed, so `path` always contains complete snapshot
+// (old or new one).
+//
+/// \note performs blocking I/O, so call it on task runner with
+/// `base::MayBlock()` trait.
+MUST_USE_RETURN_VALUE
+bool writeRegistrySnapshotToFile(
+  const ::base::FilePath& path
+  , const RegistrySnapshot& snapshot);
+
+// Reads snapshot either from memory-mapped file or from `RegistrySnapshot`
+// (without copies of columns).
+class RegistrySnapshotReader
+{
+ public:
+  RegistrySnapshotReader();
+
+  ~RegistrySnapshotReader();
+
+  // Maps file into memory and validates section table.
+  /// \note performs blocking I/O
+  MUST_USE_RETURN_VALUE
+  bool initialize(const ::base::FilePath& path);
+
+  // `snapshot` must outlive reader.
+  MUST_USE_RETURN_VALUE
+  bool initialize(const RegistrySnapshot& snapshot);
+
+  // Returns section that stores all entities of registry.
+  MUST_USE_RETURN_VALUE
+  const SnapshotSectionView* entitiesSection() const;
+
+  // Returns `nullptr` if section not found.
+  MUST_USE_RETURN_VALUE
+  const SnapshotSectionView* findSection(uint64_t typeId) const;
+
+  const std::vector<SnapshotSectionView>& sections() const
+  {
+    return sections_;
+  }
+
+ private:
+  bool parseMappedFile();
+
+ private:
+  std::unique_ptr<::base::MemoryMappedFile> mappedFile_;
+
+  std::vector<SnapshotSectionView> sections_;
+
+  DISALLOW_COPY_AND_ASSIGN(RegistrySnapshotReader);
+};
+
+namespace registry_snapshot_internal {
+
+// Type id used by section that stores all entities of registry.
+constexpr uint64_t kEntitiesTypeId = 0;
+
+extern const char kEntitiesSectionName[];
+
+// Archive for `entt::basic_snapshot` that appends rows
+// to columns of `RegistrySnapshot::Section`.
+class OutputArchive
+{
+ public:
+  explicit OutputArchive(RegistrySnapshot::Section* section)
+    : section_(section)
+  {
+    DCHECK(section_);
+  }
+
+  // Called before rows with total number of rows.
+  void operator()(SnapshotEntityValue count)
+  {
+    section_->entities.reserve(count);
+    section_->data.reserve(
+      static_cast<size_t>(count) * section_->elementSize);
+  }
+
+  // Called for entities and for empty types (tags).
+  void operator()(ECS::Entity entityId)
+  {
+    DCHECK_EQ(section_->elementSize, 0u);
+    section_->entities.push_back(
+      static_cast<SnapshotEntityValue>(entityId));
+  }
+
+  template <typename Component>
+  void operator()(ECS::Entity entityId, const Component& component)
+  {
+    using Codec = SnapshotCodec<Component>;
+
+    DCHECK_EQ(section_->elementSize, Codec::kSize);
+    section_->entities.push_back(
+      static_cast<SnapshotEntityValue>(entityId));
+    const size_t offset = section_->data.size();
+    section_->data.resize(offset + Codec::kSize);
+    Codec::encode(component, section_->data.data() + offset);
+  }
+
+ private:
+  RegistrySnapshot::Section* section_;
+
+  DISALLOW_COPY_AND_ASSIGN(OutputArchive);
+};
+
+// Archive for `entt::basic_snapshot_loader` that reads rows
+// from columns of `SnapshotSectionView`.
+class InputArchive
+{
+ public:
+  explicit InputArchive(const SnapshotSectionView& section)
+    : section_(section)
+  {}
+
+  void operator()(SnapshotEntityValue& count)
+  {
+    count = section_.count;
+  }
+
+  void operator()(ECS::Entity& entityId)
+  {
+    CHECK_LT(pos_, section_.count);
+    entityId = ECS::Entity{section_.entities[pos_]};
+    ++pos_;
+  }
+
+  template <typename Component>
+  void operator()(ECS::Entity& entityId, Component& component)
+  {
+    using Codec = SnapshotCodec<Component>;
+
+    CHECK_LT(pos_, section_.count);
+    CHECK_EQ(section_.elementSize, Codec::kSize);
+    entityId = ECS::Entity{section_.entities[pos_]};
+    Codec::decode(
+      section_.data + static_cast<size_t>(pos_) * Codec::kSize
+      , component);
+    ++pos_;
+  }
+
+  bool isFullyRead() const
+  {
+    return pos_ == section_.count;
+  }
+
+ private:
+  const SnapshotSectionView& section_;
+
+  uint32_t pos_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(InputArchive);
+};
+
+template <typename Component>
+constexpr uint32_t snapshotElementSize()
+{
+  if constexpr (std::is_empty<Component>::value)
+  {
+    return 0;
+  }
+  else
+  {
+    return SnapshotCodec<Component>::kSize;
+  }
+}
+
+template <typename Component>
+void captureSection(
+  const ECS::Registry& registry
+  , RegistrySnapshot& snapshot)
+{
+  using Meta = ECS::TypeMetaRegistrator<Component>;
+
+  RegistrySnapshot::Section& section
+    = snapshot.addSection(Meta::id()
+      , Meta::name()
+      , snapshotElementSize<Component>());
+
+  OutputArchive archive(&section);
+  entt::basic_snapshot<ECS::Entity>{registry}
+    .template component<Component>(archive);
+}
+
+template <typename Component>
+MUST_USE_RETURN_VALUE
+bool loadSection(
+  const RegistrySnapshotReader& reader
+  , const entt::basic_snapshot_loader<ECS::Entity>& loader)
+{
+  using Meta = ECS::TypeMetaRegistrator<Component>;
+
+  const SnapshotSectionView* section
+    = reader.findSection(Meta::id());
+
+  // component was not stored in snapshot
+  if(!section)
+  {
+    DVLOG(9)
+      << "no section in snapshot for component: "
+      << Meta::name();
+    return true;
+  }
+
+  if(section->elementSize != snapshotElementSize<Component>())
+  {
+    LOG(ERROR)
+      << "unexpected size of component: "
+      << Meta::name()
+      << " in snapshot section: "
+      << section->name;
+    return false;
+  }
+
+  InputArchive archive(*section);
+  loader.template component<Component>(archive);
+  DCHECK(archive.isFullyRead());
+  return true;
+}
+
+} // namespace registry_snapshot_internal
+
+// Copies entities and components of registry into `RegistrySnapshot`.
+//
+// Each component must be registered using `ECS_DECLARE_METATYPE`
+// (section is identified by `TypeMetaRegistrator<Component>::id()`).
+//
+/// \note call it on sequence of registry,
+/// but prefer to write snapshot to file on another sequence
+/// (see `writeRegistrySnapshotAsync`).
+/// \note it is one linear pass over each pool,
+/// that usually is much faster than file I/O.
+template <typename... Components>
+MUST_USE_RETURN_VALUE
+RegistrySnapshot captureRegistrySnapshot(
+  const ECS::Registry& registry)
+{
+  RegistrySnapshot snapshot;
+
+  {
+    RegistrySnapshot::Section& section
+      = snapshot.addSection(registry_snapshot_internal::kEntitiesTypeId
+        , registry_snapshot_internal::kEntitiesSectionName
+        , 0);
+
+    registry_snapshot_internal::OutputArchive archive(&section);
+    entt::basic_snapshot<ECS::Entity>{registry}.entities(archive);
+  }
+
+  (registry_snapshot_internal::captureSection<Components>(
+    registry, snapshot), ...);
+
+  return snapshot;
+}
+
+// Restores entities and components into empty `registry`.
+//
+// Sections are found by type id, so order of `Components`
+// may differ from order used by `captureRegistrySnapshot`.
+// Components without section in snapshot are skipped.
+//
+/// \note Entity identifiers are preserved, so use
+/// `validateRelationships` to check hierarchies after restore.
+/// \note All entities alive in snapshot are restored,
+/// including entities without components listed in `Components`
+/// (so identifiers stored inside of components stay valid).
+template <typename... Components>
+MUST_USE_RETURN_VALUE
+bool loadRegistrySnapshot(
+  const RegistrySnapshotReader& reader
+  , ECS::Registry& registry)
+{
+  DCHECK(registry.empty());
+
+  const SnapshotSectionView* entitiesSection
+    = reader.entitiesSection();
+
+  if(!entitiesSection)
+  {
+    LOG(ERROR)
+      << "snapshot without entities";
+    return false;
+  }
+
+  entt::basic_snapshot_loader<ECS::Entity> loader{registry};
+
+  {
+    registry_snapshot_internal::InputArchive archive(*entitiesSection);
+    loader.entities(archive);
+    DCHECK(archive.isFullyRead());
+  }
+
+  bool ok = true;
+
+  ((ok = ok
+    && registry_snapshot_internal::loadSection<Components>(reader, loader))
+    , ...);
+
+  /// \note `loader.orphans()` is not called: entity without listed
+  /// components may be referenced by other entity
+  /// (for example, parent that has only unlisted components).
+
+  return ok;
+}
+
+// Writes `snapshot` on `base::ThreadPool`.
+// `doneCallback` called on current sequence.
+void postRegistrySnapshotWrite(
+  const ::base::FilePath& path
+  , RegistrySnapshot snapshot
+  , ::base::OnceCallback<void(bool)> doneCallback);
+
+// Captures snapshot on sequence of `registry`
+// and writes it on `base::ThreadPool` (with `base::MayBlock()` trait).
+//
+// `doneCallback` called on sequence of `registry`.
+template <typename... Components>
+void writeRegistrySnapshotAsync(
+  ECS::SafeRegistry& registry
+  , const ::base::FilePath& path
+  , ::base::OnceCallback<void(bool)> doneCallback)
+{
+  DCHECK_RUN_ON_REGISTRY(&registry);
+
+  postRegistrySnapshotWrite(path
+    , captureRegistrySnapshot<Components...>(*registry)
+    , RVALUE_CAST(doneCallback));
+}
+
+} // namespace ECS
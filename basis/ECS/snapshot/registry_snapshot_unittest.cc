@@ -0,0 +1,238 @@
+#include "basis/ECS/snapshot/registry_snapshot.h"
+
+#include <basis/ECS/helpers/relationship/prepend_child_entity.h>
+#include <basis/ECS/helpers/relationship/validate_relationships.h>
+
+#include <base/files/file_path.h>
+#include <base/files/file_util.h>
+#include <base/files/scoped_temp_dir.h>
+#include <base/logging.h>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+struct SnapshotTestPosition
+{
+  int32_t x;
+  int32_t y;
+};
+
+CREATE_ECS_TAG(SnapshotTestMarker);
+
+class SnapshotTestTag{};
+
+using ParentComponent = ECS::ParentEntity<SnapshotTestTag>;
+using ChildrenComponent = ECS::ChildSiblings<SnapshotTestTag>;
+using FirstChildComponent = ECS::FirstChildInLinkedList<SnapshotTestTag>;
+using ChildrenSizeComponent
+  = ECS::TopLevelChildrenCount<SnapshotTestTag, size_t>;
+
+} // namespace
+
+ECS_DECLARE_METATYPE(SnapshotTestPosition);
+ECS_DEFINE_METATYPE(SnapshotTestPosition);
+ECS_DECLARE_METATYPE(SnapshotTestMarker);
+ECS_DEFINE_METATYPE(SnapshotTestMarker);
+ECS_DEFINE_METATYPE_TEMPLATE(ParentComponent);
+ECS_DEFINE_METATYPE_TEMPLATE(ChildrenComponent);
+ECS_DEFINE_METATYPE_TEMPLATE(FirstChildComponent);
+ECS_DEFINE_METATYPE_TEMPLATE(ChildrenSizeComponent);
+
+namespace ECS {
+
+namespace {
+
+#define SNAPSHOT_TEST_COMPONENTS \
+  SnapshotTestPosition \
+  , SnapshotTestMarker \
+  , ParentComponent \
+  , ChildrenComponent \
+  , FirstChildComponent \
+  , ChildrenSizeComponent
+
+struct TestHierarchy
+{
+  ECS::Entity parentId;
+  std::vector<ECS::Entity> childIds;
+};
+
+TestHierarchy populateRegistry(ECS::Registry& registry)
+{
+  TestHierarchy result;
+
+  // destroyed entity must not break restored identifiers
+  registry.destroy(registry.create());
+
+  result.parentId = registry.create();
+  registry.emplace<SnapshotTestPosition>(result.parentId, 1, 2);
+  registry.emplace<SnapshotTestMarker>(result.parentId);
+
+  for(int32_t i = 0; i < 3; ++i)
+  {
+    ECS::Entity childId = registry.create();
+    registry.emplace<SnapshotTestPosition>(childId, i, -i);
+    ECS::prependChildEntity<SnapshotTestTag>(
+      REFERENCED(registry)
+      , result.parentId
+      , childId);
+    result.childIds.push_back(childId);
+  }
+
+  return result;
+}
+
+void expectRestored(
+  const ECS::Registry& registry
+  , const TestHierarchy& hierarchy)
+{
+  EXPECT_TRUE(validateRelationships<SnapshotTestTag>(registry));
+
+  ASSERT_TRUE(registry.valid(hierarchy.parentId));
+  EXPECT_TRUE(registry.has<SnapshotTestMarker>(hierarchy.parentId));
+  EXPECT_EQ(registry.get<SnapshotTestPosition>(hierarchy.parentId).y, 2);
+  EXPECT_EQ(registry.get<ChildrenSizeComponent>(hierarchy.parentId).size
+    , hierarchy.childIds.size());
+  // children are prepended
+  EXPECT_EQ(registry.get<FirstChildComponent>(hierarchy.parentId).firstId
+    , hierarchy.childIds.back());
+
+  for(size_t i = 0; i < hierarchy.childIds.size(); ++i)
+  {
+    const ECS::Entity childId = hierarchy.childIds[i];
+    ASSERT_TRUE(registry.valid(childId));
+    EXPECT_EQ(registry.get<ParentComponent>(childId).parentId
+      , hierarchy.parentId);
+    EXPECT_EQ(registry.get<SnapshotTestPosition>(childId).x
+      , static_cast<int32_t>(i));
+    EXPECT_FALSE(registry.has<SnapshotTestMarker>(childId));
+  }
+}
+
+} // namespace
+
+TEST(RegistrySnapshotTest, RestoreFromMemory)
+{
+  ECS::Registry registry;
+  const TestHierarchy hierarchy = populateRegistry(registry);
+  ASSERT_TRUE(validateRelationships<SnapshotTestTag>(registry));
+
+  RegistrySnapshot snapshot
+    = captureRegistrySnapshot<SNAPSHOT_TEST_COMPONENTS>(registry);
+  EXPECT_GT(snapshot.payloadSize(), 0u);
+
+  RegistrySnapshotReader reader;
+  ASSERT_TRUE(reader.initialize(snapshot));
+
+  ECS::Registry restored;
+  ASSERT_TRUE(
+    (loadRegistrySnapshot<SNAPSHOT_TEST_COMPONENTS>(reader, restored)));
+
+  expectRestored(restored, hierarchy);
+}
+
+TEST(RegistrySnapshotTest, RestoreFromFile)
+{
+  ::base::ScopedTempDir tempDir;
+  ASSERT_TRUE(tempDir.CreateUniqueTempDir());
+  const ::base::FilePath path
+    = tempDir.GetPath().AppendASCII("registry.snapshot");
+
+  ECS::Registry registry;
+  const TestHierarchy hierarchy = populateRegistry(registry);
+
+  ASSERT_TRUE(writeRegistrySnapshotToFile(path
+    , captureRegistrySnapshot<SNAPSHOT_TEST_COMPONENTS>(registry)));
+  EXPECT_FALSE(::base::PathExists(
+    path.AddExtension(FILE_PATH_LITERAL("tmp"))));
+
+  RegistrySnapshotReader reader;
+  ASSERT_TRUE(reader.initialize(path));
+
+  // Order of components may differ from order used by snapshot.
+  ECS::Registry restored;
+  ASSERT_TRUE(
+    (loadRegistrySnapshot<
+      ChildrenSizeComponent
+      , FirstChildComponent
+      , ChildrenComponent
+      , ParentComponent
+      , SnapshotTestMarker
+      , SnapshotTestPosition
+    >(reader, restored)));
+
+  expectRestored(restored, hierarchy);
+}
+
+TEST(RegistrySnapshotTest, RejectsCorruptedFile)
+{
+  ::base::ScopedTempDir tempDir;
+  ASSERT_TRUE(tempDir.CreateUniqueTempDir());
+  const ::base::FilePath path
+    = tempDir.GetPath().AppendASCII("registry.snapshot");
+
+  ECS::Registry registry;
+  ignore_result(populateRegistry(registry));
+
+  ASSERT_TRUE(writeRegistrySnapshotToFile(path
+    , captureRegistrySnapshot<SNAPSHOT_TEST_COMPONENTS>(registry)));
+
+  std::string contents;
+  ASSERT_TRUE(::base::ReadFileToString(path, &contents));
+  // truncated file
+  contents.resize(contents.size() / 2);
+  ASSERT_EQ(::base::WriteFile(path, contents.data(), contents.size())
+    , static_cast<int>(contents.size()));
+
+  RegistrySnapshotReader reader;
+  EXPECT_FALSE(reader.initialize(path));
+}
+
+TEST(RegistrySnapshotTest, KeepsEntitiesWithoutListedComponents)
+{
+  ECS::Registry registry;
+  const TestHierarchy hierarchy = populateRegistry(registry);
+
+  // parent has only components that are not restored
+  RegistrySnapshot snapshot
+    = captureRegistrySnapshot<
+        SnapshotTestPosition
+        , ParentComponent
+      >(registry);
+
+  RegistrySnapshotReader reader;
+  ASSERT_TRUE(reader.initialize(snapshot));
+
+  ECS::Registry restored;
+  ASSERT_TRUE(
+    (loadRegistrySnapshot<ParentComponent>(reader, restored)));
+
+  // referenced by `ParentComponent` of children
+  EXPECT_TRUE(restored.valid(hierarchy.parentId));
+  EXPECT_TRUE(restored.orphan(hierarchy.parentId));
+
+  for(const ECS::Entity childId: hierarchy.childIds)
+  {
+    ASSERT_TRUE(restored.valid(childId));
+    EXPECT_TRUE(restored.valid(
+      restored.get<ParentComponent>(childId).parentId));
+  }
+}
+
+TEST(RegistrySnapshotTest, DetectsBrokenRelationships)
+{
+  ECS::Registry registry;
+  const TestHierarchy hierarchy = populateRegistry(registry);
+  ASSERT_TRUE(validateRelationships<SnapshotTestTag>(registry));
+
+  // child that points to wrong sibling
+  registry.get<ChildrenComponent>(hierarchy.childIds.front()).prevId
+    = hierarchy.parentId;
+
+  EXPECT_FALSE(validateRelationships<SnapshotTestTag>(registry));
+}
+
+} // namespace ECS
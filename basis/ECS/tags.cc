@@ -7,3 +7,5 @@ ECS_DEFINE_METATYPE(NeedToDestroyTag)
 ECS_DEFINE_METATYPE(DelayedConstruction)
 
 ECS_DEFINE_METATYPE(DelayedConstructionJustDone)
+
+ECS_DEFINE_METATYPE(LiveTag)
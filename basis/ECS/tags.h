@@ -49,6 +49,16 @@ CREATE_ECS_TAG(DelayedConstruction)
 // (i.e. marks for 1 tick entity that was filled with required components).
 CREATE_ECS_TAG(DelayedConstructionJustDone)
 
+// Marks constructed entity that is not scheduled for destruction
+// and not stored in memory pool (i.e. entity that can be updated).
+//
+// All live entities are stored in one packed set (pool of `LiveTag`),
+// so hot systems can iterate `view<LiveTag, ...>` instead of excluding
+// `NeedToDestroyTag`, `DelayedConstruction` and `UnusedTag`
+// (one membership test instead of three).
+/// \see `ECS::viewLive`, `ECS::markLive`, `ECS::markNotLive`
+CREATE_ECS_TAG(LiveTag)
+
 } // namespace ECS
 
 ECS_DECLARE_METATYPE(UnusedTag)
@@ -58,3 +68,5 @@ ECS_DECLARE_METATYPE(NeedToDestroyTag)
 ECS_DECLARE_METATYPE(DelayedConstruction)
 
 ECS_DECLARE_METATYPE(DelayedConstructionJustDone)
+
+ECS_DECLARE_METATYPE(LiveTag)
@@ -10,6 +10,8 @@
 
 #include <memory>
 
+#include "basis/memory/scoped_memory_dump_provider.h"
+
 namespace ECS {
 
 UnsafeTypeContext::UnsafeTypeContext()
@@ -18,4 +20,23 @@ UnsafeTypeContext::UnsafeTypeContext()
 UnsafeTypeContext::~UnsafeTypeContext()
 {}
 
+void UnsafeTypeContext::dumpMemoryStats(
+  const std::string& dumpName
+  , ::base::trace_event::ProcessMemoryDump* pmd) const
+{
+  DFAKE_SCOPED_RECURSIVE_LOCK(debug_thread_collision_warner_);
+
+  size_t sizeInBytes
+    = vars_.capacity() * sizeof(variable_data);
+
+  for(const variable_data& var: vars_) {
+    sizeInBytes += var.size_bytes;
+  }
+
+  ::basis::addAllocatorDump(pmd
+    , dumpName
+    , sizeInBytes
+    , vars_.size());
+}
+
 } // namespace ECS
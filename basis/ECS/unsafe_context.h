@@ -34,6 +34,10 @@ namespace base {
 
 class SingleThreadTaskRunner;
 
+namespace trace_event {
+class ProcessMemoryDump;
+} // namespace trace_event
+
 template <typename T>
 struct DefaultSingletonTraits;
 
@@ -105,6 +109,8 @@ class UnsafeTypeContext
   struct variable_data {
     idType type_id;
     std::unique_ptr<void, void(*)(void *)> value;
+    // `sizeof` of stored object, used by memory dumps
+    size_t size_bytes;
 #if DCHECK_IS_ON()
     std::string debug_name;
 #endif // DCHECK_IS_ON()
@@ -139,6 +145,7 @@ class UnsafeTypeContext
                 delete static_cast<Type*>(instance);
               }
           }
+        , sizeof(Type)
 #if DCHECK_IS_ON()
         , debug_name
 #endif // DCHECK_IS_ON()
@@ -393,6 +400,14 @@ class UnsafeTypeContext
     return vars_.empty();
   }
 
+  // Adds allocator dump `dumpName` (storage of variables
+  // and shallow size of stored objects) to `pmd`.
+  /// \note does not include heap memory owned by stored objects.
+  /// \see `::basis::ScopedMemoryDumpProvider`
+  void dumpMemoryStats(
+    const std::string& dumpName
+    , ::base::trace_event::ProcessMemoryDump* pmd) const;
+
  private:
   // per-sequence counter for thread-safety reasons
   idType typeCounter_{};
@@ -0,0 +1,58 @@
+#include "basis/ECS/unsafe_context.h"
+
+#include <string>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+namespace ECS {
+
+namespace {
+
+template <size_t Index>
+struct ContextVar {
+  size_t value = Index;
+};
+
+template <size_t... Indices>
+void setVars(UnsafeTypeContext& context, std::index_sequence<Indices...>) {
+  (context.set_var<ContextVar<Indices>>(
+    "ContextVar" + std::to_string(Indices)), ...);
+}
+
+// Lookup cost grows with number of stored variables
+// (`UnsafeTypeContext` performs linear search),
+// so measure lookup of first and last inserted variable.
+template <size_t VarsCount>
+void BM_UnsafeTypeContextLookup(benchmark::State& state) {
+  UnsafeTypeContext context;
+  setVars(context, std::make_index_sequence<VarsCount>{});
+
+  for (auto _ : state) {
+    ContextVar<0>* first = context.try_ctx_var<ContextVar<0>>();
+    ContextVar<VarsCount - 1>* last
+      = context.try_ctx_var<ContextVar<VarsCount - 1>>();
+    benchmark::DoNotOptimize(first);
+    benchmark::DoNotOptimize(last);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK_TEMPLATE(BM_UnsafeTypeContextLookup, 1);
+BENCHMARK_TEMPLATE(BM_UnsafeTypeContextLookup, 8);
+BENCHMARK_TEMPLATE(BM_UnsafeTypeContextLookup, 32);
+
+void BM_UnsafeTypeContextLookupMissing(benchmark::State& state) {
+  UnsafeTypeContext context;
+  setVars(context, std::make_index_sequence<32>{});
+
+  for (auto _ : state) {
+    ContextVar<1000>* missing = context.try_ctx_var<ContextVar<1000>>();
+    benchmark::DoNotOptimize(missing);
+  }
+}
+BENCHMARK(BM_UnsafeTypeContextLookupMissing);
+
+}  // namespace
+
+}  // namespace ECS
@@ -1,7 +1,5 @@
 #include "basis/annotations/asio_guard_annotations.h" // IWYU pragma: associated
 
-using namespace base;
+namespace basis {
 
-namespace basic {
-
-} // namespace basic
+} // namespace basis
@@ -2,6 +2,8 @@
 
 #include "basic/annotations/guard_annotations.h"
 
+#include <base/logging.h>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/asio.hpp>
 
@@ -69,8 +71,19 @@ class SCOPED_LOCKABLE StrandCheckerScope {
 // DCHECK_RUN_ON_STRAND(&perConnectionStrand_, ExecutorType);
 //
 #define DCHECK_RUN_ON_STRAND(x, Type)                                              \
-  ::basic::StrandCheckerScope strand_check_scope(x); \
+  ::basis::StrandCheckerScope strand_check_scope(x); \
   DCHECK((x)); \
   DCHECK((x)->data.running_in_this_thread())
 
+// Same as `DCHECK_RUN_ON_STRAND`, but check is performed
+// in all builds (including release).
+//
+/// \note `running_in_this_thread()` is cheap
+/// (it searches current thread call stack of strand implementation),
+/// but prefer `DCHECK_RUN_ON_STRAND` in hot code paths.
+#define CHECK_RUN_ON_STRAND(x, Type)                                               \
+  ::basis::StrandCheckerScope strand_check_scope(x); \
+  CHECK((x)); \
+  CHECK((x)->data.running_in_this_thread())
+
 } // namespace basis
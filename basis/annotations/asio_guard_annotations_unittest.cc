@@ -44,4 +44,22 @@ TEST(GuardAnnotationsTest, AnnotatedType) {
   EXPECT_EQ((*annotated), value);
 }
 
+TEST(GuardAnnotationsTest, CheckRunOnStrand) {
+  using ExecutorType = ::boost::asio::io_context::executor_type;
+
+  ::boost::asio::io_context ioc;
+  AnnotatedStrand<ExecutorType> strand(ioc.get_executor());
+
+  EXPECT_FALSE(strand.data.running_in_this_thread());
+
+  bool handler_called = false;
+  ::boost::asio::post(strand.data, [&strand, &handler_called]() {
+    CHECK_RUN_ON_STRAND(&strand, ExecutorType);
+    handler_called = true;
+  });
+  ioc.run();
+
+  EXPECT_TRUE(handler_called);
+}
+
 }  // namespace basis
@@ -0,0 +1,99 @@
+#include "basis/checked_optional.h" // IWYU pragma: associated
+
+#include <base/feature_list.h>
+#include <base/logging.h>
+#include <base/location.h>
+#include <base/metrics/field_trial_params.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace basis {
+
+namespace {
+
+// Default N for `CheckedOptionalPolicy::Sampled*`
+static constexpr int kDefaultSamplingRate = 64;
+
+// Means that `kCheckedOptionalSamplingRate` was not read yet.
+static constexpr int kSamplingRateNotCached = -1;
+
+std::atomic<int> g_cached_sampling_rate{kSamplingRateNotCached};
+
+std::atomic<uint64_t> g_violation_count{0};
+
+} // namespace
+
+const ::base::Feature kCheckedOptionalSampling{
+  "CheckedOptionalSampling", ::base::FEATURE_ENABLED_BY_DEFAULT};
+
+const ::base::FeatureParam<int> kCheckedOptionalSamplingRate{
+  &kCheckedOptionalSampling, "sampling_rate", kDefaultSamplingRate};
+
+int checkedOptionalSamplingRate() NO_EXCEPTION
+{
+  const int cached
+    = g_cached_sampling_rate.load(std::memory_order_relaxed);
+  if(LIKELY(cached != kSamplingRateNotCached))
+  {
+    return cached;
+  }
+
+  // Can not read feature params before `base::FeatureList` initialization,
+  // so do not cache default value.
+  if(!::base::FeatureList::GetInstance())
+  {
+    return kDefaultSamplingRate;
+  }
+
+  const int rate
+    = ::base::FeatureList::IsEnabled(kCheckedOptionalSampling)
+      ? std::max(0, kCheckedOptionalSamplingRate.Get())
+      : 0;
+
+  g_cached_sampling_rate.store(rate, std::memory_order_relaxed);
+
+  return rate;
+}
+
+void resetCheckedOptionalSamplingRateForTesting() NO_EXCEPTION
+{
+  g_cached_sampling_rate.store(kSamplingRateNotCached
+    , std::memory_order_relaxed);
+}
+
+uint64_t checkedOptionalViolationCount() NO_EXCEPTION
+{
+  return g_violation_count.load(std::memory_order_relaxed);
+}
+
+namespace internal {
+
+void reportCheckedOptionalViolation(
+  const ::base::Location& from_here
+  , bool verifier_passed
+  , bool has_permission) NO_EXCEPTION
+{
+  const uint64_t total
+    = g_violation_count.fetch_add(1, std::memory_order_relaxed) + 1;
+
+  // Avoid log spam in production: log first violations
+  // and then only each power of two.
+  if(total > 16 && (total & (total - 1)) != 0)
+  {
+    return;
+  }
+
+  LOG(ERROR)
+    << "CheckedOptional sampled verification failed at "
+    << from_here.ToString()
+    << (verifier_passed ? "" : " (verifier callback returned false)")
+    << (has_permission ? "" : " (no permission)")
+    << ", total violations: "
+    << total;
+}
+
+} // namespace internal
+
+} // namespace basis
@@ -14,12 +14,18 @@
 #include <base/strings/string_piece.h>
 #include <base/threading/thread_collision_warner.h>
 #include <base/macros.h>
+#include <base/compiler_specific.h>
+#include <base/feature_list.h>
+#include <base/metrics/field_trial_params.h>
 
 #include <basic/macros.h>
 #include <basic/rvalue_cast.h>
 #include "basic/bind/verify_nothing.h"
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <map>
 #include <string>
 
@@ -65,8 +71,91 @@ enum class CheckedOptionalPolicy {
   , DebugOnly
   // Can be used to implement custom verification logic
   , Skip
+  // Will call `verifier_callback_.Run()` on 1-in-N accesses
+  // (counted per `CheckedOptional` instance) in any builds.
+  // N is configurable at runtime (see `kCheckedOptionalSampling`).
+  // Failed verification does not crash, it is logged and counted
+  // (see `checkedOptionalViolationCount`).
+  , Sampled
+  // Same as `Sampled`, but accesses are counted per thread
+  // (shared between all `CheckedOptional` instances).
+  // Prefer it if you have many short-lived instances.
+  , SampledPerThread
 };
 
+constexpr bool isSampledCheckedOptionalPolicy(
+  const CheckedOptionalPolicy policy)
+{
+  return policy == CheckedOptionalPolicy::Sampled
+    || policy == CheckedOptionalPolicy::SampledPerThread;
+}
+
+// Controls `CheckedOptionalPolicy::Sampled*`.
+// If disabled, then sampled verification is not performed at all.
+extern const ::base::Feature kCheckedOptionalSampling;
+
+// Verifier will run on 1-in-N accesses where N is value of this param.
+// Usage example:
+// --enable-features=CheckedOptionalSampling:sampling_rate/128
+extern const ::base::FeatureParam<int> kCheckedOptionalSamplingRate;
+
+// Returns N for `CheckedOptionalPolicy::Sampled*`
+// (zero means that sampled verification is disabled).
+//
+/// \note Result is cached after `base::FeatureList` initialization,
+/// so it is cheap to call.
+int checkedOptionalSamplingRate() NO_EXCEPTION;
+
+// Resets cached value of `checkedOptionalSamplingRate`.
+void resetCheckedOptionalSamplingRateForTesting() NO_EXCEPTION;
+
+// Total number of failed sampled verifications (in all instances).
+uint64_t checkedOptionalViolationCount() NO_EXCEPTION;
+
+namespace internal {
+
+// Logs and counts failed sampled verification.
+NOINLINE
+void reportCheckedOptionalViolation(
+  const ::base::Location& from_here
+  , bool verifier_passed
+  , bool has_permission) NO_EXCEPTION;
+
+// Countdown until next sampled access.
+// Returns true (and restarts countdown) if access must be verified.
+template<typename CounterType>
+ALWAYS_INLINE
+bool decrementSamplingCountdown(CounterType& countdown) NO_EXCEPTION
+{
+  if(LIKELY(countdown > 1))
+  {
+    --countdown;
+    return false;
+  }
+
+  const int rate = checkedOptionalSamplingRate();
+
+  // Disabled sampling, check again after many accesses
+  // (rate may change after `base::FeatureList` initialization).
+  if(rate <= 0)
+  {
+    countdown = std::numeric_limits<uint16_t>::max();
+    return false;
+  }
+
+  countdown = static_cast<uint32_t>(rate);
+  return true;
+}
+
+ALWAYS_INLINE
+bool shouldSampleOnCurrentThread() NO_EXCEPTION
+{
+  static thread_local uint32_t countdown = 0;
+  return decrementSamplingCountdown(countdown);
+}
+
+} // namespace internal
+
 // Used to verify that each access to underlying type
 // is protected by conditional function.
 //
@@ -240,6 +329,10 @@ public:
       DCHECK(hasReadPermission())
         << FROM_HERE.ToString();
     }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(FROM_HERE, hasReadPermission());
+    }
 
     return optional_unsafe(FROM_HERE, "");
   }
@@ -262,6 +355,10 @@ public:
       DCHECK(hasReadPermission())
         << FROM_HERE.ToString();
     }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(FROM_HERE, hasReadPermission());
+    }
 
     return optional_unsafe(FROM_HERE, "");
   }
@@ -319,6 +416,10 @@ public:
       DCHECK(value_.has_value())
         << FROM_HERE.ToString();
     }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(FROM_HERE, hasReadPermission());
+    }
 
     return value_unsafe(FROM_HERE, "");
   }
@@ -345,6 +446,10 @@ public:
       DCHECK(value_.has_value())
         << FROM_HERE.ToString();
     }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(FROM_HERE, hasReadPermission());
+    }
 
     return value_unsafe(FROM_HERE, "");
   }
@@ -401,6 +506,10 @@ public:
       DCHECK(value_.has_value())
         << FROM_HERE.ToString();
     }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(FROM_HERE, hasReadPermission());
+    }
 
     return value_.operator*();
   }
@@ -429,6 +538,10 @@ public:
       DCHECK(value_.has_value())
         << FROM_HERE.ToString();
     }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(FROM_HERE, hasReadPermission());
+    }
 
     return value_.operator*();
   }
@@ -457,6 +570,10 @@ public:
       DCHECK(value_.has_value())
         << FROM_HERE.ToString();
     }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(FROM_HERE, hasReadPermission());
+    }
 
     return value_.operator->();
   }
@@ -485,6 +602,10 @@ public:
       DCHECK(value_.has_value())
         << FROM_HERE.ToString();
     }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(FROM_HERE, hasReadPermission());
+    }
 
     return value_.operator->();
   }
@@ -516,6 +637,10 @@ public:
       DCHECK(hasModifyPermission())
         << from_here.ToString();
     }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(from_here, hasModifyPermission());
+    }
 
     return value_.emplace(FORWARD(args)...);
   }
@@ -562,6 +687,10 @@ public:
       DCHECK(hasModifyPermission())
         << FROM_HERE.ToString();
     }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(FROM_HERE, hasModifyPermission());
+    }
 
     value_.reset();
   }
@@ -668,6 +797,42 @@ public:
     return !(*this == &that);
   }
 
+private:
+  // Used by `CheckedOptionalPolicy::Sampled*`
+  ALWAYS_INLINE
+  void runSampledVerifier(
+    const ::base::Location& from_here
+    , bool has_permission) const NO_EXCEPTION
+  {
+    bool need_verify = false;
+    if constexpr (VerifyPolicyType == CheckedOptionalPolicy::Sampled)
+    {
+      // Relaxed access is enough: approximate counting is ok here
+      // (`CheckedOptional` may be used from wrong thread,
+      // we are trying to detect it).
+      uint32_t countdown
+        = sampling_countdown_.load(std::memory_order_relaxed);
+      need_verify = ::basis::internal::decrementSamplingCountdown(countdown);
+      sampling_countdown_.store(countdown, std::memory_order_relaxed);
+    }
+    else
+    {
+      need_verify = ::basis::internal::shouldSampleOnCurrentThread();
+    }
+
+    if(LIKELY(!need_verify))
+    {
+      return;
+    }
+
+    const bool verifier_passed = runVerifierCallback();
+    if(UNLIKELY(!verifier_passed || !has_permission))
+    {
+      ::basis::internal::reportCheckedOptionalViolation(
+        from_here, verifier_passed, has_permission);
+    }
+  }
+
 private:
   VerifierCb verifier_callback_;
 
@@ -691,6 +856,9 @@ private:
   // concurrently.
   DFAKE_MUTEX(debug_thread_collision_warner_);
 
+  // Used only by `CheckedOptionalPolicy::Sampled`
+  mutable std::atomic<uint32_t> sampling_countdown_{0};
+
   // check sequence on which class was constructed/destructed/configured
   SEQUENCE_CHECKER(sequence_checker_);
 
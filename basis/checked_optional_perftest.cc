@@ -0,0 +1,145 @@
+#include "basis/checked_optional.h"
+#include "basis/static_checked_optional.h"
+
+#include "base/optional.h"
+#include "base/sequence_token.h"
+#include "base/threading/scoped_set_sequence_token_for_current_thread.h"
+
+#include "base/bind.h"
+#include "base/callback.h"
+
+#include <benchmark/benchmark.h>
+
+namespace basis {
+
+namespace {
+
+struct PacketState
+{
+  int counter = 0;
+};
+
+// Emulates task that runs on sequence,
+// so `SequenceToken::GetForCurrentThread()` is valid.
+class ScopedFakeSequence
+{
+public:
+  ScopedFakeSequence()
+    : scoped_token_(::base::SequenceToken::Create())
+  {}
+
+private:
+  ::base::ScopedSetSequenceTokenForCurrentThread scoped_token_;
+};
+
+void BM_PlainOptional(benchmark::State& state)
+{
+  ScopedFakeSequence sequence;
+
+  ::base::Optional<PacketState> value{::base::in_place};
+
+  for (auto _ : state) {
+    value->counter++;
+    benchmark::DoNotOptimize(value->counter);
+  }
+}
+BENCHMARK(BM_PlainOptional);
+
+void BM_CheckedOptionalAlways(benchmark::State& state)
+{
+  ScopedFakeSequence sequence;
+
+  ::basis::CheckedOptional<
+    PacketState
+    , ::basis::CheckedOptionalPolicy::Always
+  > value{
+      ::base::BindRepeating([]() { return true; })
+      , ::basis::CheckedOptionalPermissions::All
+      , ::base::in_place};
+
+  for (auto _ : state) {
+    value->counter++;
+    benchmark::DoNotOptimize(value->counter);
+  }
+}
+BENCHMARK(BM_CheckedOptionalAlways);
+
+void BM_StaticCheckedOptionalVerifyNothing(benchmark::State& state)
+{
+  ScopedFakeSequence sequence;
+
+  ::basis::StaticCheckedOptional<
+    PacketState
+    , ::basis::CheckedOptionalPolicy::Always
+    , ::basis::StaticVerifyNothing
+  > value{
+      ::basis::CheckedOptionalPermissions::All
+      , ::base::in_place};
+
+  for (auto _ : state) {
+    value->counter++;
+    benchmark::DoNotOptimize(value->counter);
+  }
+}
+BENCHMARK(BM_StaticCheckedOptionalVerifyNothing);
+
+void BM_StaticCheckedOptionalVerifySequence(benchmark::State& state)
+{
+  ScopedFakeSequence sequence;
+
+  ::basis::StaticCheckedOptional<
+    PacketState
+    , ::basis::CheckedOptionalPolicy::Always
+    , ::basis::StaticVerifySequence
+  > value{
+      ::basis::CheckedOptionalPermissions::All
+      , ::base::in_place};
+
+  for (auto _ : state) {
+    value->counter++;
+    benchmark::DoNotOptimize(value->counter);
+  }
+}
+BENCHMARK(BM_StaticCheckedOptionalVerifySequence);
+
+void BM_CheckedOptionalSampled(benchmark::State& state)
+{
+  ScopedFakeSequence sequence;
+
+  ::basis::CheckedOptional<
+    PacketState
+    , ::basis::CheckedOptionalPolicy::Sampled
+  > value{
+      ::base::BindRepeating([]() { return true; })
+      , ::basis::CheckedOptionalPermissions::All
+      , ::base::in_place};
+
+  for (auto _ : state) {
+    value->counter++;
+    benchmark::DoNotOptimize(value->counter);
+  }
+}
+BENCHMARK(BM_CheckedOptionalSampled);
+
+void BM_CheckedOptionalSampledPerThread(benchmark::State& state)
+{
+  ScopedFakeSequence sequence;
+
+  ::basis::CheckedOptional<
+    PacketState
+    , ::basis::CheckedOptionalPolicy::SampledPerThread
+  > value{
+      ::base::BindRepeating([]() { return true; })
+      , ::basis::CheckedOptionalPermissions::All
+      , ::base::in_place};
+
+  for (auto _ : state) {
+    value->counter++;
+    benchmark::DoNotOptimize(value->counter);
+  }
+}
+BENCHMARK(BM_CheckedOptionalSampledPerThread);
+
+}  // namespace
+
+}  // namespace basis
@@ -0,0 +1,175 @@
+#include "basis/checked_optional.h"
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/optional.h"
+#include "base/test/mock_log.h"
+#include "base/test/scoped_feature_list.h"
+#include "base/threading/thread.h"
+
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <string>
+
+namespace basis {
+namespace {
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::HasSubstr;
+
+struct PacketState {
+  int counter = 0;
+};
+
+template <CheckedOptionalPolicy VerifyPolicyType>
+using TestOptional = CheckedOptional<PacketState, VerifyPolicyType>;
+
+class CheckedOptionalSamplingTest : public testing::Test {
+ protected:
+  void SetUp() override { SetSamplingRate(4); }
+
+  void TearDown() override { resetCheckedOptionalSamplingRateForTesting(); }
+
+  void SetSamplingRate(int rate) {
+    feature_list_.reset();
+    feature_list_.emplace();
+    feature_list_->InitAndEnableFeatureWithParameters(
+        kCheckedOptionalSampling, {{"sampling_rate", std::to_string(rate)}});
+    resetCheckedOptionalSamplingRateForTesting();
+  }
+
+  // Verifier that counts its calls and returns `verifier_result_`.
+  CheckedOptional<PacketState, CheckedOptionalPolicy::Sampled>::VerifierCb
+  CountingVerifier() {
+    return base::BindRepeating(
+        [](int* calls, const bool* result) {
+          ++(*calls);
+          return *result;
+        },
+        base::Unretained(&verifier_calls_),
+        base::Unretained(&verifier_result_));
+  }
+
+  base::Optional<base::test::ScopedFeatureList> feature_list_;
+
+  int verifier_calls_ = 0;
+
+  bool verifier_result_ = true;
+};
+
+TEST_F(CheckedOptionalSamplingTest, VerifiesOneInNAccesses) {
+  EXPECT_EQ(4, checkedOptionalSamplingRate());
+
+  TestOptional<CheckedOptionalPolicy::Sampled> state{
+      CountingVerifier(), CheckedOptionalPermissions::All, base::in_place};
+
+  // first access is verified, then each 4th
+  for (int i = 0; i < 16; ++i) {
+    ++state->counter;
+  }
+
+  EXPECT_EQ(16, state.value().counter);
+  EXPECT_EQ(5, verifier_calls_);
+}
+
+TEST_F(CheckedOptionalSamplingTest, SamplesPerThread) {
+  base::Thread thread("CheckedOptionalSamplingTest");
+  ASSERT_TRUE(thread.Start());
+
+  // fresh thread, so thread-local countdown is not used yet
+  using VerifierCb =
+      TestOptional<CheckedOptionalPolicy::SampledPerThread>::VerifierCb;
+  thread.task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(
+                     [](const VerifierCb& verifier) {
+                       // countdown is shared between instances
+                       for (int i = 0; i < 8; ++i) {
+                         TestOptional<CheckedOptionalPolicy::SampledPerThread>
+                             state{VerifierCb(verifier),
+                                   CheckedOptionalPermissions::All,
+                                   base::in_place};
+                         ++state->counter;
+                       }
+                     },
+                     CountingVerifier()));
+  thread.FlushForTesting();
+  thread.Stop();
+
+  EXPECT_EQ(2, verifier_calls_);
+}
+
+TEST_F(CheckedOptionalSamplingTest, CountsAndLogsViolations) {
+  base::test::MockLog log;
+  EXPECT_CALL(log, Log(_, _, _, _, _)).Times(AnyNumber());
+  EXPECT_CALL(log, Log(logging::LOG_ERROR, _, _, _,
+                       HasSubstr("sampled verification failed")))
+      .Times(::testing::AtLeast(1));
+  log.StartCapturingLogs();
+
+  verifier_result_ = false;
+  const uint64_t violations_before = checkedOptionalViolationCount();
+
+  TestOptional<CheckedOptionalPolicy::Sampled> state{
+      CountingVerifier(), CheckedOptionalPermissions::All, base::in_place};
+
+  // failed sampled verification does not crash
+  for (int i = 0; i < 8; ++i) {
+    ++state->counter;
+  }
+
+  EXPECT_EQ(2, verifier_calls_);
+  EXPECT_EQ(violations_before + 2, checkedOptionalViolationCount());
+
+  log.StopCapturingLogs();
+}
+
+TEST_F(CheckedOptionalSamplingTest, CountsPermissionViolations) {
+  const uint64_t violations_before = checkedOptionalViolationCount();
+
+  TestOptional<CheckedOptionalPolicy::Sampled> state{
+      CountingVerifier(), CheckedOptionalPermissions::Readable,
+      base::in_place};
+
+  ignore_result(state.emplace(FROM_HERE));
+
+  EXPECT_EQ(1, verifier_calls_);
+  EXPECT_EQ(violations_before + 1, checkedOptionalViolationCount());
+}
+
+TEST_F(CheckedOptionalSamplingTest, ResetsCachedSamplingRate) {
+  EXPECT_EQ(4, checkedOptionalSamplingRate());
+
+  feature_list_.reset();
+  feature_list_.emplace();
+  feature_list_->InitAndEnableFeatureWithParameters(
+      kCheckedOptionalSampling, {{"sampling_rate", "2"}});
+
+  // cached value is used until reset
+  EXPECT_EQ(4, checkedOptionalSamplingRate());
+
+  resetCheckedOptionalSamplingRateForTesting();
+  EXPECT_EQ(2, checkedOptionalSamplingRate());
+}
+
+TEST_F(CheckedOptionalSamplingTest, DisabledFeatureSkipsVerification) {
+  feature_list_.reset();
+  feature_list_.emplace();
+  feature_list_->InitAndDisableFeature(kCheckedOptionalSampling);
+  resetCheckedOptionalSamplingRateForTesting();
+
+  EXPECT_EQ(0, checkedOptionalSamplingRate());
+
+  TestOptional<CheckedOptionalPolicy::Sampled> state{
+      CountingVerifier(), CheckedOptionalPermissions::All, base::in_place};
+  for (int i = 0; i < 16; ++i) {
+    ++state->counter;
+  }
+
+  EXPECT_EQ(0, verifier_calls_);
+}
+
+}  // namespace
+}  // namespace basis
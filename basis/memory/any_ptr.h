@@ -1,21 +1,113 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
-#include <variant>
+#include <type_traits>
 #if defined(__cplusplus) && __cplusplus >= 201709L
-#include <concepts>
+#include <compare>
 #endif // __cplusplus
 
 #include <base/logging.h>
 #include <base/macros.h>
 #include <base/location.h>
+#include <base/compiler_specific.h>
+#include <base/notreached.h>
+#include <basic/macros.h>
 #include <basic/rvalue_cast.h>
 #include <base/sequence_checker.h>
 #include <base/memory/scoped_refptr.h>
-#include "base/sequence_checker.h"
 
 namespace basis {
 
+// Ownership kind of `AnyPtr`.
+enum class AnyPtrKind : uintptr_t
+{
+  // Not owned pointer (can be nullptr).
+  Raw = 0
+  // Owns object like `std::unique_ptr`.
+  , Unique = 1
+  // Owns heap-allocated copy of `std::shared_ptr`.
+  , Shared = 2
+  // Owns one reference obtained via `AddRef()` (like `scoped_refptr`).
+  , RefCounted = 3
+};
+
+namespace internal {
+
+// Low bits of pointer are free if type is aligned at least by 4 bytes,
+// so we can pack `AnyPtrKind` into pointer.
+template<typename T>
+struct AnyPtrStorage
+{
+  static constexpr uintptr_t kKindMask = 3u;
+
+  ALWAYS_INLINE
+  void set(void* ptr, AnyPtrKind kind) NO_EXCEPTION
+  {
+    const uintptr_t value = reinterpret_cast<uintptr_t>(ptr);
+    DCHECK_EQ(value & kKindMask, 0u)
+      << "pointer is not aligned";
+    bits_ = value | static_cast<uintptr_t>(kind);
+  }
+
+  ALWAYS_INLINE
+  void* address() const NO_EXCEPTION
+  {
+    return reinterpret_cast<void*>(bits_ & ~kKindMask);
+  }
+
+  ALWAYS_INLINE
+  AnyPtrKind kind() const NO_EXCEPTION
+  {
+    return static_cast<AnyPtrKind>(bits_ & kKindMask);
+  }
+
+  uintptr_t bits_ = 0;
+};
+
+// Fallback for types with small alignment (like `char`).
+template<typename T>
+struct AnyPtrUnalignedStorage
+{
+  ALWAYS_INLINE
+  void set(void* ptr, AnyPtrKind kind) NO_EXCEPTION
+  {
+    ptr_ = ptr;
+    kind_ = kind;
+  }
+
+  ALWAYS_INLINE
+  void* address() const NO_EXCEPTION
+  {
+    return ptr_;
+  }
+
+  ALWAYS_INLINE
+  AnyPtrKind kind() const NO_EXCEPTION
+  {
+    return kind_;
+  }
+
+  void* ptr_ = nullptr;
+  AnyPtrKind kind_ = AnyPtrKind::Raw;
+};
+
+// Detects types that can be stored in `scoped_refptr`.
+template<typename T, typename = void>
+struct IsAnyPtrRefCounted : std::false_type {};
+
+template<typename T>
+struct IsAnyPtrRefCounted<T
+  , std::void_t<
+      decltype(std::declval<T&>().AddRef())
+      , decltype(std::declval<T&>().Release())
+    >
+> : std::true_type {};
+
+} // namespace internal
+
 /// \note prefer `WeakPtr` if you do not want to affect object lifetime.
 /// \note prefer `UnownedRef` to only hold non-null values (`not null`).
 /// \note prefer `UnownedPtr` to only hold standard C-style pointer
@@ -30,195 +122,317 @@ namespace basis {
 //
 // Unlike std::any, preserves normal pointer behaviour.
 //
-// Checks lifetime of pointer using memory tool like ASAN.
+// Checks lifetime of pointer using memory tool like ASAN (only in debug builds).
+//
+// Checks thread-safety using `sequence_checker_` (only in debug builds).
+//
+// PERFORMANCE
 //
-// Checks thread-safety using `sequence_checker_`.
+// Ownership kind is packed into low bits of pointer,
+// so `AnyPtr` is single word in release builds
+// (if `alignof(T) >= 4`, otherwise it stores separate kind field).
+// Can be stored in ECS components by the million.
+//
+/// \note `std::shared_ptr` does not fit into single word,
+/// so it is moved into separate heap allocation
+/// and dereference of such `AnyPtr` costs extra indirection.
 //
 template<typename T>
-struct AnyPtr {
+class AnyPtr {
+ public:
   using pointer = T*;
   using unique_ptr = std::unique_ptr<T>;
   using shared_ptr = std::shared_ptr<T>;
   using shared_refptr = scoped_refptr<T>;
 
-  AnyPtr() : variant_(static_cast<pointer>(nullptr))
+  static constexpr bool kUsesTaggedPointer
+    = alignof(T) >= 4;
+
+  AnyPtr() NO_EXCEPTION
   {
     DETACH_FROM_SEQUENCE(sequence_checker_);
   }
 
-  AnyPtr(pointer p) noexcept : ptr_(p), variant_(p)
+  AnyPtr(std::nullptr_t) NO_EXCEPTION
+    : AnyPtr()
+  {}
+
+  AnyPtr(pointer p) NO_EXCEPTION
   {
     DETACH_FROM_SEQUENCE(sequence_checker_);
+    storage_.set(p, AnyPtrKind::Raw);
     checkForLifetimeIssues();
   }
 
   /// \note Moves original `unique_ptr`, so becomes owner of `unique_ptr`.
   /// If you do not want to own `unique_ptr`, than use `unique_ptr::get()`.
-  AnyPtr(unique_ptr&& up) noexcept : ptr_(up.get()), variant_(RVALUE_CAST(up))
+  AnyPtr(unique_ptr&& up) NO_EXCEPTION
   {
     DETACH_FROM_SEQUENCE(sequence_checker_);
+    storage_.set(up.release(), AnyPtrKind::Unique);
     checkForLifetimeIssues();
   }
 
-  template<typename U>
-#if defined(__cplusplus) && __cplusplus >= 201709L
-  requires std::derived_from<T, U>
-#endif
-  AnyPtr(unique_ptr<U>&& up) noexcept : AnyPtr(static_cast<unique_ptr>(RVALUE_CAST(up)))
+  template<
+    typename U
+    , typename = std::enable_if_t<
+        !std::is_same<U, T>::value
+        && std::is_convertible<U*, T*>::value>
+  >
+  AnyPtr(std::unique_ptr<U>&& up) NO_EXCEPTION
+    : AnyPtr(unique_ptr(RVALUE_CAST(up)))
   {}
 
   /// \note Moves copy of original `shared_ptr`, so increases ref. count.
   /// If you do not want to increase ref. count of `shared_ptr`, than use `shared_ptr::get()`.
-  AnyPtr(shared_ptr sp) noexcept : ptr_(sp.get()), variant_(RVALUE_CAST(sp))
+  AnyPtr(shared_ptr sp) NO_EXCEPTION
   {
     DETACH_FROM_SEQUENCE(sequence_checker_);
+    if(sp)
+    {
+      storage_.set(new shared_ptr(RVALUE_CAST(sp)), AnyPtrKind::Shared);
+    }
     checkForLifetimeIssues();
   }
 
-  template<typename U>
-#if defined(__cplusplus) && __cplusplus >= 201709L
-  requires std::derived_from<T, U>
-#endif
-  AnyPtr(shared_ptr<U> sp) noexcept : AnyPtr(static_cast<shared_ptr>(RVALUE_CAST(sp)))
+  template<
+    typename U
+    , typename = std::enable_if_t<
+        !std::is_same<U, T>::value
+        && std::is_convertible<U*, T*>::value>
+  >
+  AnyPtr(std::shared_ptr<U> sp) NO_EXCEPTION
+    : AnyPtr(shared_ptr(RVALUE_CAST(sp)))
   {}
 
   /// \note Moves copy of original `shared_refptr`, so increases ref. count.
   /// If you do not want to increase ref. count of `shared_refptr`, than use `shared_refptr::get()`.
-  AnyPtr(shared_refptr sp) noexcept : ptr_(sp.get()), variant_(RVALUE_CAST(sp))
+  AnyPtr(shared_refptr sp) NO_EXCEPTION
   {
     DETACH_FROM_SEQUENCE(sequence_checker_);
+    pointer p = sp.get();
+    if(p)
+    {
+      // keep reference after `sp` destruction
+      p->AddRef();
+      storage_.set(p, AnyPtrKind::RefCounted);
+    }
     checkForLifetimeIssues();
   }
 
-  template<typename U>
-#if defined(__cplusplus) && __cplusplus >= 201709L
-  requires std::derived_from<T, U>
-#endif
-  AnyPtr(shared_refptr<U> sp) noexcept : AnyPtr(static_cast<shared_refptr>(RVALUE_CAST(sp)))
+  template<
+    typename U
+    , typename = std::enable_if_t<
+        !std::is_same<U, T>::value
+        && std::is_convertible<U*, T*>::value>
+  >
+  AnyPtr(scoped_refptr<U> sp) NO_EXCEPTION
+    : AnyPtr(shared_refptr(RVALUE_CAST(sp)))
   {}
 
-  AnyPtr(AnyPtr&&) = default;
+  AnyPtr(AnyPtr&& other) NO_EXCEPTION
+    : storage_(other.storage_)
+  {
+    DETACH_FROM_SEQUENCE(sequence_checker_);
+    other.storage_.set(nullptr, AnyPtrKind::Raw);
+  }
+
+  AnyPtr& operator=(AnyPtr&& other) NO_EXCEPTION
+  {
+    if(this != &other)
+    {
+      reset();
+      storage_ = other.storage_;
+      other.storage_.set(nullptr, AnyPtrKind::Raw);
+    }
+    return *this;
+  }
 
-  AnyPtr& operator=(AnyPtr&&) = default;
+  ~AnyPtr()
+  {
+    reset();
+  }
 
   inline void DetachFromSequence() {
     DETACH_FROM_SEQUENCE(sequence_checker_);
   }
 
-  pointer get() const noexcept
+  // Releases owned object (if any) and stores nullptr.
+  void reset() NO_EXCEPTION
+  {
+    void* address = storage_.address();
+    switch(storage_.kind())
+    {
+      case AnyPtrKind::Raw:
+        break;
+      case AnyPtrKind::Unique:
+        delete static_cast<pointer>(address);
+        break;
+      case AnyPtrKind::Shared:
+        delete static_cast<shared_ptr*>(address);
+        break;
+      case AnyPtrKind::RefCounted:
+        if constexpr (internal::IsAnyPtrRefCounted<T>::value)
+        {
+          static_cast<pointer>(address)->Release();
+        }
+        else
+        {
+          NOTREACHED();
+        }
+        break;
+    }
+    storage_.set(nullptr, AnyPtrKind::Raw);
+  }
+
+  AnyPtrKind kind() const NO_EXCEPTION
+  {
+    return storage_.kind();
+  }
+
+  // Returns true if `AnyPtr` affects lifetime of stored object.
+  bool isOwning() const NO_EXCEPTION
+  {
+    return storage_.kind() != AnyPtrKind::Raw;
+  }
+
+  ALWAYS_INLINE
+  pointer get() const NO_EXCEPTION
   {
     DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_)
         << "AnyPtrs must be checked on the same sequenced thread.";
     checkForLifetimeIssues();
-    return ptr_;
+    return getUnchecked();
   }
 
-  T& operator*() const noexcept
+  T& operator*() const NO_EXCEPTION
   {
     return *get();
   }
 
-  pointer operator->() const noexcept
+  pointer operator->() const NO_EXCEPTION
   {
     return get();
   }
 
-  operator bool() const noexcept
+  explicit operator bool() const NO_EXCEPTION
   {
     return get() != nullptr;
   }
 
-  bool operator==(const AnyPtr&) const noexcept = default;
+  bool operator==(const AnyPtr& p) const NO_EXCEPTION
+  {
+    return get() == p.get();
+  }
 
-  bool operator==(const pointer p) const noexcept
+  bool operator==(const pointer p) const NO_EXCEPTION
   {
     return get() == p;
   }
 
-  bool operator==(const unique_ptr& p) const noexcept
+  bool operator==(const unique_ptr& p) const NO_EXCEPTION
   {
-    return get() == p;
+    return get() == p.get();
   }
 
-  bool operator==(const shared_ptr& p) const noexcept
+  bool operator==(const shared_ptr& p) const NO_EXCEPTION
   {
-    return get() == p;
+    return get() == p.get();
+  }
+
+  bool operator==(const shared_refptr& p) const NO_EXCEPTION
+  {
+    return get() == p.get();
   }
 
 #ifdef __cpp_impl_three_way_comparison
-  std::strong_ordering operator<=>(const AnyPtr&) const noexcept = default;
+  std::strong_ordering operator<=>(const AnyPtr& p) const NO_EXCEPTION
+  {
+    return get() <=> p.get();
+  }
 
-  std::strong_ordering operator<=>(const pointer p) const noexcept
+  std::strong_ordering operator<=>(const pointer p) const NO_EXCEPTION
   {
     return get() <=> p;
   }
+#else
+  bool operator!=(const AnyPtr& p) const NO_EXCEPTION
+  {
+    return get() != p.get();
+  }
 
-  std::strong_ordering operator<=>(const unique_ptr& p) const noexcept
+  bool operator<(const AnyPtr& p) const NO_EXCEPTION
   {
-    return get() <=> p;
+    return std::less<pointer>()(get(), p.get());
   }
 
-  std::strong_ordering operator<=>(const shared_ptr& p) const noexcept
+  bool operator!=(const pointer p) const NO_EXCEPTION
   {
-    return get() <=> p;
+    return get() != p;
   }
 
-  std::strong_ordering operator<=>(const shared_refptr& p) const noexcept
+  bool operator<(const pointer p) const NO_EXCEPTION
   {
-    return get() <=> p;
+    return std::less<pointer>()(get(), p);
   }
-#else
-  bool operator!=(const AnyPtr& p) const noexcept = default;
-  bool operator>=(const AnyPtr& p) const noexcept = default;
-  bool operator>(const AnyPtr& p) const noexcept = default;
-  bool operator<=(const AnyPtr& p) const noexcept = default;
-  bool operator<(const AnyPtr& p) const noexcept = default;
-
-  bool operator!=(const pointer p) const noexcept { return get() != p; }
-  bool operator>=(const pointer p) const noexcept { return get() != p; }
-  bool operator>(const pointer p) const noexcept { return get() != p; }
-  bool operator<=(const pointer p) const noexcept { return get() != p; }
-  bool operator<(const pointer p) const noexcept { return get() != p; }
-
-  bool operator!=(const unique_ptr& p) const noexcept { return get() != p; }
-  bool operator>=(const unique_ptr& p) const noexcept { return get() != p; }
-  bool operator>(const unique_ptr& p) const noexcept { return get() != p; }
-  bool operator<=(const unique_ptr& p) const noexcept { return get() != p; }
-  bool operator<(const unique_ptr& p) const noexcept { return get() != p; }
-
-  bool operator!=(const shared_ptr& p) const noexcept { return get() != p; }
-  bool operator>=(const shared_ptr& p) const noexcept { return get() != p; }
-  bool operator>(const shared_ptr& p) const noexcept { return get() != p; }
-  bool operator<=(const shared_ptr& p) const noexcept { return get() != p; }
-  bool operator<(const shared_ptr& p) const noexcept { return get() != p; }
-
-  bool operator!=(const shared_refptr& p) const noexcept { return get() != p; }
-  bool operator>=(const shared_refptr& p) const noexcept { return get() != p; }
-  bool operator>(const shared_refptr& p) const noexcept { return get() != p; }
-  bool operator<=(const shared_refptr& p) const noexcept { return get() != p; }
-  bool operator<(const shared_refptr& p) const noexcept { return get() != p; }
 #endif // __cpp_impl_three_way_comparison
 
+  bool operator!=(const unique_ptr& p) const NO_EXCEPTION
+  {
+    return get() != p.get();
+  }
+
+  bool operator!=(const shared_ptr& p) const NO_EXCEPTION
+  {
+    return get() != p.get();
+  }
+
+  bool operator!=(const shared_refptr& p) const NO_EXCEPTION
+  {
+    return get() != p.get();
+  }
+
  private:
+  ALWAYS_INLINE
+  pointer getUnchecked() const NO_EXCEPTION
+  {
+    void* address = storage_.address();
+    if(UNLIKELY(storage_.kind() == AnyPtrKind::Shared))
+    {
+      return static_cast<shared_ptr*>(address)->get();
+    }
+    return static_cast<pointer>(address);
+  }
+
   // check that object is alive, use memory tool like ASAN
   /// \note ignores nullptr
-  inline void checkForLifetimeIssues() const
+  ALWAYS_INLINE
+  void checkForLifetimeIssues() const
   {
     // Works with `-fsanitize=address,undefined`
-#if defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
-    if (ptr_ != nullptr)
-      reinterpret_cast<const volatile uint8_t*>(ptr_)[0];
+#if DCHECK_IS_ON() && defined(MEMORY_TOOL_REPLACES_ALLOCATOR)
+    pointer ptr = getUnchecked();
+    if (ptr != nullptr)
+      reinterpret_cast<const volatile uint8_t*>(ptr)[0];
 #endif
   }
 
 private:
-  /// Cached, so we dont have to switch on the variant type for each access
-  pointer ptr_;
-  std::variant<pointer, unique_ptr, shared_ptr, shared_refptr> variant_;
+  std::conditional_t<
+    kUsesTaggedPointer
+    , internal::AnyPtrStorage<T>
+    , internal::AnyPtrUnalignedStorage<T>
+  > storage_;
 
+  /// \note compiles to nothing in release builds
   SEQUENCE_CHECKER(sequence_checker_);
 
   DISALLOW_COPY_AND_ASSIGN(AnyPtr);
 };
 
+#if !DCHECK_IS_ON()
+static_assert(sizeof(AnyPtr<uint32_t>) == sizeof(void*)
+  , "AnyPtr must be single word in release builds");
+#endif // !DCHECK_IS_ON()
+
 } // namespace basis
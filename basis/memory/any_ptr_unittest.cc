@@ -0,0 +1,113 @@
+#include "basis/memory/any_ptr.h"
+
+#include <memory>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_refptr.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace basis {
+namespace {
+
+class Base {
+ public:
+  virtual ~Base() = default;
+
+  int value = 1;
+};
+
+class Derived : public Base {
+ public:
+  explicit Derived(bool* destroyed) : destroyed_(destroyed) {}
+
+  ~Derived() override { *destroyed_ = true; }
+
+ private:
+  bool* destroyed_;
+};
+
+class RefCountedObject : public base::RefCounted<RefCountedObject> {
+ public:
+  explicit RefCountedObject(bool* destroyed) : destroyed_(destroyed) {}
+
+ private:
+  friend class base::RefCounted<RefCountedObject>;
+
+  ~RefCountedObject() { *destroyed_ = true; }
+
+  bool* destroyed_;
+};
+
+TEST(AnyPtrTest, RawPointerIsNotOwned) {
+  int value = 3;
+  AnyPtr<int> ptr(&value);
+  EXPECT_EQ(AnyPtrKind::Raw, ptr.kind());
+  EXPECT_FALSE(ptr.isOwning());
+  EXPECT_EQ(&value, ptr.get());
+  EXPECT_EQ(3, *ptr);
+
+  AnyPtr<int> empty;
+  EXPECT_FALSE(empty);
+  EXPECT_EQ(nullptr, empty.get());
+}
+
+TEST(AnyPtrTest, OwnsUniquePtr) {
+  bool destroyed = false;
+  {
+    AnyPtr<Base> ptr(std::make_unique<Derived>(&destroyed));
+    EXPECT_EQ(AnyPtrKind::Unique, ptr.kind());
+    EXPECT_EQ(1, ptr->value);
+
+    AnyPtr<Base> moved(std::move(ptr));
+    EXPECT_FALSE(ptr);
+    EXPECT_TRUE(moved);
+    EXPECT_FALSE(destroyed);
+  }
+  EXPECT_TRUE(destroyed);
+}
+
+TEST(AnyPtrTest, SharesSharedPtr) {
+  bool destroyed = false;
+  std::shared_ptr<Base> shared = std::make_shared<Derived>(&destroyed);
+  {
+    AnyPtr<Base> ptr(shared);
+    EXPECT_EQ(AnyPtrKind::Shared, ptr.kind());
+    EXPECT_EQ(2, shared.use_count());
+    EXPECT_EQ(shared.get(), ptr.get());
+  }
+  EXPECT_EQ(1, shared.use_count());
+  shared.reset();
+  EXPECT_TRUE(destroyed);
+}
+
+TEST(AnyPtrTest, HoldsReferenceOfRefCounted) {
+  bool destroyed = false;
+  AnyPtr<RefCountedObject> ptr(
+    base::MakeRefCounted<RefCountedObject>(&destroyed));
+  EXPECT_EQ(AnyPtrKind::RefCounted, ptr.kind());
+  EXPECT_FALSE(destroyed);
+
+  AnyPtr<RefCountedObject> other;
+  other = std::move(ptr);
+  EXPECT_FALSE(destroyed);
+
+  other.reset();
+  EXPECT_TRUE(destroyed);
+}
+
+TEST(AnyPtrTest, SmallAlignmentFallback) {
+  char value = 'a';
+  AnyPtr<char> ptr(&value);
+  EXPECT_FALSE(AnyPtr<char>::kUsesTaggedPointer);
+  EXPECT_EQ(&value, ptr.get());
+}
+
+#if !DCHECK_IS_ON()
+TEST(AnyPtrTest, SingleWordInRelease) {
+  EXPECT_EQ(sizeof(void*), sizeof(AnyPtr<Base>));
+}
+#endif  // !DCHECK_IS_ON()
+
+}  // namespace
+}  // namespace basis
@@ -0,0 +1,74 @@
+#include "basis/memory/scoped_memory_dump_provider.h" // IWYU pragma: associated
+
+#include <base/logging.h>
+#include <base/trace_event/memory_allocator_dump.h>
+#include <base/trace_event/memory_dump_manager.h>
+#include <base/trace_event/process_memory_dump.h>
+
+#include <basic/rvalue_cast.h>
+
+namespace basis {
+
+ScopedMemoryDumpProvider::ScopedMemoryDumpProvider(
+  const char* name
+  , scoped_refptr<::base::SequencedTaskRunner> taskRunner
+  , DumpCallback dumpCallback)
+  : dumpCallback_(RVALUE_CAST(dumpCallback))
+{
+  DCHECK(name);
+  DCHECK(taskRunner);
+  DCHECK(dumpCallback_);
+
+  // `OnMemoryDump` and destructor are called on `taskRunner`
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+
+  ::base::trace_event::MemoryDumpManager::GetInstance()
+    ->RegisterDumpProviderWithSequencedTaskRunner(
+        this
+        , name
+        , RVALUE_CAST(taskRunner)
+        , ::base::trace_event::MemoryDumpProvider::Options());
+}
+
+ScopedMemoryDumpProvider::~ScopedMemoryDumpProvider()
+{
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  ::base::trace_event::MemoryDumpManager::GetInstance()
+    ->UnregisterDumpProvider(this);
+}
+
+bool ScopedMemoryDumpProvider::OnMemoryDump(
+  const ::base::trace_event::MemoryDumpArgs& /*args*/
+  , ::base::trace_event::ProcessMemoryDump* pmd)
+{
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  dumpCallback_.Run(pmd);
+
+  return true;
+}
+
+void addAllocatorDump(
+  ::base::trace_event::ProcessMemoryDump* pmd
+  , const std::string& dumpName
+  , size_t sizeInBytes
+  , size_t objectCount)
+{
+  DCHECK(pmd);
+
+  ::base::trace_event::MemoryAllocatorDump* dump
+    = pmd->CreateAllocatorDump(dumpName);
+
+  dump->AddScalar(
+    ::base::trace_event::MemoryAllocatorDump::kNameSize
+    , ::base::trace_event::MemoryAllocatorDump::kUnitsBytes
+    , sizeInBytes);
+
+  dump->AddScalar(
+    ::base::trace_event::MemoryAllocatorDump::kNameObjectCount
+    , ::base::trace_event::MemoryAllocatorDump::kUnitsObjects
+    , objectCount);
+}
+
+} // namespace basis
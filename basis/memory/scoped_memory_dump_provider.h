@@ -0,0 +1,78 @@
+#pragma once
+
+#include <base/callback.h>
+#include <base/macros.h>
+#include <base/memory/scoped_refptr.h>
+#include <base/sequence_checker.h>
+#include <base/sequenced_task_runner.h>
+#include <base/trace_event/memory_dump_provider.h>
+
+#include <cstddef>
+#include <string>
+
+namespace base {
+namespace trace_event {
+class ProcessMemoryDump;
+} // namespace trace_event
+} // namespace base
+
+namespace basis {
+
+// Registers `dumpCallback` in `base::trace_event::MemoryDumpManager`
+// for lifetime of object,
+// so memory-infra traces show memory used by basis containers.
+//
+// `dumpCallback` runs on `taskRunner`, so it can access
+// sequence-bound containers (like `ECS::SafeRegistry`) without locks.
+//
+/// \note must be destroyed on `taskRunner`
+/// (required by `MemoryDumpManager::UnregisterDumpProvider`).
+/// \note `name` must be string literal (stored by pointer).
+//
+// USAGE
+//
+//  ::basis::ScopedMemoryDumpProvider taskHeapDumpProvider_{
+//    "PrioritizedOnceTaskHeap"
+//    , ::base::SequencedTaskRunnerHandle::Get()
+//    , ::base::BindRepeating(
+//        &::basis::PrioritizedOnceTaskHeap::DumpMemoryStats
+//        , taskHeap_
+//        , "basis/task_heap")};
+class ScopedMemoryDumpProvider
+  : public ::base::trace_event::MemoryDumpProvider
+{
+ public:
+  using DumpCallback
+    = ::base::RepeatingCallback<
+        void(::base::trace_event::ProcessMemoryDump*)
+      >;
+
+  ScopedMemoryDumpProvider(
+    const char* name
+    , scoped_refptr<::base::SequencedTaskRunner> taskRunner
+    , DumpCallback dumpCallback);
+
+  ~ScopedMemoryDumpProvider() override;
+
+  // base::trace_event::MemoryDumpProvider
+  bool OnMemoryDump(
+    const ::base::trace_event::MemoryDumpArgs& args
+    , ::base::trace_event::ProcessMemoryDump* pmd) override;
+
+ private:
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  DumpCallback dumpCallback_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedMemoryDumpProvider);
+};
+
+// Adds allocator dump with `size` (in bytes)
+// and `object_count` to `pmd`.
+void addAllocatorDump(
+  ::base::trace_event::ProcessMemoryDump* pmd
+  , const std::string& dumpName
+  , size_t sizeInBytes
+  , size_t objectCount);
+
+} // namespace basis
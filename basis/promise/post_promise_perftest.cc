@@ -0,0 +1,55 @@
+#include "basis/promise/post_promise.h"
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread_task_runner_handle.h"
+
+#include <boost/asio.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <thread>
+
+namespace basis {
+
+namespace {
+
+// Posts promise on `boost::asio` executor (runs on separate thread)
+// and waits until its result is delivered back to task runner.
+void BM_PostPromiseOnAsioExecutorRoundTrip(benchmark::State& state) {
+  base::test::TaskEnvironment task_environment;
+
+  boost::asio::io_context ioc;
+  auto work_guard = boost::asio::make_work_guard(ioc);
+  std::thread asio_thread([&ioc]() { ioc.run(); });
+
+  const boost::asio::executor executor = ioc.get_executor();
+
+  int counter = 0;
+
+  for (auto _ : state) {
+    base::RunLoop run_loop;
+
+    base::PostPromiseOnAsioExecutor(FROM_HERE
+      , executor
+      , base::BindOnce([](int* counter) { ++(*counter); }
+          , base::Unretained(&counter)))
+    .ThenOn(base::ThreadTaskRunnerHandle::Get()
+      , FROM_HERE
+      , run_loop.QuitClosure());
+
+    run_loop.Run();
+  }
+
+  work_guard.reset();
+  asio_thread.join();
+
+  CHECK_EQ(counter, state.iterations());
+}
+BENCHMARK(BM_PostPromiseOnAsioExecutorRoundTrip);
+
+}  // namespace
+
+}  // namespace basis
@@ -0,0 +1,589 @@
+#pragma once
+
+#include <basis/checked_optional.h>
+
+#include <base/macros.h>
+#include <base/logging.h>
+#include <base/location.h>
+#include <base/optional.h>
+#include <base/compiler_specific.h>
+#include <base/sequence_token.h>
+#include <base/sequence_checker_impl.h>
+#include <base/strings/string_piece.h>
+#include <base/threading/thread_collision_warner.h>
+
+#include <basic/macros.h>
+#include <basic/rvalue_cast.h>
+
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+namespace basis {
+
+// Verifier that always passes.
+// Compiles to nothing, so `StaticCheckedOptional` that uses it
+// costs same as `base::Optional` (except permission checks).
+struct StaticVerifyNothing
+{
+  ALWAYS_INLINE
+  constexpr bool operator()() const NO_EXCEPTION
+  {
+    return true;
+  }
+};
+
+// Verifies that all accesses are performed on same sequence.
+// Unlike `SEQUENCE_CHECKER` it works in release builds.
+//
+// PERFORMANCE
+//
+// Result of check is cached per sequence token.
+// Sequence token is same for all tasks that run on same sequence
+// (and is set for whole duration of each task),
+// so after first successful check each access costs
+// only one thread-local read and one compare.
+// Expensive `base::SequenceCheckerImpl` (it uses lock)
+// is called only when sequence token changes
+// (or if code is running outside of any task).
+class StaticVerifySequence
+{
+public:
+  StaticVerifySequence() = default;
+
+  // Next access will bind verifier to new sequence.
+  void DetachFromSequence() NO_EXCEPTION
+  {
+    cached_token_.store(kNoCachedToken, std::memory_order_relaxed);
+    sequence_checker_.DetachFromSequence();
+  }
+
+  ALWAYS_INLINE
+  bool operator()() const NO_EXCEPTION
+  {
+    const ::base::SequenceToken token
+      = ::base::SequenceToken::GetForCurrentThread();
+
+    if(LIKELY(token.IsValid()
+       && token.ToInternalValue()
+            == cached_token_.load(std::memory_order_relaxed)))
+    {
+      return true;
+    }
+
+    return verifyAndCache(token);
+  }
+
+private:
+  using TokenValue
+    = decltype(std::declval<::base::SequenceToken>().ToInternalValue());
+
+  // Token values are positive, so it never matches valid token.
+  static constexpr TokenValue kNoCachedToken = -1;
+
+  NOINLINE
+  bool verifyAndCache(const ::base::SequenceToken& token) const NO_EXCEPTION
+  {
+    if(!sequence_checker_.CalledOnValidSequence())
+    {
+      return false;
+    }
+
+    // Can not cache result if code is not running inside of task.
+    if(token.IsValid())
+    {
+      cached_token_.store(token.ToInternalValue(), std::memory_order_relaxed);
+    }
+
+    return true;
+  }
+
+private:
+  // Binds to sequence on first call to `CalledOnValidSequence`
+  // (after `DetachFromSequence`).
+  mutable ::base::SequenceCheckerImpl sequence_checker_{};
+
+  mutable std::atomic<TokenValue> cached_token_{kNoCachedToken};
+
+  DISALLOW_COPY_AND_ASSIGN(StaticVerifySequence);
+};
+
+// Same as `CheckedOptional`, but verifier is template functor
+// (not `base::RepeatingCallback`).
+//
+// MOTIVATION
+//
+// `CheckedOptional` runs `base::RepeatingCallback` on each access
+// (indirect call that can not be inlined)
+// and each `*_unsafe` call creates `base::OnceClosure`.
+// That is too slow for hot code paths
+// (like per-packet state that uses `CheckedOptionalPolicy::Always`).
+// With `StaticCheckedOptional` each check can be inlined to single branch.
+//
+/// \note `VerifierType` must be default-constructible functor
+/// with signature `bool() const`.
+//
+// USAGE
+//
+//  ::basis::StaticCheckedOptional<
+//    PacketState
+//    , ::basis::CheckedOptionalPolicy::Always
+//    , ::basis::StaticVerifySequence
+//  > packetState_{
+//      ::basis::CheckedOptionalPermissions::All
+//      , ::base::in_place};
+//
+//  packetState_->onPacket(packet);
+template<
+  typename Type
+  , CheckedOptionalPolicy VerifyPolicyType
+  , typename VerifierType = StaticVerifySequence
+>
+class StaticCheckedOptional
+{
+public:
+  static_assert(
+    std::is_same<
+      decltype(std::declval<const VerifierType&>()())
+      , bool
+    >::value
+    , "VerifierType must have `bool operator()() const`");
+
+  explicit StaticCheckedOptional(
+    const ::basis::CheckedOptionalPermissions& permissions
+        = ::basis::CheckedOptionalPermissions::All)
+    : permissions_(permissions)
+  {
+    DCHECK(!value_);
+  }
+
+  /// \note you may want to pass `base::in_place` as second argument
+  template <class... Args>
+  StaticCheckedOptional(
+    const ::basis::CheckedOptionalPermissions& permissions
+    , Args&&... args)
+    : permissions_(permissions)
+    , value_(FORWARD(args)...)
+  {
+    DCHECK(value_);
+  }
+
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  bool runVerifier() const NO_EXCEPTION
+  {
+    return verifier_();
+  }
+
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  VerifierType& verifier() NO_EXCEPTION
+  {
+    return verifier_;
+  }
+
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  bool hasReadPermission() const NO_EXCEPTION
+  {
+    return ::basis::hasBit(permissions_
+      , ::basis::CheckedOptionalPermissions::Readable);
+  }
+
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  bool hasModifyPermission() const NO_EXCEPTION
+  {
+    return ::basis::hasBit(permissions_
+      , ::basis::CheckedOptionalPermissions::Modifiable);
+  }
+
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  ::base::Optional<Type>& optional()
+  {
+    verifyRead(FROM_HERE);
+    return value_;
+  }
+
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  const ::base::Optional<Type>& optional() const
+  {
+    verifyRead(FROM_HERE);
+    return value_;
+  }
+
+  // Similar to |optional|, but without thread-safety checks
+  // Usually you want to use *_unsafe in destructors
+  // (when data no longer used between threads)
+  /// \note `check_unsafe_allowed` is functor (not `base::OnceClosure`),
+  /// so it does not allocate.
+  /// It must have signature `bool()`, access fails (`CHECK`)
+  /// if it returns `false`.
+  template<typename CheckUnsafeType = StaticVerifyNothing>
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  ::base::Optional<Type>& optional_unsafe(
+    const ::base::Location& from_here
+    , ::base::StringPiece reason_why_using_unsafe
+    , CheckUnsafeType&& check_unsafe_allowed = CheckUnsafeType{})
+  {
+    verifyUnsafeAllowed(from_here
+      , reason_why_using_unsafe
+      , FORWARD(check_unsafe_allowed));
+    return value_;
+  }
+
+  template<typename CheckUnsafeType = StaticVerifyNothing>
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  const ::base::Optional<Type>& optional_unsafe(
+    const ::base::Location& from_here
+    , ::base::StringPiece reason_why_using_unsafe
+    , CheckUnsafeType&& check_unsafe_allowed = CheckUnsafeType{}) const
+  {
+    verifyUnsafeAllowed(from_here
+      , reason_why_using_unsafe
+      , FORWARD(check_unsafe_allowed));
+    return value_;
+  }
+
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  Type& value()
+  {
+    verifyRead(FROM_HERE);
+    verifyHasValue(FROM_HERE);
+    return value_.value();
+  }
+
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  const Type& value() const
+  {
+    verifyRead(FROM_HERE);
+    verifyHasValue(FROM_HERE);
+    return value_.value();
+  }
+
+  // Similar to |value|, but without thread-safety checks
+  template<typename CheckUnsafeType = StaticVerifyNothing>
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  Type& value_unsafe(
+    const ::base::Location& from_here
+    , ::base::StringPiece reason_why_using_unsafe
+    , CheckUnsafeType&& check_unsafe_allowed = CheckUnsafeType{})
+  {
+    verifyUnsafeAllowed(from_here
+      , reason_why_using_unsafe
+      , FORWARD(check_unsafe_allowed));
+    return value_.value();
+  }
+
+  template<typename CheckUnsafeType = StaticVerifyNothing>
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  const Type& value_unsafe(
+    const ::base::Location& from_here
+    , ::base::StringPiece reason_why_using_unsafe
+    , CheckUnsafeType&& check_unsafe_allowed = CheckUnsafeType{}) const
+  {
+    verifyUnsafeAllowed(from_here
+      , reason_why_using_unsafe
+      , FORWARD(check_unsafe_allowed));
+    return value_.value();
+  }
+
+  ALWAYS_INLINE
+  const Type& operator*() const
+  {
+    verifyRead(FROM_HERE);
+    verifyHasValue(FROM_HERE);
+    return value_.operator*();
+  }
+
+  ALWAYS_INLINE
+  Type& operator*()
+  {
+    verifyRead(FROM_HERE);
+    verifyHasValue(FROM_HERE);
+    return value_.operator*();
+  }
+
+  ALWAYS_INLINE
+  const Type* operator->() const
+  {
+    verifyRead(FROM_HERE);
+    verifyHasValue(FROM_HERE);
+    return value_.operator->();
+  }
+
+  ALWAYS_INLINE
+  Type* operator->()
+  {
+    verifyRead(FROM_HERE);
+    verifyHasValue(FROM_HERE);
+    return value_.operator->();
+  }
+
+  template<
+    class... Args
+  >
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  Type& emplace(
+    const ::base::Location& from_here
+    , Args&&... args)
+  {
+    DFAKE_SCOPED_RECURSIVE_LOCK(debug_thread_collision_warner_);
+
+    verifyModify(from_here);
+
+    return value_.emplace(FORWARD(args)...);
+  }
+
+  // Similar to |emplace|, but without thread-safety checks
+  template<
+    typename CheckUnsafeType
+    , class... Args
+  >
+  MUST_USE_RETURN_VALUE
+  ALWAYS_INLINE
+  Type& emplace_unsafe(
+    const ::base::Location& from_here
+    , ::base::StringPiece reason_why_using_unsafe
+    // usually you want to pass `::basis::StaticVerifyNothing{}` here
+    , CheckUnsafeType&& check_unsafe_allowed
+    , Args&&... args)
+  {
+    DFAKE_SCOPED_RECURSIVE_LOCK(debug_thread_collision_warner_);
+
+    verifyUnsafeAllowed(from_here
+      , reason_why_using_unsafe
+      , FORWARD(check_unsafe_allowed));
+
+    return value_.emplace(FORWARD(args)...);
+  }
+
+  void reset(const ::base::Location& from_here)
+  {
+    DFAKE_SCOPED_RECURSIVE_LOCK(debug_thread_collision_warner_);
+
+    verifyModify(from_here);
+
+    value_.reset();
+  }
+
+  template<typename CheckUnsafeType = StaticVerifyNothing>
+  void reset_unsafe(
+    const ::base::Location& from_here
+    , ::base::StringPiece reason_why_using_unsafe
+    , CheckUnsafeType&& check_unsafe_allowed = CheckUnsafeType{})
+  {
+    DFAKE_SCOPED_RECURSIVE_LOCK(debug_thread_collision_warner_);
+
+    verifyUnsafeAllowed(from_here
+      , reason_why_using_unsafe
+      , FORWARD(check_unsafe_allowed));
+
+    value_.reset();
+  }
+
+  void forceNotValidToRead(
+    const ::base::Location& from_here
+    , ::base::StringPiece reason_why_make_invalid)
+  {
+    DFAKE_SCOPED_RECURSIVE_LOCK(debug_thread_collision_warner_);
+
+    DCHECK(hasReadPermission());
+
+    UNREFERENCED_PARAMETER(from_here);
+    UNREFERENCED_PARAMETER(reason_why_make_invalid);
+
+    ::basis::removeBit(permissions_
+      , ::basis::CheckedOptionalPermissions::Readable);
+  }
+
+  void forceNotValidToModify(
+    const ::base::Location& from_here
+    , ::base::StringPiece reason_why_make_invalid)
+  {
+    DFAKE_SCOPED_RECURSIVE_LOCK(debug_thread_collision_warner_);
+
+    DCHECK(hasModifyPermission());
+
+    UNREFERENCED_PARAMETER(from_here);
+    UNREFERENCED_PARAMETER(reason_why_make_invalid);
+
+    ::basis::removeBit(permissions_
+      , ::basis::CheckedOptionalPermissions::Modifiable);
+  }
+
+  void forceValidToRead(
+    const ::base::Location& from_here
+    , ::base::StringPiece reason_why_make_valid)
+  {
+    DFAKE_SCOPED_RECURSIVE_LOCK(debug_thread_collision_warner_);
+
+    DCHECK(!hasReadPermission());
+
+    UNREFERENCED_PARAMETER(from_here);
+    UNREFERENCED_PARAMETER(reason_why_make_valid);
+
+    ::basis::addBit(permissions_
+      , ::basis::CheckedOptionalPermissions::Readable);
+  }
+
+  void forceValidToModify(
+    const ::base::Location& from_here
+    , ::base::StringPiece reason_why_make_valid)
+  {
+    DFAKE_SCOPED_RECURSIVE_LOCK(debug_thread_collision_warner_);
+
+    DCHECK(!hasModifyPermission());
+
+    UNREFERENCED_PARAMETER(from_here);
+    UNREFERENCED_PARAMETER(reason_why_make_valid);
+
+    ::basis::addBit(permissions_
+      , ::basis::CheckedOptionalPermissions::Modifiable);
+  }
+
+private:
+  ALWAYS_INLINE
+  void verifyRead(const ::base::Location& from_here) const
+  {
+    if constexpr (VerifyPolicyType == CheckedOptionalPolicy::Always)
+    {
+      CHECK(verifier_() && hasReadPermission())
+        << from_here.ToString();
+    }
+    else if constexpr (VerifyPolicyType == CheckedOptionalPolicy::DebugOnly
+      && DCHECK_IS_ON())
+    {
+      DCHECK(verifier_() && hasReadPermission())
+        << from_here.ToString();
+    }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(from_here, hasReadPermission());
+    }
+    else
+    {
+      UNREFERENCED_PARAMETER(from_here);
+    }
+  }
+
+  ALWAYS_INLINE
+  void verifyModify(const ::base::Location& from_here) const
+  {
+    if constexpr (VerifyPolicyType == CheckedOptionalPolicy::Always)
+    {
+      CHECK(verifier_() && hasModifyPermission())
+        << from_here.ToString();
+    }
+    else if constexpr (VerifyPolicyType == CheckedOptionalPolicy::DebugOnly
+      && DCHECK_IS_ON())
+    {
+      DCHECK(verifier_() && hasModifyPermission())
+        << from_here.ToString();
+    }
+    else if constexpr (isSampledCheckedOptionalPolicy(VerifyPolicyType))
+    {
+      runSampledVerifier(from_here, hasModifyPermission());
+    }
+    else
+    {
+      UNREFERENCED_PARAMETER(from_here);
+    }
+  }
+
+  template<typename CheckUnsafeType>
+  ALWAYS_INLINE
+  static void verifyUnsafeAllowed(
+    const ::base::Location& from_here
+    , ::base::StringPiece reason_why_using_unsafe
+    , CheckUnsafeType&& check_unsafe_allowed)
+  {
+    static_assert(
+      std::is_same<
+        decltype(std::declval<CheckUnsafeType&&>()())
+        , bool
+      >::value
+      , "check_unsafe_allowed must have `bool operator()()`");
+
+    CHECK(FORWARD(check_unsafe_allowed)())
+      << from_here.ToString()
+      << " "
+      << reason_why_using_unsafe;
+  }
+
+  ALWAYS_INLINE
+  void runSampledVerifier(
+    const ::base::Location& from_here
+    , bool has_permission) const NO_EXCEPTION
+  {
+    bool need_verify = false;
+    if constexpr (VerifyPolicyType == CheckedOptionalPolicy::Sampled)
+    {
+      uint32_t countdown
+        = sampling_countdown_.load(std::memory_order_relaxed);
+      need_verify = ::basis::internal::decrementSamplingCountdown(countdown);
+      sampling_countdown_.store(countdown, std::memory_order_relaxed);
+    }
+    else
+    {
+      need_verify = ::basis::internal::shouldSampleOnCurrentThread();
+    }
+
+    if(LIKELY(!need_verify))
+    {
+      return;
+    }
+
+    const bool verifier_passed = verifier_();
+    if(UNLIKELY(!verifier_passed || !has_permission))
+    {
+      ::basis::internal::reportCheckedOptionalViolation(
+        from_here, verifier_passed, has_permission);
+    }
+  }
+
+  ALWAYS_INLINE
+  void verifyHasValue(const ::base::Location& from_here) const
+  {
+    if constexpr (VerifyPolicyType == CheckedOptionalPolicy::Always)
+    {
+      CHECK(value_.has_value())
+        << from_here.ToString();
+    }
+    else
+    {
+      DCHECK(value_.has_value())
+        << from_here.ToString();
+    }
+  }
+
+private:
+  VerifierType verifier_{};
+
+  // Same as `CheckedOptional::CheckedOptionalPermissions`
+  ::basis::CheckedOptionalPermissions permissions_{
+    ::basis::CheckedOptionalPermissions::All};
+
+  ::base::Optional<Type> value_;
+
+  /// \note Thread collision warner used only for modification operations
+  /// because you may want to use unchangable storage
+  /// that can be read from multiple threads safely.
+  DFAKE_MUTEX(debug_thread_collision_warner_);
+
+  // Used only by `CheckedOptionalPolicy::Sampled`
+  mutable std::atomic<uint32_t> sampling_countdown_{0};
+
+  DISALLOW_COPY_AND_ASSIGN(StaticCheckedOptional);
+};
+
+} // namespace basis
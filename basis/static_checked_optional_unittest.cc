@@ -0,0 +1,156 @@
+#include "basis/static_checked_optional.h"
+
+#include "base/location.h"
+#include "base/optional.h"
+#include "base/sequence_token.h"
+#include "base/test/gtest_util.h"
+#include "base/threading/scoped_set_sequence_token_for_current_thread.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace basis {
+namespace {
+
+struct PacketState {
+  int counter = 0;
+};
+
+struct StaticVerifyFail {
+  bool operator()() const { return false; }
+};
+
+// Emulates task that runs on sequence,
+// so `SequenceToken::GetForCurrentThread()` is valid.
+class ScopedFakeSequence {
+ public:
+  explicit ScopedFakeSequence(
+      const base::SequenceToken& token = base::SequenceToken::Create())
+      : scoped_token_(token) {}
+
+ private:
+  base::ScopedSetSequenceTokenForCurrentThread scoped_token_;
+};
+
+TEST(StaticCheckedOptionalTest, AccessesValue) {
+  StaticCheckedOptional<PacketState, CheckedOptionalPolicy::Always,
+                        StaticVerifyNothing>
+      state{CheckedOptionalPermissions::All, base::in_place};
+
+  ++state->counter;
+  ++(*state).counter;
+  ++state.value().counter;
+  EXPECT_EQ(3, state.optional()->counter);
+
+  state.reset(FROM_HERE);
+  EXPECT_FALSE(state.optional_unsafe(FROM_HERE, "test").has_value());
+
+  ignore_result(state.emplace(FROM_HERE));
+  EXPECT_EQ(0, state->counter);
+}
+
+TEST(StaticCheckedOptionalTest, ChecksPermissions) {
+  StaticCheckedOptional<PacketState, CheckedOptionalPolicy::Always,
+                        StaticVerifyNothing>
+      state{CheckedOptionalPermissions::All, base::in_place};
+
+  state.forceNotValidToRead(FROM_HERE, "test");
+  EXPECT_FALSE(state.hasReadPermission());
+  EXPECT_DEATH_IF_SUPPORTED(ignore_result(state.value()), "");
+
+  // unsafe access skips permission checks
+  EXPECT_EQ(0, state.value_unsafe(FROM_HERE, "test").counter);
+
+  state.forceValidToRead(FROM_HERE, "test");
+  EXPECT_EQ(0, state->counter);
+
+  state.forceNotValidToModify(FROM_HERE, "test");
+  EXPECT_DEATH_IF_SUPPORTED(state.reset(FROM_HERE), "");
+}
+
+TEST(StaticCheckedOptionalTest, ChecksUnsafeVerifierResult) {
+  StaticCheckedOptional<PacketState, CheckedOptionalPolicy::Always,
+                        StaticVerifyNothing>
+      state{CheckedOptionalPermissions::All, base::in_place};
+
+  EXPECT_EQ(0, state.value_unsafe(FROM_HERE, "test", StaticVerifyNothing{})
+                   .counter);
+  EXPECT_DEATH_IF_SUPPORTED(
+      ignore_result(state.value_unsafe(FROM_HERE, "test", StaticVerifyFail{})),
+      "");
+  EXPECT_DEATH_IF_SUPPORTED(
+      state.reset_unsafe(FROM_HERE, "test", StaticVerifyFail{}), "");
+}
+
+TEST(StaticCheckedOptionalTest, VerifySequenceBindsToFirstSequence) {
+  const base::SequenceToken first_sequence = base::SequenceToken::Create();
+  StaticVerifySequence verifier;
+
+  {
+    ScopedFakeSequence sequence(first_sequence);
+    EXPECT_TRUE(verifier());
+    // cached result
+    EXPECT_TRUE(verifier());
+  }
+
+  {
+    ScopedFakeSequence sequence;
+    EXPECT_FALSE(verifier());
+  }
+
+  {
+    ScopedFakeSequence sequence(first_sequence);
+    EXPECT_TRUE(verifier());
+  }
+}
+
+TEST(StaticCheckedOptionalTest, VerifySequenceRebindsAfterDetach) {
+  const base::SequenceToken first_sequence = base::SequenceToken::Create();
+  const base::SequenceToken second_sequence = base::SequenceToken::Create();
+  StaticVerifySequence verifier;
+
+  {
+    ScopedFakeSequence sequence(first_sequence);
+    EXPECT_TRUE(verifier());
+  }
+
+  verifier.DetachFromSequence();
+
+  {
+    ScopedFakeSequence sequence(second_sequence);
+    EXPECT_TRUE(verifier());
+  }
+
+  {
+    // cached token of first sequence must be reset by detach
+    ScopedFakeSequence sequence(first_sequence);
+    EXPECT_FALSE(verifier());
+  }
+}
+
+TEST(StaticCheckedOptionalTest, FailsOnWrongSequence) {
+  StaticCheckedOptional<PacketState, CheckedOptionalPolicy::Always,
+                        StaticVerifySequence>
+      state{CheckedOptionalPermissions::All, base::in_place};
+
+  {
+    ScopedFakeSequence sequence;
+    ++state->counter;
+  }
+
+  {
+    ScopedFakeSequence sequence;
+    EXPECT_FALSE(state.runVerifier());
+    EXPECT_DEATH_IF_SUPPORTED(++state->counter, "");
+  }
+
+  state.verifier().DetachFromSequence();
+
+  {
+    ScopedFakeSequence sequence;
+    EXPECT_TRUE(state.runVerifier());
+    EXPECT_EQ(1, state->counter);
+  }
+}
+
+}  // namespace
+}  // namespace basis
@@ -14,6 +14,8 @@
 #include <base/time/default_clock.h>
 #include <basic/rvalue_cast.h>
 
+#include "basis/memory/scoped_memory_dump_provider.h"
+
 #define MAKE_SURE_OWN_THREAD(callback, ...)                                    \
   if (!task_runner_->BelongsToCurrentThread()) {                               \
     task_runner_->PostTask(                                                    \
@@ -101,4 +103,16 @@ void AlarmManager::CheckAlarm() {
   }
 }
 
+void AlarmManager::DumpMemoryStats(const std::string& dump_name,
+                                   base::trace_event::ProcessMemoryDump* pmd) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  // Each alarm is a heap allocated AlarmInfo plus a slot in the queue.
+  // Does not include memory owned by bound arguments of tasks.
+  basis::addAllocatorDump(
+      pmd, dump_name,
+      next_alarm_.size() *
+          (sizeof(AlarmInfo) + sizeof(std::unique_ptr<AlarmInfo>)),
+      next_alarm_.size());
+}
+
 }  // namespace basis
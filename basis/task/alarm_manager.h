@@ -7,6 +7,7 @@
 #include <functional>
 #include <memory>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "base/callback.h"
@@ -18,6 +19,9 @@
 namespace base {
 class Clock;
 class SingleThreadTaskRunner;
+namespace trace_event {
+class ProcessMemoryDump;
+}  // namespace trace_event
 }
 
 namespace basis {
@@ -60,6 +64,17 @@ class AlarmManager {
                                              base::Time time)
       WARN_UNUSED_RESULT;
 
+  // Adds allocator dump |dump_name| (memory used by pending alarms)
+  // to |pmd|. Must be called on the thread of alarm manager,
+  // see ScopedMemoryDumpProvider.
+  void DumpMemoryStats(const std::string& dump_name,
+                       base::trace_event::ProcessMemoryDump* pmd);
+
+  // Task runner used to poll the clock.
+  const scoped_refptr<base::SingleThreadTaskRunner>& task_runner() const {
+    return task_runner_;
+  }
+
  private:
   class AlarmInfo {
    public:
@@ -0,0 +1,68 @@
+#include "basis/task/alarm_manager.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/test/simple_test_clock.h"
+#include "base/test/task_environment.h"
+#include "base/threading/thread_task_runner_handle.h"
+
+#include <benchmark/benchmark.h>
+
+namespace basis {
+
+namespace {
+
+void IncrementCounter(int* counter) {
+  ++(*counter);
+}
+
+// Inserts `state.range(0)` alarms and fires all of them
+// (uses mock time, so benchmark does not wait for polling interval).
+void BM_AlarmManagerInsertFire(benchmark::State& state) {
+  base::test::SingleThreadTaskEnvironment task_environment{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+
+  const int alarms_count = state.range(0);
+
+  base::SimpleTestClock clock;
+  clock.SetNow(base::Time::Now());
+
+  AlarmManager manager(&clock, base::ThreadTaskRunnerHandle::Get());
+
+  std::vector<std::unique_ptr<AlarmHandle>> handles;
+  handles.reserve(alarms_count);
+
+  int fired = 0;
+
+  for (auto _ : state) {
+    const base::Time now = clock.Now();
+    for (int i = 0; i < alarms_count; ++i) {
+      handles.push_back(manager.PostAlarmTask(
+        base::BindOnce(&IncrementCounter, base::Unretained(&fired))
+        , now + base::TimeDelta::FromMilliseconds(
+            (i * 7919) % alarms_count)));
+    }
+
+    clock.Advance(base::TimeDelta::FromMilliseconds(alarms_count));
+    // trigger `AlarmManager::CheckAlarm` (polls each 5 seconds)
+    task_environment.FastForwardBy(base::TimeDelta::FromSeconds(5));
+
+    state.PauseTiming();
+    handles.clear();
+    state.ResumeTiming();
+  }
+
+  CHECK_EQ(fired, state.iterations() * alarms_count);
+  state.SetItemsProcessed(state.iterations() * alarms_count);
+}
+BENCHMARK(BM_AlarmManagerInsertFire)
+  ->ArgName("alarms")
+  ->Arg(16)
+  ->Arg(256)
+  ->Arg(4096);
+
+}  // namespace
+
+}  // namespace basis
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <base/compiler_specific.h>
+
+#include <atomic>
+
+namespace basis {
+
+// Raises `max_value` to `value` if `value` is greater.
+// Lock-free, so can be used by telemetry on hot paths.
+/// \note uses relaxed memory order (only final value matters).
+template <typename T>
+ALWAYS_INLINE
+void updateAtomicMax(std::atomic<T>& max_value, T value)
+{
+  T prev = max_value.load(std::memory_order_relaxed);
+  while(prev < value
+        && !max_value.compare_exchange_weak(
+              prev, value, std::memory_order_relaxed))
+  {
+  }
+}
+
+} // namespace basis
@@ -0,0 +1,309 @@
+#include "basis/task/bounded_sequenced_task_runner.h" // IWYU pragma: associated
+
+#include "basis/task/atomic_max.h"
+
+#include <base/bind.h>
+#include <base/logging.h>
+#include <base/metrics/histogram.h>
+#include <base/trace_event/trace_event.h>
+
+#include <basic/rvalue_cast.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace basis {
+
+struct BoundedSequencedTaskRunner::CapacityWaiter
+{
+  CapacityWaiter(const ::base::Location& from_here, size_t cost_bytes)
+    : cost_bytes(cost_bytes)
+    , resolver(from_here)
+  {}
+
+  const size_t cost_bytes;
+
+  ::base::ManualPromiseResolver<void, ::base::NoReject> resolver;
+};
+
+BoundedSequencedTaskRunner::BoundedSequencedTaskRunner(
+  const std::string& name
+  , scoped_refptr<::base::SequencedTaskRunner> task_runner
+  , const Options& options
+  , LoadSheddingCallback load_shedding_callback)
+  : name_(name)
+  , task_runner_(RVALUE_CAST(task_runner))
+  , options_(options)
+  , load_shedding_callback_(RVALUE_CAST(load_shedding_callback))
+  , queue_depth_histogram_(
+      ::base::Histogram::FactoryGet(
+        "Basis.TaskRunner." + name + ".BoundedQueueDepth"
+        , 1
+        , 100000
+        , 50
+        , ::base::HistogramBase::kUmaTargetedHistogramFlag))
+{
+  DCHECK(!name_.empty());
+  DCHECK(task_runner_);
+}
+
+BoundedSequencedTaskRunner::~BoundedSequencedTaskRunner()
+{
+  /// \note promises of remaining waiters are never resolved
+  /// (same as tasks of destroyed task runner are never run)
+  ::base::AutoLock lock(capacity_waiters_lock_);
+  DLOG_IF(WARNING, !capacity_waiters_.empty())
+    << "destroyed task runner " << name_
+    << " with " << capacity_waiters_.size()
+    << " producers waiting for capacity";
+}
+
+bool BoundedSequencedTaskRunner::TryPostTask(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , size_t cost_bytes)
+{
+  return TryPostDelayedTask(
+    from_here
+    , RVALUE_CAST(task)
+    , ::base::TimeDelta()
+    , cost_bytes);
+}
+
+bool BoundedSequencedTaskRunner::TryPostDelayedTask(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , ::base::TimeDelta delay
+  , size_t cost_bytes)
+{
+  if(!tryAcquire(from_here, cost_bytes))
+  {
+    return false;
+  }
+
+  return postAcquired(
+    from_here
+    , RVALUE_CAST(task)
+    , delay
+    , cost_bytes
+    , /* nestable */ true);
+}
+
+bool BoundedSequencedTaskRunner::PostDelayedTask(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , ::base::TimeDelta delay)
+{
+  return TryPostDelayedTask(from_here, RVALUE_CAST(task), delay);
+}
+
+bool BoundedSequencedTaskRunner::PostNonNestableDelayedTask(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , ::base::TimeDelta delay)
+{
+  if(!tryAcquire(from_here, 0))
+  {
+    return false;
+  }
+
+  return postAcquired(
+    from_here
+    , RVALUE_CAST(task)
+    , delay
+    , 0
+    , /* nestable */ false);
+}
+
+bool BoundedSequencedTaskRunner::RunsTasksInCurrentSequence() const
+{
+  return task_runner_->RunsTasksInCurrentSequence();
+}
+
+bool BoundedSequencedTaskRunner::HasCapacity(size_t cost_bytes) const
+{
+  if(options_.max_queue_depth
+     && queue_depth_.load(std::memory_order_relaxed)
+          >= options_.max_queue_depth)
+  {
+    return false;
+  }
+
+  if(options_.max_queued_bytes
+     && queued_bytes_.load(std::memory_order_relaxed) + cost_bytes
+          > options_.max_queued_bytes)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+BoundedSequencedTaskRunner::VoidPromise
+  BoundedSequencedTaskRunner::PromiseCapacity(
+    const ::base::Location& from_here
+    , size_t cost_bytes)
+{
+  DCHECK(!options_.max_queued_bytes
+         || cost_bytes <= options_.max_queued_bytes)
+    << "task will never fit into budget of " << name_;
+
+  auto waiter = std::make_unique<CapacityWaiter>(from_here, cost_bytes);
+  VoidPromise promise = waiter->resolver.promise();
+
+  {
+    ::base::AutoLock lock(capacity_waiters_lock_);
+    capacity_waiters_.push_back(RVALUE_CAST(waiter));
+    capacity_waiters_count_.fetch_add(1, std::memory_order_seq_cst);
+  }
+
+  // capacity may be already available
+  // (or released before waiter was added)
+  resolveCapacityWaiters();
+
+  return promise;
+}
+
+bool BoundedSequencedTaskRunner::tryAcquire(
+  const ::base::Location& from_here
+  , size_t cost_bytes)
+{
+  const size_t depth
+    = queue_depth_.fetch_add(1, std::memory_order_relaxed) + 1;
+  const size_t bytes
+    = queued_bytes_.fetch_add(cost_bytes, std::memory_order_relaxed)
+      + cost_bytes;
+
+  const bool fits
+    = (!options_.max_queue_depth || depth <= options_.max_queue_depth)
+      && (!options_.max_queued_bytes || bytes <= options_.max_queued_bytes);
+
+  if(!fits)
+  {
+    queue_depth_.fetch_sub(1, std::memory_order_relaxed);
+    queued_bytes_.fetch_sub(cost_bytes, std::memory_order_relaxed);
+    tasks_rejected_.fetch_add(1, std::memory_order_relaxed);
+
+    TRACE_EVENT_INSTANT1("basis.task_runner"
+      , "BoundedSequencedTaskRunner::Reject"
+      , TRACE_EVENT_SCOPE_THREAD
+      , "name", name_);
+
+    if(load_shedding_callback_)
+    {
+      load_shedding_callback_.Run(from_here, depth - 1, bytes - cost_bytes);
+    }
+    return false;
+  }
+
+  tasks_posted_.fetch_add(1, std::memory_order_relaxed);
+  updateAtomicMax(max_queue_depth_, depth);
+  recordQueueDepth(depth);
+  return true;
+}
+
+void BoundedSequencedTaskRunner::release(size_t cost_bytes)
+{
+  const size_t depth
+    = queue_depth_.fetch_sub(1, std::memory_order_seq_cst) - 1;
+  queued_bytes_.fetch_sub(cost_bytes, std::memory_order_seq_cst);
+
+  TRACE_COUNTER_ID1("basis.task_runner", "BoundedQueueDepth", this, depth);
+
+  if(capacity_waiters_count_.load(std::memory_order_seq_cst) != 0)
+  {
+    resolveCapacityWaiters();
+  }
+}
+
+bool BoundedSequencedTaskRunner::postAcquired(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , ::base::TimeDelta delay
+  , size_t cost_bytes
+  , bool nestable)
+{
+  DCHECK(task) << from_here.ToString();
+
+  // Capacity is released when task is done
+  // or destroyed without run (if it was not posted
+  // or task runner is shutting down).
+  // Keeps `this` alive until then.
+  ::base::OnceClosure wrapped_task
+    = ::base::BindOnce(
+        &BoundedSequencedTaskRunner::runTask
+        , RVALUE_CAST(task)
+        , ::base::ScopedClosureRunner(::base::BindOnce(
+            &BoundedSequencedTaskRunner::release
+            , scoped_refptr<BoundedSequencedTaskRunner>(this)
+            , cost_bytes)));
+
+  return nestable
+    ? task_runner_->PostDelayedTask(
+        from_here, RVALUE_CAST(wrapped_task), delay)
+    : task_runner_->PostNonNestableDelayedTask(
+        from_here, RVALUE_CAST(wrapped_task), delay);
+}
+
+// static
+void BoundedSequencedTaskRunner::runTask(
+  ::base::OnceClosure task
+  , ::base::ScopedClosureRunner release_guard)
+{
+  RVALUE_CAST(task).Run();
+
+  release_guard.RunAndReset();
+}
+
+void BoundedSequencedTaskRunner::resolveCapacityWaiters()
+{
+  std::vector<std::unique_ptr<CapacityWaiter>> ready;
+
+  {
+    ::base::AutoLock lock(capacity_waiters_lock_);
+    // resolve in order of waiting,
+    // so large tasks are not starved by small ones
+    while(!capacity_waiters_.empty()
+          && HasCapacity(capacity_waiters_.front()->cost_bytes))
+    {
+      ready.push_back(RVALUE_CAST(capacity_waiters_.front()));
+      capacity_waiters_.pop_front();
+    }
+    capacity_waiters_count_.store(
+      capacity_waiters_.size(), std::memory_order_seq_cst);
+  }
+
+  // resolve without lock
+  for(std::unique_ptr<CapacityWaiter>& waiter: ready)
+  {
+    waiter->resolver.Resolve();
+  }
+}
+
+void BoundedSequencedTaskRunner::recordQueueDepth(size_t depth)
+{
+  queue_depth_histogram_->Add(static_cast<int>(
+    std::min<size_t>(depth, std::numeric_limits<int>::max())));
+  TRACE_COUNTER_ID1("basis.task_runner", "BoundedQueueDepth", this, depth);
+}
+
+BoundedSequencedTaskRunner::Snapshot
+  BoundedSequencedTaskRunner::GetSnapshot() const
+{
+  Snapshot snapshot;
+  snapshot.queue_depth
+    = queue_depth_.load(std::memory_order_relaxed);
+  snapshot.max_queue_depth
+    = max_queue_depth_.load(std::memory_order_relaxed);
+  snapshot.queued_bytes
+    = queued_bytes_.load(std::memory_order_relaxed);
+  snapshot.tasks_posted
+    = tasks_posted_.load(std::memory_order_relaxed);
+  snapshot.tasks_rejected
+    = tasks_rejected_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+} // namespace basis
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <base/callback.h>
+#include <base/callback_helpers.h>
+#include <base/location.h>
+#include <base/macros.h>
+#include <base/memory/scoped_refptr.h>
+#include <base/sequenced_task_runner.h>
+#include <base/synchronization/lock.h>
+#include <base/thread_annotations.h>
+#include <base/time/time.h>
+
+#include <basic/macros.h>
+#include <basic/promise/promise.h>
+#include <basic/promise/post_promise.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace base {
+class HistogramBase;
+} // namespace base
+
+namespace basis {
+
+// Decorator for `base::SequencedTaskRunner` that limits number
+// of queued tasks (posted, but not finished yet) and/or their total cost
+// in bytes (provided by caller), so slow sequence (like ENTT)
+// can not grow memory until OOM during overload.
+//
+// Task that does not fit into budget is rejected:
+// it is destroyed without run, `PostTask` returns `false`
+// and `load_shedding_callback` is called.
+//
+// Producers can wait for capacity using `PromiseCapacity`.
+//
+// Queue depth is exported:
+// * as histogram `Basis.TaskRunner.<name>.BoundedQueueDepth`
+// * as trace counter `BoundedQueueDepth` (category `basis.task_runner`)
+// * via `GetSnapshot()`
+//
+/// \note Budget limits only tasks posted via this task runner.
+/// \note Tasks posted with `PostTask` have zero cost in bytes,
+/// use `TryPostTask` to provide cost.
+//
+// USAGE
+//
+//  ::basis::BoundedSequencedTaskRunner::Options options;
+//  options.max_queue_depth = 10000;
+//  options.max_queued_bytes = 64 * 1024 * 1024;
+//
+//  scoped_refptr<::basis::BoundedSequencedTaskRunner> enttRunner
+//    = ::base::MakeRefCounted<::basis::BoundedSequencedTaskRunner>(
+//        "ENTT"
+//        , APP_RUNNER(ENTT)
+//        , options
+//        , ::base::BindRepeating(&onEnttOverloaded));
+//
+//  if(!enttRunner->TryPostTask(FROM_HERE
+//       , ::base::BindOnce(&handleMessage, RVALUE_CAST(message))
+//       , messageSize))
+//  {
+//    // ask client to retry later
+//  }
+class BoundedSequencedTaskRunner
+  : public ::base::SequencedTaskRunner
+{
+ public:
+  using VoidPromise
+    = ::base::Promise<void, ::base::NoReject>;
+
+  // Called on thread that posted rejected task.
+  using LoadSheddingCallback
+    = ::base::RepeatingCallback<
+        void(const ::base::Location& from_here
+          , size_t queue_depth
+          , size_t queued_bytes)
+      >;
+
+  struct Options
+  {
+    // Maximum number of queued tasks (zero means unlimited).
+    size_t max_queue_depth = 0;
+
+    // Maximum total cost of queued tasks (zero means unlimited).
+    size_t max_queued_bytes = 0;
+  };
+
+  struct Snapshot
+  {
+    size_t queue_depth = 0;
+    size_t max_queue_depth = 0;
+    size_t queued_bytes = 0;
+    uint64_t tasks_posted = 0;
+    uint64_t tasks_rejected = 0;
+  };
+
+  BoundedSequencedTaskRunner(
+    const std::string& name
+    , scoped_refptr<::base::SequencedTaskRunner> task_runner
+    , const Options& options
+    , LoadSheddingCallback load_shedding_callback = LoadSheddingCallback());
+
+  // Returns `false` if task does not fit into budget
+  // (task is destroyed without run).
+  MUST_USE_RETURN_VALUE
+  bool TryPostTask(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , size_t cost_bytes = 0);
+
+  MUST_USE_RETURN_VALUE
+  bool TryPostDelayedTask(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , ::base::TimeDelta delay
+    , size_t cost_bytes = 0);
+
+  // Returns promise that is resolved when task with `cost_bytes`
+  // fits into budget.
+  /// \note does not reserve capacity, so `TryPostTask` may still fail
+  /// if other producers posted tasks before.
+  /// \note promise is resolved on thread that released capacity
+  /// (use `ThenOn` or `ThenHere` to continue on required sequence).
+  MUST_USE_RETURN_VALUE
+  VoidPromise PromiseCapacity(
+    const ::base::Location& from_here
+    , size_t cost_bytes = 0);
+
+  MUST_USE_RETURN_VALUE
+  bool HasCapacity(size_t cost_bytes = 0) const;
+
+  // base::SequencedTaskRunner
+  bool PostDelayedTask(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , ::base::TimeDelta delay) override;
+
+  bool PostNonNestableDelayedTask(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , ::base::TimeDelta delay) override;
+
+  bool RunsTasksInCurrentSequence() const override;
+
+  MUST_USE_RETURN_VALUE
+  Snapshot GetSnapshot() const;
+
+  const std::string& name() const
+  {
+    return name_;
+  }
+
+  const Options& options() const
+  {
+    return options_;
+  }
+
+  // Returns decorated task runner.
+  const scoped_refptr<::base::SequencedTaskRunner>& task_runner() const
+  {
+    return task_runner_;
+  }
+
+ private:
+  struct CapacityWaiter;
+
+  ~BoundedSequencedTaskRunner() override;
+
+  // Reserves capacity for task.
+  // Returns `false` (and calls `load_shedding_callback_`) if task
+  // does not fit into budget.
+  bool tryAcquire(
+    const ::base::Location& from_here
+    , size_t cost_bytes);
+
+  void release(size_t cost_bytes);
+
+  // Posts task with reserved capacity.
+  bool postAcquired(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , ::base::TimeDelta delay
+    , size_t cost_bytes
+    , bool nestable);
+
+  static void runTask(
+    ::base::OnceClosure task
+    , ::base::ScopedClosureRunner release_guard);
+
+  // Resolves promises of waiters that fit into budget.
+  void resolveCapacityWaiters();
+
+  void recordQueueDepth(size_t depth);
+
+ private:
+  const std::string name_;
+
+  scoped_refptr<::base::SequencedTaskRunner> task_runner_;
+
+  const Options options_;
+
+  const LoadSheddingCallback load_shedding_callback_;
+
+  std::atomic<size_t> queue_depth_{0};
+
+  std::atomic<size_t> max_queue_depth_{0};
+
+  std::atomic<size_t> queued_bytes_{0};
+
+  std::atomic<uint64_t> tasks_posted_{0};
+
+  std::atomic<uint64_t> tasks_rejected_{0};
+
+  // Number of elements in `capacity_waiters_`
+  // (allows to skip lock if nobody waits).
+  std::atomic<size_t> capacity_waiters_count_{0};
+
+  ::base::Lock capacity_waiters_lock_;
+
+  std::deque<std::unique_ptr<CapacityWaiter>> capacity_waiters_
+    GUARDED_BY(capacity_waiters_lock_);
+
+  // Owned by `base::StatisticsRecorder`.
+  ::base::HistogramBase* queue_depth_histogram_;
+
+  DISALLOW_COPY_AND_ASSIGN(BoundedSequencedTaskRunner);
+};
+
+} // namespace basis
@@ -0,0 +1,107 @@
+#include "basis/task/bounded_sequenced_task_runner.h"
+
+#include "base/bind.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace basis {
+namespace {
+
+class BoundedSequencedTaskRunnerTest : public testing::Test {
+ protected:
+  scoped_refptr<BoundedSequencedTaskRunner> CreateTaskRunner(
+      const BoundedSequencedTaskRunner::Options& options) {
+    return base::MakeRefCounted<BoundedSequencedTaskRunner>(
+        "BoundedTest", base::SequencedTaskRunnerHandle::Get(), options,
+        base::BindRepeating(
+            [](int* shed_count, const base::Location&, size_t, size_t) {
+              ++(*shed_count);
+            },
+            base::Unretained(&shed_count_)));
+  }
+
+  base::OnceClosure Increment() {
+    return base::BindOnce([](int* counter) { ++(*counter); },
+                          base::Unretained(&counter_));
+  }
+
+  base::test::TaskEnvironment task_environment_;
+
+  int counter_ = 0;
+
+  int shed_count_ = 0;
+};
+
+TEST_F(BoundedSequencedTaskRunnerTest, RejectsTasksOverQueueDepth) {
+  BoundedSequencedTaskRunner::Options options;
+  options.max_queue_depth = 2;
+  scoped_refptr<BoundedSequencedTaskRunner> task_runner =
+      CreateTaskRunner(options);
+
+  EXPECT_TRUE(task_runner->TryPostTask(FROM_HERE, Increment()));
+  EXPECT_TRUE(task_runner->PostTask(FROM_HERE, Increment()));
+  EXPECT_FALSE(task_runner->HasCapacity());
+  EXPECT_FALSE(task_runner->TryPostTask(FROM_HERE, Increment()));
+  EXPECT_FALSE(task_runner->PostTask(FROM_HERE, Increment()));
+  EXPECT_EQ(2, shed_count_);
+
+  BoundedSequencedTaskRunner::Snapshot queued = task_runner->GetSnapshot();
+  EXPECT_EQ(2u, queued.queue_depth);
+  EXPECT_EQ(2u, queued.tasks_posted);
+  EXPECT_EQ(2u, queued.tasks_rejected);
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(2, counter_);
+  EXPECT_EQ(0u, task_runner->GetSnapshot().queue_depth);
+  EXPECT_TRUE(task_runner->HasCapacity());
+}
+
+TEST_F(BoundedSequencedTaskRunnerTest, RejectsTasksOverByteBudget) {
+  BoundedSequencedTaskRunner::Options options;
+  options.max_queued_bytes = 100;
+  scoped_refptr<BoundedSequencedTaskRunner> task_runner =
+      CreateTaskRunner(options);
+
+  EXPECT_TRUE(task_runner->TryPostTask(FROM_HERE, Increment(), 60));
+  EXPECT_FALSE(task_runner->TryPostTask(FROM_HERE, Increment(), 50));
+  EXPECT_TRUE(task_runner->TryPostTask(FROM_HERE, Increment(), 40));
+  EXPECT_EQ(100u, task_runner->GetSnapshot().queued_bytes);
+  EXPECT_EQ(1, shed_count_);
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(2, counter_);
+  EXPECT_EQ(0u, task_runner->GetSnapshot().queued_bytes);
+}
+
+TEST_F(BoundedSequencedTaskRunnerTest, PromiseCapacity) {
+  BoundedSequencedTaskRunner::Options options;
+  options.max_queue_depth = 1;
+  scoped_refptr<BoundedSequencedTaskRunner> task_runner =
+      CreateTaskRunner(options);
+
+  EXPECT_TRUE(task_runner->TryPostTask(FROM_HERE, Increment()));
+
+  bool has_capacity = false;
+  task_runner->PromiseCapacity(FROM_HERE).ThenHere(
+      FROM_HERE,
+      base::BindOnce(
+          [](bool* has_capacity,
+             scoped_refptr<BoundedSequencedTaskRunner> task_runner) {
+            *has_capacity = task_runner->HasCapacity();
+          },
+          base::Unretained(&has_capacity), task_runner));
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(1, counter_);
+  EXPECT_TRUE(has_capacity);
+}
+
+}  // namespace
+}  // namespace basis
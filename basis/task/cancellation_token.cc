@@ -0,0 +1,258 @@
+#include "basis/task/cancellation_token.h" // IWYU pragma: associated
+
+#include <base/trace_event/trace_event.h>
+
+#include <algorithm>
+
+namespace basis {
+
+namespace {
+
+// Minimal size of `nodes_` that triggers pruning.
+constexpr size_t kMinPruneThreshold = 16;
+
+} // namespace
+
+// Cancels child when parent is cancelled.
+// Child resets link on destruction, so parent never touches destroyed child.
+class CancellationToken::ChildLink
+  : public CancellationToken::Node
+{
+ public:
+  explicit ChildLink(CancellationToken* child)
+    : child_(child)
+  {
+    DCHECK(child_);
+  }
+
+  void OnCancelled() override
+  {
+    DetachedWork work;
+    {
+      // child can not be destroyed while lock is held
+      ::base::AutoLock lock(lock_);
+      if(child_)
+      {
+        work = child_->detachOnCancel();
+      }
+    }
+    // child may be destroyed from now on
+    work.Run();
+  }
+
+  void Reset()
+  {
+    ::base::AutoLock lock(lock_);
+    child_ = nullptr;
+  }
+
+ private:
+  ~ChildLink() override = default;
+
+  ::base::Lock lock_;
+
+  CancellationToken* child_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(ChildLink);
+};
+
+CancellationToken::DetachedWork::DetachedWork() = default;
+
+CancellationToken::DetachedWork::DetachedWork(
+  DetachedWork&& other) = default;
+
+CancellationToken::DetachedWork&
+  CancellationToken::DetachedWork::operator=(
+    DetachedWork&& other) = default;
+
+CancellationToken::DetachedWork::~DetachedWork() = default;
+
+void CancellationToken::DetachedWork::Run()
+{
+  for(scoped_refptr<Node>& node: nodes)
+  {
+    node->OnCancelled();
+  }
+  nodes.clear();
+
+  for(::base::OnceClosure& callback: callbacks)
+  {
+    RVALUE_CAST(callback).Run();
+  }
+  callbacks.clear();
+}
+
+CancellationToken::CancellationToken()
+  : prune_threshold_(kMinPruneThreshold)
+{}
+
+CancellationToken::~CancellationToken()
+{
+  if(parent_link_)
+  {
+    parent_link_->Reset();
+  }
+}
+
+// static
+scoped_refptr<CancellationToken> CancellationToken::CreateWithTimeout(
+  const ::base::Location& from_here
+  , scoped_refptr<::base::SequencedTaskRunner> task_runner
+  , ::base::TimeDelta timeout)
+{
+  scoped_refptr<CancellationToken> token
+    = ::base::MakeRefCounted<CancellationToken>();
+  token->setTimeout(from_here, RVALUE_CAST(task_runner), timeout);
+  return token;
+}
+
+scoped_refptr<CancellationToken> CancellationToken::CreateChild()
+{
+  scoped_refptr<CancellationToken> child
+    = ::base::MakeRefCounted<CancellationToken>();
+  child->deadline_ = deadline_;
+  child->parent_link_ = ::base::MakeRefCounted<ChildLink>(child.get());
+
+  // cancels child immediately if parent is already cancelled
+  RegisterNode(child->parent_link_);
+
+  return child;
+}
+
+scoped_refptr<CancellationToken> CancellationToken::CreateChildWithTimeout(
+  const ::base::Location& from_here
+  , scoped_refptr<::base::SequencedTaskRunner> task_runner
+  , ::base::TimeDelta timeout)
+{
+  scoped_refptr<CancellationToken> child = CreateChild();
+  child->setTimeout(from_here, RVALUE_CAST(task_runner), timeout);
+  return child;
+}
+
+void CancellationToken::setTimeout(
+  const ::base::Location& from_here
+  , scoped_refptr<::base::SequencedTaskRunner> task_runner
+  , ::base::TimeDelta timeout)
+{
+  DCHECK(task_runner);
+
+  const ::base::TimeTicks deadline = ::base::TimeTicks::Now() + timeout;
+  if(deadline_.is_null() || deadline < deadline_)
+  {
+    deadline_ = deadline;
+  }
+
+  task_runner->PostDelayedTask(
+    from_here
+    , ::base::BindOnce(
+        &CancellationToken::Cancel
+        , scoped_refptr<CancellationToken>(this))
+    , timeout);
+}
+
+void CancellationToken::Cancel()
+{
+  TRACE_EVENT0("headless", "CancellationToken::Cancel");
+
+  detachOnCancel().Run();
+}
+
+bool CancellationToken::IsCancelled() const
+{
+  if(cancelled_.load(std::memory_order_acquire))
+  {
+    return true;
+  }
+
+  return !deadline_.is_null()
+    && ::base::TimeTicks::Now() >= deadline_;
+}
+
+void CancellationToken::AddCancellationCallback(
+  ::base::OnceClosure callback)
+{
+  DCHECK(callback);
+
+  {
+    ::base::AutoLock lock(lock_);
+    if(!cancelled_.load(std::memory_order_acquire))
+    {
+      callbacks_.push_back(RVALUE_CAST(callback));
+      return;
+    }
+  }
+
+  RVALUE_CAST(callback).Run();
+}
+
+void CancellationToken::RegisterNode(scoped_refptr<Node> node)
+{
+  DCHECK(node);
+
+  {
+    ::base::AutoLock lock(lock_);
+    /// \note `Cancel` sets flag before it takes lock,
+    /// so node is either added before `Cancel` takes nodes
+    /// or flag is visible here.
+    if(!cancelled_.load(std::memory_order_acquire))
+    {
+      if(nodes_.size() >= prune_threshold_)
+      {
+        pruneReleasedNodes();
+      }
+      nodes_.push_back(RVALUE_CAST(node));
+      return;
+    }
+  }
+
+  node->OnCancelled();
+}
+
+CancellationToken::DetachedWork CancellationToken::detachOnCancel()
+{
+  DetachedWork work;
+
+  if(cancelled_.exchange(true, std::memory_order_acq_rel))
+  {
+    return work;
+  }
+
+  ::base::AutoLock lock(lock_);
+  work.nodes.swap(nodes_);
+  work.callbacks.swap(callbacks_);
+  return work;
+}
+
+void CancellationToken::pruneReleasedNodes()
+{
+  // node with single reference is referenced only by token
+  nodes_.erase(
+    std::remove_if(nodes_.begin(), nodes_.end()
+      , [](const scoped_refptr<Node>& node){
+          return node->HasOneRef();
+        })
+    , nodes_.end());
+
+  prune_threshold_ = std::max(kMinPruneThreshold, nodes_.size() * 2);
+}
+
+bool postCancellableTask(
+  const ::base::Location& from_here
+  , const scoped_refptr<::base::SequencedTaskRunner>& task_runner
+  , scoped_refptr<CancellationToken> token
+  , ::base::OnceClosure task)
+{
+  DCHECK(task_runner);
+  DCHECK(token);
+
+  if(token->IsCancelled())
+  {
+    return false;
+  }
+
+  return task_runner->PostTask(
+    from_here
+    , bindCancellable(RVALUE_CAST(token), RVALUE_CAST(task), task_runner));
+}
+
+} // namespace basis
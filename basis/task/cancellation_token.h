@@ -0,0 +1,444 @@
+#pragma once
+
+#include <base/bind.h>
+#include <base/callback.h>
+#include <base/location.h>
+#include <base/logging.h>
+#include <base/macros.h>
+#include <base/memory/ref_counted.h>
+#include <base/memory/scoped_refptr.h>
+#include <base/sequenced_task_runner.h>
+#include <base/synchronization/lock.h>
+#include <base/thread_annotations.h>
+#include <base/time/time.h>
+
+#include <basic/macros.h>
+#include <basic/promise/promise.h>
+#include <basic/rvalue_cast.h>
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace basis {
+
+class CancellationToken;
+
+// Rejection reason of promise step skipped by cancelled token
+// (see `bindCancellableStep`).
+struct CancelledError {};
+
+namespace cancellation_internal {
+
+// Work registered in `CancellationToken`
+// that must be released when token is cancelled.
+class CancellableNode
+  : public ::base::RefCountedThreadSafe<CancellableNode>
+{
+ public:
+  CancellableNode() = default;
+
+  // Called once (without locks of token)
+  // if token is cancelled before node is released.
+  virtual void OnCancelled() = 0;
+
+ protected:
+  friend class ::base::RefCountedThreadSafe<CancellableNode>;
+
+  virtual ~CancellableNode() = default;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CancellableNode);
+};
+
+// Stores task until it is run or token is cancelled.
+//
+// If `destruction_task_runner` is not null,
+// then task cancelled on other sequence is destroyed
+// on `destruction_task_runner` (not on thread that cancels token).
+template <typename R, typename... Args>
+class CancellableTask
+  : public CancellableNode
+{
+ public:
+  using Task = ::base::OnceCallback<R(Args...)>;
+
+  CancellableTask(
+    Task task
+    , scoped_refptr<::base::SequencedTaskRunner> destruction_task_runner)
+    : destruction_task_runner_(RVALUE_CAST(destruction_task_runner))
+    , task_(RVALUE_CAST(task))
+  {}
+
+  MUST_USE_RETURN_VALUE
+  Task take()
+  {
+    ::base::AutoLock lock(lock_);
+    return RVALUE_CAST(task_);
+  }
+
+  void OnCancelled() override
+  {
+    // Destroy task (and its bound arguments) without lock,
+    // destructors of bound arguments may be heavy.
+    Task task = take();
+    if(!task
+       || !destruction_task_runner_
+       || destruction_task_runner_->RunsTasksInCurrentSequence())
+    {
+      return;
+    }
+
+    // Bound arguments may be affine to sequence
+    // (`WeakPtr`, objects with `SEQUENCE_CHECKER` etc.).
+    /// \note If post fails (runner is shutting down),
+    /// then task is destroyed on current thread.
+    destruction_task_runner_->PostTask(
+      FROM_HERE
+      , ::base::BindOnce([](Task){}, RVALUE_CAST(task)));
+  }
+
+ private:
+  ~CancellableTask() override = default;
+
+  const scoped_refptr<::base::SequencedTaskRunner> destruction_task_runner_;
+
+  ::base::Lock lock_;
+
+  Task task_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(CancellableTask);
+};
+
+template <typename... Args>
+void runCancellable(
+  const scoped_refptr<CancellationToken>& token
+  , const scoped_refptr<CancellableTask<void, Args...>>& node
+  , Args... args);
+
+template <typename R, typename... Args>
+::base::PromiseResult<R, CancelledError> runCancellableStep(
+  const scoped_refptr<CancellationToken>& token
+  , const scoped_refptr<CancellableTask<R, Args...>>& node
+  , Args... args);
+
+template <typename R, typename... Args>
+scoped_refptr<CancellableTask<R, Args...>> registerCancellableTask(
+  CancellationToken& token
+  , ::base::OnceCallback<R(Args...)> task
+  , scoped_refptr<::base::SequencedTaskRunner> destruction_task_runner);
+
+} // namespace cancellation_internal
+
+// Thread-safe cancellation flag with optional deadline
+// that can be attached to posted tasks and promise chains.
+//
+// Unlike `EndingTimeout` and `PeriodicCheckUntilTime`
+// (that only detect hangs), cancelled work is not executed:
+// * tasks wrapped by `bindCancellable` are skipped
+// * queued tasks are destroyed on `Cancel`, so their bound arguments
+//   (buffers, references to sessions, etc.) are freed early,
+//   even if task itself waits in queue of busy sequence.
+//
+// Tokens form tree: cancellation of parent cancels all children
+// (for example, per-request token as child of per-connection token).
+//
+/// \note token created by `CreateWithTimeout` is kept alive
+/// by posted timeout task until timeout expires.
+//
+/// \note THREAD OF DESTRUCTION: `Cancel` destroys queued tasks
+/// on thread that cancels token, unless task knows its sequence.
+/// Tasks posted by `postCancellableTask` (or bound with non-null
+/// `destruction_task_runner`) are destroyed on their sequence.
+/// Do NOT pass sequence-affine state (`WeakPtr`, objects
+/// with `SEQUENCE_CHECKER`, etc.) to `bindCancellable` without
+/// `destruction_task_runner` if token can be cancelled on other thread.
+//
+// USAGE
+//
+//  scoped_refptr<::basis::CancellationToken> requestToken
+//    = ::basis::CancellationToken::CreateWithTimeout(FROM_HERE
+//        , timeoutTaskRunner
+//        , ::base::TimeDelta::FromSeconds(5));
+//
+//  ::basis::postCancellableTask(FROM_HERE
+//    , APP_RUNNER(ENTT)
+//    , requestToken
+//    , ::base::BindOnce(&handleRequest, RVALUE_CAST(request)));
+//
+//  // steps after cancelled step are skipped
+//  promise
+//  .ThenOn(APP_RUNNER(ENTT)
+//    , FROM_HERE
+//    , ::basis::bindCancellableStep(requestToken
+//        , ::base::BindOnce(&buildReply)
+//        , APP_RUNNER(ENTT)))
+//  .ThenOn(APP_RUNNER(ENTT)
+//    , FROM_HERE
+//    , ::base::BindOnce(&sendReply))
+//  .CatchOn(APP_RUNNER(ENTT)
+//    , FROM_HERE
+//    , ::base::BindOnce([](::basis::CancelledError){
+//        LOG(WARNING) << "request cancelled";
+//      }));
+//
+//  // client disconnected
+//  requestToken->Cancel();
+class CancellationToken
+  : public ::base::RefCountedThreadSafe<CancellationToken>
+{
+ public:
+  using Node = cancellation_internal::CancellableNode;
+
+  CancellationToken();
+
+  // Token is cancelled after `timeout`
+  // by task posted to `task_runner`.
+  MUST_USE_RETURN_VALUE
+  static scoped_refptr<CancellationToken> CreateWithTimeout(
+    const ::base::Location& from_here
+    , scoped_refptr<::base::SequencedTaskRunner> task_runner
+    , ::base::TimeDelta timeout);
+
+  // Child is cancelled when this token is cancelled
+  // (immediately if this token is already cancelled).
+  // Child inherits deadline.
+  MUST_USE_RETURN_VALUE
+  scoped_refptr<CancellationToken> CreateChild();
+
+  // Same as `CreateChild`, but child is also cancelled after `timeout`
+  // (deadline of child is earliest of both deadlines).
+  MUST_USE_RETURN_VALUE
+  scoped_refptr<CancellationToken> CreateChildWithTimeout(
+    const ::base::Location& from_here
+    , scoped_refptr<::base::SequencedTaskRunner> task_runner
+    , ::base::TimeDelta timeout);
+
+  // Destroys registered tasks and runs cancellation callbacks
+  // on current thread (see "THREAD OF DESTRUCTION" above).
+  /// \note can be called on any thread, second call does nothing.
+  void Cancel();
+
+  // Returns `true` if token was cancelled or deadline passed.
+  MUST_USE_RETURN_VALUE
+  bool IsCancelled() const;
+
+  // Null if token has no deadline.
+  ::base::TimeTicks deadline() const
+  {
+    return deadline_;
+  }
+
+  // Runs `callback` on thread that cancels token
+  // (immediately if token is already cancelled).
+  /// \note callback is destroyed without run with token.
+  void AddCancellationCallback(::base::OnceClosure callback);
+
+  // Calls `node->OnCancelled()` on cancellation
+  // (immediately if token is already cancelled).
+  /// \note used by `bindCancellable`
+  void RegisterNode(scoped_refptr<Node> node);
+
+ private:
+  friend class ::base::RefCountedThreadSafe<CancellationToken>;
+
+  class ChildLink;
+
+  // Work taken from token on cancellation.
+  struct DetachedWork
+  {
+    DetachedWork();
+    DetachedWork(DetachedWork&& other);
+    DetachedWork& operator=(DetachedWork&& other);
+    ~DetachedWork();
+
+    // Must be called without locks.
+    void Run();
+
+    std::vector<scoped_refptr<Node>> nodes;
+
+    std::vector<::base::OnceClosure> callbacks;
+  };
+
+  ~CancellationToken();
+
+  // Marks token as cancelled and takes registered work.
+  // Returns empty work if token was already cancelled.
+  /// \note does not run any external code, so can be called under lock.
+  MUST_USE_RETURN_VALUE
+  DetachedWork detachOnCancel();
+
+  void setTimeout(
+    const ::base::Location& from_here
+    , scoped_refptr<::base::SequencedTaskRunner> task_runner
+    , ::base::TimeDelta timeout);
+
+  // Removes nodes that were released by their owners
+  // (tasks that already run or destroyed, destroyed children).
+  void pruneReleasedNodes() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+ private:
+  std::atomic<bool> cancelled_{false};
+
+  // Set before token is shared between threads.
+  ::base::TimeTicks deadline_;
+
+  // Link from parent token (if any), reset on destruction.
+  scoped_refptr<ChildLink> parent_link_;
+
+  ::base::Lock lock_;
+
+  std::vector<scoped_refptr<Node>> nodes_ GUARDED_BY(lock_);
+
+  // `nodes_` is pruned when its size reaches threshold,
+  // so registration is amortized O(1).
+  size_t prune_threshold_ GUARDED_BY(lock_);
+
+  std::vector<::base::OnceClosure> callbacks_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(CancellationToken);
+};
+
+// Returns callback that runs `task` only if `token` is not cancelled.
+// If `token` is cancelled before returned callback runs,
+// then `task` is destroyed immediately (returned callback does nothing).
+//
+// If `destruction_task_runner` is not null and token is cancelled
+// on other sequence, then `task` is destroyed on `destruction_task_runner`.
+//
+/// \note Do not use as step of promise chain: cancelled step resolves
+/// and next steps run. Use `bindCancellableStep` instead.
+template <typename... Args>
+MUST_USE_RETURN_VALUE
+::base::OnceCallback<void(Args...)> bindCancellable(
+  scoped_refptr<CancellationToken> token
+  , ::base::OnceCallback<void(Args...)> task
+  , scoped_refptr<::base::SequencedTaskRunner> destruction_task_runner
+      = nullptr)
+{
+  DCHECK(token);
+
+  auto node
+    = cancellation_internal::registerCancellableTask(
+        *token, RVALUE_CAST(task), RVALUE_CAST(destruction_task_runner));
+
+  return ::base::BindOnce(
+    &cancellation_internal::runCancellable<Args...>
+    , RVALUE_CAST(token)
+    , RVALUE_CAST(node));
+}
+
+// Same as `bindCancellable`, but for steps of promise chain
+// (`ThenOn`, `ThenHere`) that may return value.
+// Returned step resolves with result of `task`
+// or rejects with `CancelledError` if `token` is cancelled,
+// so next `Then*` steps are skipped and `Catch*` steps run.
+//
+/// \note `task` must not return promise.
+template <typename R, typename... Args>
+MUST_USE_RETURN_VALUE
+::base::OnceCallback<::base::PromiseResult<R, CancelledError>(Args...)>
+  bindCancellableStep(
+    scoped_refptr<CancellationToken> token
+    , ::base::OnceCallback<R(Args...)> task
+    , scoped_refptr<::base::SequencedTaskRunner> destruction_task_runner
+        = nullptr)
+{
+  DCHECK(token);
+
+  auto node
+    = cancellation_internal::registerCancellableTask(
+        *token, RVALUE_CAST(task), RVALUE_CAST(destruction_task_runner));
+
+  return ::base::BindOnce(
+    &cancellation_internal::runCancellableStep<R, Args...>
+    , RVALUE_CAST(token)
+    , RVALUE_CAST(node));
+}
+
+// Returns `false` if token is already cancelled
+// (task is destroyed without post).
+/// \note If token is cancelled on other sequence,
+/// then `task` is destroyed on `task_runner`.
+bool postCancellableTask(
+  const ::base::Location& from_here
+  , const scoped_refptr<::base::SequencedTaskRunner>& task_runner
+  , scoped_refptr<CancellationToken> token
+  , ::base::OnceClosure task);
+
+namespace cancellation_internal {
+
+template <typename R, typename... Args>
+scoped_refptr<CancellableTask<R, Args...>> registerCancellableTask(
+  CancellationToken& token
+  , ::base::OnceCallback<R(Args...)> task
+  , scoped_refptr<::base::SequencedTaskRunner> destruction_task_runner)
+{
+  DCHECK(task);
+
+  auto node
+    = ::base::MakeRefCounted<CancellableTask<R, Args...>>(
+        RVALUE_CAST(task), RVALUE_CAST(destruction_task_runner));
+
+  token.RegisterNode(node);
+
+  return node;
+}
+
+template <typename... Args>
+void runCancellable(
+  const scoped_refptr<CancellationToken>& token
+  , const scoped_refptr<CancellableTask<void, Args...>>& node
+  , Args... args)
+{
+  if(token->IsCancelled())
+  {
+    // deadline passed, but timeout task did not run yet
+    node->OnCancelled();
+    return;
+  }
+
+  typename CancellableTask<void, Args...>::Task task = node->take();
+  if(task)
+  {
+    RVALUE_CAST(task).Run(std::forward<Args>(args)...);
+  }
+}
+
+template <typename R, typename... Args>
+::base::PromiseResult<R, CancelledError> runCancellableStep(
+  const scoped_refptr<CancellationToken>& token
+  , const scoped_refptr<CancellableTask<R, Args...>>& node
+  , Args... args)
+{
+  if(token->IsCancelled())
+  {
+    // deadline passed, but timeout task did not run yet
+    node->OnCancelled();
+    return ::base::Rejected<CancelledError>();
+  }
+
+  typename CancellableTask<R, Args...>::Task task = node->take();
+  if(!task)
+  {
+    // cancelled concurrently
+    return ::base::Rejected<CancelledError>();
+  }
+
+  if constexpr (std::is_void<R>::value)
+  {
+    RVALUE_CAST(task).Run(std::forward<Args>(args)...);
+    return ::base::Resolved<void>();
+  }
+  else
+  {
+    return ::base::Resolved<R>(
+      RVALUE_CAST(task).Run(std::forward<Args>(args)...));
+  }
+}
+
+} // namespace cancellation_internal
+
+} // namespace basis
@@ -0,0 +1,286 @@
+#include "basis/task/cancellation_token.h"
+
+#include "base/bind.h"
+#include "base/callback_helpers.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "base/threading/thread.h"
+
+#include "basic/promise/promise.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace basis {
+namespace {
+
+class CancellationTokenTest : public testing::Test {
+ protected:
+  base::OnceClosure Increment() {
+    return base::BindOnce([](int* counter) { ++(*counter); },
+                          base::Unretained(&counter_));
+  }
+
+  // Task that sets `freed_` when destroyed (with or without run).
+  base::OnceClosure IncrementAndTrackDestruction() {
+    return base::BindOnce(
+        [](int* counter, base::ScopedClosureRunner) { ++(*counter); },
+        base::Unretained(&counter_),
+        base::ScopedClosureRunner(base::BindOnce(
+            [](bool* freed) { *freed = true; }, base::Unretained(&freed_))));
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+
+  int counter_ = 0;
+
+  bool freed_ = false;
+};
+
+TEST_F(CancellationTokenTest, RunsTaskIfNotCancelled) {
+  scoped_refptr<CancellationToken> token =
+      base::MakeRefCounted<CancellationToken>();
+
+  EXPECT_TRUE(postCancellableTask(FROM_HERE,
+                                  base::SequencedTaskRunnerHandle::Get(),
+                                  token, Increment()));
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(1, counter_);
+  EXPECT_FALSE(token->IsCancelled());
+}
+
+TEST_F(CancellationTokenTest, CancelFreesQueuedTask) {
+  scoped_refptr<CancellationToken> token =
+      base::MakeRefCounted<CancellationToken>();
+
+  EXPECT_TRUE(postCancellableTask(FROM_HERE,
+                                  base::SequencedTaskRunnerHandle::Get(),
+                                  token, IncrementAndTrackDestruction()));
+  EXPECT_FALSE(freed_);
+
+  token->Cancel();
+  // freed before queued task runs
+  EXPECT_TRUE(freed_);
+  EXPECT_TRUE(token->IsCancelled());
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(0, counter_);
+
+  EXPECT_FALSE(postCancellableTask(FROM_HERE,
+                                   base::SequencedTaskRunnerHandle::Get(),
+                                   token, Increment()));
+}
+
+TEST_F(CancellationTokenTest, CancelsOnTimeout) {
+  scoped_refptr<CancellationToken> token =
+      CancellationToken::CreateWithTimeout(
+          FROM_HERE, base::SequencedTaskRunnerHandle::Get(),
+          base::TimeDelta::FromSeconds(5));
+  EXPECT_FALSE(token->deadline().is_null());
+
+  base::SequencedTaskRunnerHandle::Get()->PostDelayedTask(
+      FROM_HERE, bindCancellable(token, IncrementAndTrackDestruction()),
+      base::TimeDelta::FromSeconds(10));
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(4));
+  EXPECT_FALSE(token->IsCancelled());
+  EXPECT_FALSE(freed_);
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(1));
+  EXPECT_TRUE(token->IsCancelled());
+  EXPECT_TRUE(freed_);
+
+  task_environment_.FastForwardUntilNoTasksRemain();
+  EXPECT_EQ(0, counter_);
+}
+
+TEST_F(CancellationTokenTest, ParentCancelsChildren) {
+  scoped_refptr<CancellationToken> parent =
+      base::MakeRefCounted<CancellationToken>();
+  scoped_refptr<CancellationToken> child = parent->CreateChild();
+  scoped_refptr<CancellationToken> grandchild = child->CreateChild();
+
+  // destroyed child must be skipped by parent
+  ignore_result(parent->CreateChild());
+
+  EXPECT_TRUE(postCancellableTask(FROM_HERE,
+                                  base::SequencedTaskRunnerHandle::Get(),
+                                  grandchild, IncrementAndTrackDestruction()));
+
+  child->Cancel();
+  EXPECT_FALSE(parent->IsCancelled());
+  EXPECT_TRUE(grandchild->IsCancelled());
+  EXPECT_TRUE(freed_);
+
+  scoped_refptr<CancellationToken> other_child = parent->CreateChild();
+  parent->Cancel();
+  EXPECT_TRUE(other_child->IsCancelled());
+
+  // child of cancelled token is cancelled immediately
+  EXPECT_TRUE(parent->CreateChild()->IsCancelled());
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(0, counter_);
+}
+
+TEST_F(CancellationTokenTest, ChildInheritsDeadline) {
+  scoped_refptr<CancellationToken> parent =
+      CancellationToken::CreateWithTimeout(
+          FROM_HERE, base::SequencedTaskRunnerHandle::Get(),
+          base::TimeDelta::FromSeconds(5));
+  scoped_refptr<CancellationToken> child = parent->CreateChildWithTimeout(
+      FROM_HERE, base::SequencedTaskRunnerHandle::Get(),
+      base::TimeDelta::FromSeconds(10));
+
+  EXPECT_EQ(parent->deadline(), child->deadline());
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(5));
+  EXPECT_TRUE(child->IsCancelled());
+}
+
+TEST_F(CancellationTokenTest, RunsCancellationCallbacks) {
+  scoped_refptr<CancellationToken> token =
+      base::MakeRefCounted<CancellationToken>();
+
+  token->AddCancellationCallback(Increment());
+  EXPECT_EQ(0, counter_);
+
+  token->Cancel();
+  EXPECT_EQ(1, counter_);
+
+  // second cancellation does nothing
+  token->Cancel();
+  EXPECT_EQ(1, counter_);
+
+  // already cancelled
+  token->AddCancellationCallback(Increment());
+  EXPECT_EQ(2, counter_);
+}
+
+TEST_F(CancellationTokenTest, ForwardsArguments) {
+  scoped_refptr<CancellationToken> token =
+      base::MakeRefCounted<CancellationToken>();
+
+  base::OnceCallback<void(int)> callback = bindCancellable(
+      token, base::BindOnce([](int* counter, int value) { *counter += value; },
+                            base::Unretained(&counter_)));
+  std::move(callback).Run(3);
+  EXPECT_EQ(3, counter_);
+
+  callback = bindCancellable(
+      token, base::BindOnce([](int* counter, int value) { *counter += value; },
+                            base::Unretained(&counter_)));
+  token->Cancel();
+  std::move(callback).Run(3);
+  EXPECT_EQ(3, counter_);
+}
+
+TEST_F(CancellationTokenTest, DestroysTaskOnItsSequence) {
+  scoped_refptr<CancellationToken> token =
+      base::MakeRefCounted<CancellationToken>();
+  scoped_refptr<base::SequencedTaskRunner> task_runner =
+      base::SequencedTaskRunnerHandle::Get();
+
+  bool destroyed_on_sequence = false;
+  EXPECT_TRUE(postCancellableTask(
+      FROM_HERE, task_runner, token,
+      base::BindOnce(
+          [](int* counter, base::ScopedClosureRunner) { ++(*counter); },
+          base::Unretained(&counter_),
+          base::ScopedClosureRunner(base::BindOnce(
+              [](scoped_refptr<base::SequencedTaskRunner> task_runner,
+                 bool* destroyed_on_sequence) {
+                *destroyed_on_sequence =
+                    task_runner->RunsTasksInCurrentSequence();
+              },
+              task_runner, base::Unretained(&destroyed_on_sequence))))));
+
+  base::Thread thread("CancellationTokenTest");
+  ASSERT_TRUE(thread.Start());
+  thread.task_runner()->PostTask(
+      FROM_HERE, base::BindOnce(&CancellationToken::Cancel, token));
+  thread.FlushForTesting();
+  thread.Stop();
+
+  // destruction is posted to sequence of task
+  EXPECT_FALSE(destroyed_on_sequence);
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(destroyed_on_sequence);
+  EXPECT_EQ(0, counter_);
+}
+
+TEST_F(CancellationTokenTest, PromiseStepResolvesWithValue) {
+  scoped_refptr<CancellationToken> token =
+      base::MakeRefCounted<CancellationToken>();
+
+  base::ManualPromiseResolver<void> resolver(FROM_HERE);
+  int result = 0;
+  resolver.promise()
+      .ThenHere(FROM_HERE,
+                bindCancellableStep(token, base::BindOnce([]() { return 5; })))
+      .ThenHere(FROM_HERE, base::BindOnce([](int* result,
+                                             int value) { *result = value; },
+                                          base::Unretained(&result)))
+      .CatchHere(FROM_HERE, base::BindOnce([](CancelledError) {
+                   ADD_FAILURE() << "step must not be cancelled";
+                 }));
+
+  resolver.Resolve();
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(5, result);
+}
+
+TEST_F(CancellationTokenTest, CancelledPromiseStepRejectsChain) {
+  scoped_refptr<CancellationToken> token =
+      base::MakeRefCounted<CancellationToken>();
+
+  base::ManualPromiseResolver<void> resolver(FROM_HERE);
+  bool rejected = false;
+  resolver.promise()
+      .ThenHere(FROM_HERE,
+                bindCancellableStep(
+                    token, base::BindOnce(
+                               [](int* counter) {
+                                 ++(*counter);
+                                 return 5;
+                               },
+                               base::Unretained(&counter_))))
+      // skipped, because previous step is cancelled
+      .ThenHere(FROM_HERE,
+                base::BindOnce([](int* counter, int) { ++(*counter); },
+                               base::Unretained(&counter_)))
+      .CatchHere(FROM_HERE, base::BindOnce(
+                                [](bool* rejected, CancelledError) {
+                                  *rejected = true;
+                                },
+                                base::Unretained(&rejected)));
+
+  token->Cancel();
+  resolver.Resolve();
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_TRUE(rejected);
+  EXPECT_EQ(0, counter_);
+}
+
+TEST_F(CancellationTokenTest, PrunesFinishedTasks) {
+  scoped_refptr<CancellationToken> token =
+      base::MakeRefCounted<CancellationToken>();
+
+  // tasks that already run must not accumulate in token
+  for (int i = 0; i < 1000; ++i) {
+    bindCancellable(token, Increment()).Run();
+  }
+  EXPECT_EQ(1000, counter_);
+
+  token->Cancel();
+  EXPECT_EQ(1000, counter_);
+}
+
+}  // namespace
+}  // namespace basis
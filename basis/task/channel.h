@@ -0,0 +1,578 @@
+#pragma once
+
+#include <base/bind.h>
+#include <base/callback.h>
+#include <base/location.h>
+#include <base/logging.h>
+#include <base/macros.h>
+#include <base/memory/ref_counted.h>
+#include <base/memory/scoped_refptr.h>
+#include <base/sequenced_task_runner.h>
+#include <base/synchronization/condition_variable.h>
+#include <base/synchronization/lock.h>
+#include <base/thread_annotations.h>
+#include <base/threading/scoped_blocking_call.h>
+#include <base/trace_event/trace_event.h>
+
+#include <basic/macros.h>
+#include <basic/rvalue_cast.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace basis {
+
+// What `Channel::Send` does if ring buffer is full.
+enum class ChannelOverflowPolicy
+{
+  // Producer waits until consumer frees space
+  // (must not be used on sequence of consumer,
+  // producer must be allowed to block i.e. `base::MayBlock()`).
+  kBlock
+  // Message is destroyed, `Send` returns `false`.
+  , kDrop
+  // Message is stored in unbounded list (guarded by lock)
+  // until consumer drains it.
+  , kGrow
+};
+
+struct ChannelOptions
+{
+  // Rounded up to power of two.
+  size_t capacity = 1024;
+
+  ChannelOverflowPolicy overflow_policy = ChannelOverflowPolicy::kDrop;
+
+  // Maximum number of messages passed to handler at once.
+  // Consumer yields to other tasks of its sequence after each batch.
+  size_t max_batch_size = 256;
+};
+
+// Multi-producer single-consumer channel for passing messages
+// between sequences without `PostTask` per message.
+//
+// Producers (any thread) push messages into lock-free bounded ring
+// (see http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue).
+// Consumer sequence is woken by single task once per transition
+// from empty to non-empty and drains messages in batches,
+// so 500k messages may cost few thousand task allocations
+// instead of 500k.
+//
+/// \note Order of messages from one producer is preserved.
+/// \note `handler` is called on sequence of `consumer_task_runner`
+/// and must not keep reference to batch (vector is re-used).
+/// \note Messages not delivered before destruction of channel
+/// are destroyed without handling.
+//
+// USAGE
+//
+//  // NON_BLOCK_IO -> ENTT
+//  scoped_refptr<::basis::Channel<NetworkEvent>> channel
+//    = ::base::MakeRefCounted<::basis::Channel<NetworkEvent>>(
+//        APP_RUNNER(ENTT)
+//        , ::base::BindRepeating(&NetworkSystem::onEvents
+//            , ::base::Unretained(networkSystem))
+//        , ::basis::ChannelOptions{});
+//
+//  // on NON_BLOCK_IO
+//  if(!channel->Send(RVALUE_CAST(event)))
+//  {
+//    LOG(WARNING) << "network event dropped";
+//  }
+template <typename T>
+class Channel
+  : public ::base::RefCountedThreadSafe<Channel<T>>
+{
+ public:
+  using BatchHandler
+    = ::base::RepeatingCallback<void(std::vector<T>& batch)>;
+
+  struct Snapshot
+  {
+    uint64_t received = 0;
+    uint64_t dropped = 0;
+    // Number of messages stored in overflow list (`kGrow`).
+    uint64_t overflowed = 0;
+    // Number of tasks posted to consumer sequence.
+    uint64_t wakeups = 0;
+    uint64_t batches = 0;
+  };
+
+  Channel(
+    scoped_refptr<::base::SequencedTaskRunner> consumer_task_runner
+    , BatchHandler handler
+    , const ChannelOptions& options)
+    : consumer_task_runner_(RVALUE_CAST(consumer_task_runner))
+    , handler_(RVALUE_CAST(handler))
+    , overflow_policy_(options.overflow_policy)
+    , max_batch_size_(options.max_batch_size)
+    , mask_(roundUpToPowerOfTwo(options.capacity) - 1)
+    , cells_(std::make_unique<Cell[]>(mask_ + 1))
+    , not_full_(&lock_)
+  {
+    DCHECK(consumer_task_runner_);
+    DCHECK(handler_);
+    DCHECK_GT(options.capacity, 0u);
+    DCHECK_GT(max_batch_size_, 0u);
+
+    for(size_t i = 0; i <= mask_; ++i)
+    {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    batch_.reserve(max_batch_size_);
+  }
+
+  // Returns `false` if message will never be handled
+  // (channel is closed or full with `kDrop` policy).
+  /// \note can be called on any thread.
+  /// \note If consumer can not be woken up
+  /// (`consumer_task_runner` is shutting down), then channel is closed
+  /// and messages that wait in it are destroyed with channel.
+  bool Send(T value)
+  {
+    if(!enqueue(value))
+    {
+      return false;
+    }
+
+    if(!wakeUpConsumerIfNeeded())
+    {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      wakeUpBlockedProducers();
+      return false;
+    }
+    return true;
+  }
+
+  // Sends messages from [`first`, `last`) (messages are moved)
+  // and wakes up consumer at most once.
+  // Returns number of sent messages
+  // (zero if consumer can not be woken up, see `Send`).
+  /// \note Messages are moved even if they are dropped.
+  /// \note can be called on any thread.
+  template <typename Iterator>
+  size_t SendBatch(Iterator first, Iterator last)
+  {
+    size_t sent = 0;
+    for(; first != last; ++first)
+    {
+      T value(RVALUE_CAST(*first));
+      if(enqueue(value))
+      {
+        ++sent;
+      }
+    }
+
+    if(sent && !wakeUpConsumerIfNeeded())
+    {
+      dropped_.fetch_add(sent, std::memory_order_relaxed);
+      wakeUpBlockedProducers();
+      return 0;
+    }
+    return sent;
+  }
+
+  // Stops delivery of messages: handler will not be called after `Close`
+  // and `Send` will return `false`.
+  /// \note must be called on sequence of consumer.
+  void Close()
+  {
+    DCHECK(consumer_task_runner_->RunsTasksInCurrentSequence());
+
+    closed_.store(true, std::memory_order_release);
+    handler_.Reset();
+
+    // wake up blocked producers
+    ::base::AutoLock lock(lock_);
+    not_full_.Broadcast();
+  }
+
+  bool IsClosed() const
+  {
+    return closed_.load(std::memory_order_acquire);
+  }
+
+  size_t capacity() const
+  {
+    return mask_ + 1;
+  }
+
+  MUST_USE_RETURN_VALUE
+  Snapshot GetSnapshot() const
+  {
+    Snapshot snapshot;
+    snapshot.received = received_.load(std::memory_order_relaxed);
+    snapshot.dropped = dropped_.load(std::memory_order_relaxed);
+    snapshot.overflowed = overflowed_.load(std::memory_order_relaxed);
+    snapshot.wakeups = wakeups_.load(std::memory_order_relaxed);
+    snapshot.batches = batches_.load(std::memory_order_relaxed);
+    return snapshot;
+  }
+
+ private:
+  friend class ::base::RefCountedThreadSafe<Channel<T>>;
+
+  // Cell of ring buffer.
+  // `sequence` equals to position of producer if cell is free
+  // and to position + 1 if cell stores message.
+  struct Cell
+  {
+    std::atomic<size_t> sequence{0};
+
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+    T* get()
+    {
+      return std::launder(reinterpret_cast<T*>(&storage));
+    }
+  };
+
+  ~Channel()
+  {
+    // no producers or consumer can exist here
+    while(tryPopFromRing(nullptr))
+    {
+    }
+  }
+
+  static size_t roundUpToPowerOfTwo(size_t value)
+  {
+    size_t result = 1;
+    while(result < value)
+    {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  // Moves out of `value` only if message is stored.
+  bool enqueue(T& value)
+  {
+    if(closed_.load(std::memory_order_acquire))
+    {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    // Keep order of messages from same producer:
+    // while overflow list is not empty, append to it.
+    if(overflow_policy_ == ChannelOverflowPolicy::kGrow
+       && overflow_size_.load(std::memory_order_acquire) != 0)
+    {
+      pushToOverflow(value);
+      return true;
+    }
+
+    if(tryPushToRing(value))
+    {
+      return true;
+    }
+
+    switch(overflow_policy_)
+    {
+      case ChannelOverflowPolicy::kDrop:
+      {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      case ChannelOverflowPolicy::kGrow:
+      {
+        pushToOverflow(value);
+        return true;
+      }
+      case ChannelOverflowPolicy::kBlock:
+      {
+        return blockingPush(value);
+      }
+    }
+
+    NOTREACHED();
+    return false;
+  }
+
+  bool tryPushToRing(T& value)
+  {
+    Cell* cell;
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    for(;;)
+    {
+      cell = &cells_[pos & mask_];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff
+        = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if(diff == 0)
+      {
+        if(tail_.compare_exchange_weak(
+             pos, pos + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if(diff < 0)
+      {
+        // full
+        return false;
+      }
+      else
+      {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+
+    new (&cell->storage) T(RVALUE_CAST(value));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Pops into `out` or destroys message if `out` is null.
+  /// \note must be called only by consumer.
+  bool tryPopFromRing(std::vector<T>* out)
+  {
+    Cell& cell = cells_[head_ & mask_];
+    const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if(sequence != head_ + 1)
+    {
+      // empty (or producer did not finish writing yet)
+      return false;
+    }
+
+    T* value = cell.get();
+    if(out)
+    {
+      out->push_back(RVALUE_CAST(*value));
+    }
+    value->~T();
+
+    cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+    ++head_;
+    return true;
+  }
+
+  void pushToOverflow(T& value)
+  {
+    ::base::AutoLock lock(lock_);
+    overflow_.push_back(RVALUE_CAST(value));
+    overflow_size_.store(overflow_.size(), std::memory_order_release);
+    overflowed_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  bool blockingPush(T& value)
+  {
+    DCHECK(!consumer_task_runner_->RunsTasksInCurrentSequence())
+      << "consumer can not wait for itself";
+
+    ::base::ScopedBlockingCall scoped_blocking_call(
+      FROM_HERE, ::base::BlockingType::MAY_BLOCK);
+
+    // Consumer checks `blocked_producers_` after it frees space,
+    // so it either sees this producer or producer sees free space.
+    blocked_producers_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool pushed = false;
+    {
+      ::base::AutoLock lock(lock_);
+      while(!(pushed = tryPushToRing(value))
+            && !closed_.load(std::memory_order_acquire))
+      {
+        // Wake up consumer, it may be waiting for this producer
+        // (i.e. ring is full of messages, but consumer is not scheduled).
+        if(!wakeUpConsumerIfNeeded())
+        {
+          // channel is closed, wake up other blocked producers
+          not_full_.Broadcast();
+          break;
+        }
+        not_full_.Wait();
+      }
+    }
+
+    blocked_producers_.fetch_sub(1, std::memory_order_relaxed);
+
+    if(!pushed)
+    {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return pushed;
+  }
+
+  // Returns `false` if drain can not be posted to consumer.
+  // Channel is closed in that case.
+  MUST_USE_RETURN_VALUE
+  bool wakeUpConsumerIfNeeded()
+  {
+    // pairs with fence in `drain`
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if(drain_scheduled_.exchange(true, std::memory_order_acq_rel))
+    {
+      // already scheduled drain will see message
+      return true;
+    }
+
+    // Keeps `this` alive until messages are drained.
+    const bool posted = consumer_task_runner_->PostTask(
+      FROM_HERE
+      , ::base::BindOnce(
+          &Channel::drain
+          , scoped_refptr<Channel>(this)));
+    if(!posted)
+    {
+      // Consumer will never drain channel, so close it:
+      // `false` returned by `Send` must mean that message is not handled.
+      /// \note `drain_scheduled_` stays `true`, so no more drains are posted.
+      closed_.store(true, std::memory_order_release);
+      return false;
+    }
+
+    wakeups_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// \note must not be called under `lock_`.
+  void wakeUpBlockedProducers()
+  {
+    // pairs with fence in `blockingPush`
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(blocked_producers_.load(std::memory_order_relaxed) != 0)
+    {
+      ::base::AutoLock lock(lock_);
+      not_full_.Broadcast();
+    }
+  }
+
+  void drain()
+  {
+    DCHECK(consumer_task_runner_->RunsTasksInCurrentSequence());
+
+    TRACE_EVENT0("headless", "Channel::drain");
+
+    // Messages sent from now on must schedule next drain
+    // (if this drain will not handle them).
+    drain_scheduled_.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if(closed_.load(std::memory_order_acquire))
+    {
+      return;
+    }
+
+    DCHECK(batch_.empty());
+
+    while(batch_.size() < max_batch_size_
+          && tryPopFromRing(&batch_))
+    {
+    }
+
+    if(overflow_policy_ == ChannelOverflowPolicy::kGrow
+       && batch_.size() < max_batch_size_
+       && overflow_size_.load(std::memory_order_acquire) != 0)
+    {
+      ::base::AutoLock lock(lock_);
+      while(batch_.size() < max_batch_size_
+            && !overflow_.empty())
+      {
+        batch_.push_back(RVALUE_CAST(overflow_.front()));
+        overflow_.pop_front();
+      }
+      overflow_size_.store(overflow_.size(), std::memory_order_release);
+    }
+
+    // pairs with fence in `blockingPush`
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(!batch_.empty()
+       && blocked_producers_.load(std::memory_order_relaxed) != 0)
+    {
+      ::base::AutoLock lock(lock_);
+      not_full_.Broadcast();
+    }
+
+    if(batch_.empty())
+    {
+      return;
+    }
+
+    received_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    batches_.fetch_add(1, std::memory_order_relaxed);
+
+    handler_.Run(batch_);
+    batch_.clear();
+
+    // yield to other tasks of consumer sequence
+    if(hasPendingMessages())
+    {
+      ignore_result(wakeUpConsumerIfNeeded());
+    }
+  }
+
+  /// \note must be called only by consumer.
+  bool hasPendingMessages()
+  {
+    return cells_[head_ & mask_].sequence.load(std::memory_order_acquire)
+             == head_ + 1
+      || overflow_size_.load(std::memory_order_acquire) != 0;
+  }
+
+ private:
+  const scoped_refptr<::base::SequencedTaskRunner> consumer_task_runner_;
+
+  // Reset by `Close`.
+  BatchHandler handler_;
+
+  const ChannelOverflowPolicy overflow_policy_;
+
+  const size_t max_batch_size_;
+
+  const size_t mask_;
+
+  std::unique_ptr<Cell[]> cells_;
+
+  // Position of next message to write (shared by producers).
+  alignas(64) std::atomic<size_t> tail_{0};
+
+  // Position of next message to read (used only by consumer).
+  alignas(64) size_t head_ = 0;
+
+  // Re-used between drains to avoid allocations.
+  std::vector<T> batch_;
+
+  // `true` if `drain` is posted to consumer, but not started yet.
+  std::atomic<bool> drain_scheduled_{false};
+
+  std::atomic<bool> closed_{false};
+
+  // Guards slow paths: overflow list and blocked producers.
+  ::base::Lock lock_;
+
+  // Signalled by consumer after it frees space in ring.
+  ::base::ConditionVariable not_full_;
+
+  std::deque<T> overflow_ GUARDED_BY(lock_);
+
+  // Size of `overflow_`, readable without lock.
+  std::atomic<size_t> overflow_size_{0};
+
+  std::atomic<size_t> blocked_producers_{0};
+
+  std::atomic<uint64_t> received_{0};
+
+  std::atomic<uint64_t> dropped_{0};
+
+  std::atomic<uint64_t> overflowed_{0};
+
+  std::atomic<uint64_t> wakeups_{0};
+
+  std::atomic<uint64_t> batches_{0};
+
+  DISALLOW_COPY_AND_ASSIGN(Channel);
+};
+
+} // namespace basis
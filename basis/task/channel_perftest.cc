@@ -0,0 +1,196 @@
+#include "basis/task/channel.h"
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/location.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/single_thread_task_runner.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace basis {
+
+namespace {
+
+constexpr int kMessagesPerProducer = 100000;
+
+struct Message {
+  int producer;
+  int value;
+};
+
+// Signals `done` when `expected` messages are received.
+class Receiver {
+ public:
+  explicit Receiver(int64_t expected)
+    : expected_(expected)
+    , done_(base::WaitableEvent::ResetPolicy::AUTOMATIC) {}
+
+  void OnMessages(int64_t count) {
+    received_ += count;
+    if (received_ == expected_) {
+      received_ = 0;
+      done_.Signal();
+    }
+  }
+
+  void Wait() { done_.Wait(); }
+
+ private:
+  const int64_t expected_;
+  // used only on consumer thread
+  int64_t received_ = 0;
+  base::WaitableEvent done_;
+};
+
+void RunProducers(int producers, const std::function<void(int)>& produce) {
+  std::vector<std::thread> threads;
+  for (int producer = 0; producer < producers; ++producer) {
+    threads.emplace_back([&produce, producer]() { produce(producer); });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+// Messages per second from `state.range(0)` producer threads
+// to consumer thread using `Channel`.
+void BM_ChannelThroughput(benchmark::State& state) {
+  const int producers = state.range(0);
+
+  base::Thread consumer("ChannelConsumer");
+  consumer.Start();
+
+  Receiver receiver(int64_t{producers} * kMessagesPerProducer);
+
+  ChannelOptions options;
+  options.capacity = 4096;
+  options.overflow_policy = ChannelOverflowPolicy::kBlock;
+
+  scoped_refptr<Channel<Message>> channel =
+      base::MakeRefCounted<Channel<Message>>(
+          consumer.task_runner(),
+          base::BindRepeating(
+              [](Receiver* receiver, std::vector<Message>& batch) {
+                receiver->OnMessages(batch.size());
+              },
+              base::Unretained(&receiver)),
+          options);
+
+  for (auto _ : state) {
+    RunProducers(producers, [&channel](int producer) {
+      for (int i = 0; i < kMessagesPerProducer; ++i) {
+        channel->Send(Message{producer, i});
+      }
+    });
+    receiver.Wait();
+  }
+
+  state.SetItemsProcessed(
+      state.iterations() * producers * kMessagesPerProducer);
+  state.counters["wakeups"] = channel->GetSnapshot().wakeups;
+
+  consumer.Stop();
+}
+BENCHMARK(BM_ChannelThroughput)
+  ->ArgName("producers")
+  ->Arg(1)
+  ->Arg(2)
+  ->Arg(4)
+  ->UseRealTime();
+
+// Baseline: one `PostTask` per message.
+void BM_PostTaskThroughput(benchmark::State& state) {
+  const int producers = state.range(0);
+
+  base::Thread consumer("PostTaskConsumer");
+  consumer.Start();
+
+  Receiver receiver(int64_t{producers} * kMessagesPerProducer);
+  scoped_refptr<base::SingleThreadTaskRunner> task_runner =
+      consumer.task_runner();
+
+  for (auto _ : state) {
+    RunProducers(producers, [&task_runner, &receiver](int producer) {
+      for (int i = 0; i < kMessagesPerProducer; ++i) {
+        task_runner->PostTask(
+            FROM_HERE,
+            base::BindOnce(
+                [](Receiver* receiver, Message message) {
+                  benchmark::DoNotOptimize(message);
+                  receiver->OnMessages(1);
+                },
+                base::Unretained(&receiver), Message{producer, i}));
+      }
+    });
+    receiver.Wait();
+  }
+
+  state.SetItemsProcessed(
+      state.iterations() * producers * kMessagesPerProducer);
+
+  consumer.Stop();
+}
+BENCHMARK(BM_PostTaskThroughput)
+  ->ArgName("producers")
+  ->Arg(1)
+  ->Arg(2)
+  ->Arg(4)
+  ->UseRealTime();
+
+// Time from `Send` into empty channel until consumer handles message
+// (includes wakeup of consumer thread).
+void BM_ChannelLatency(benchmark::State& state) {
+  base::Thread consumer("ChannelConsumer");
+  consumer.Start();
+
+  Receiver receiver(1);
+
+  scoped_refptr<Channel<Message>> channel =
+      base::MakeRefCounted<Channel<Message>>(
+          consumer.task_runner(),
+          base::BindRepeating(
+              [](Receiver* receiver, std::vector<Message>& batch) {
+                receiver->OnMessages(batch.size());
+              },
+              base::Unretained(&receiver)),
+          ChannelOptions{});
+
+  for (auto _ : state) {
+    channel->Send(Message{0, 0});
+    receiver.Wait();
+  }
+
+  consumer.Stop();
+}
+BENCHMARK(BM_ChannelLatency)->UseRealTime();
+
+// Baseline: latency of single `PostTask`.
+void BM_PostTaskLatency(benchmark::State& state) {
+  base::Thread consumer("PostTaskConsumer");
+  consumer.Start();
+
+  Receiver receiver(1);
+
+  for (auto _ : state) {
+    consumer.task_runner()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&Receiver::OnMessages, base::Unretained(&receiver),
+                       1));
+    receiver.Wait();
+  }
+
+  consumer.Stop();
+}
+BENCHMARK(BM_PostTaskLatency)->UseRealTime();
+
+}  // namespace
+
+}  // namespace basis
@@ -0,0 +1,261 @@
+#include "basis/task/channel.h"
+
+#include "base/bind.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/run_loop.h"
+#include "base/task/thread_pool.h"
+#include "base/test/task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace basis {
+namespace {
+
+// Rejects all posts while `reject` is set.
+class RejectingTaskRunner : public base::SequencedTaskRunner {
+ public:
+  explicit RejectingTaskRunner(
+      scoped_refptr<base::SequencedTaskRunner> task_runner)
+      : task_runner_(std::move(task_runner)) {}
+
+  void set_reject(bool reject) { reject_ = reject; }
+
+  bool PostDelayedTask(const base::Location& from_here,
+                       base::OnceClosure task,
+                       base::TimeDelta delay) override {
+    return !reject_ &&
+           task_runner_->PostDelayedTask(from_here, std::move(task), delay);
+  }
+
+  bool PostNonNestableDelayedTask(const base::Location& from_here,
+                                  base::OnceClosure task,
+                                  base::TimeDelta delay) override {
+    return !reject_ && task_runner_->PostNonNestableDelayedTask(
+                           from_here, std::move(task), delay);
+  }
+
+  bool RunsTasksInCurrentSequence() const override {
+    return task_runner_->RunsTasksInCurrentSequence();
+  }
+
+ private:
+  ~RejectingTaskRunner() override = default;
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  bool reject_ = false;
+};
+
+class ChannelTest : public testing::Test {
+ protected:
+  scoped_refptr<Channel<int>> CreateChannel(const ChannelOptions& options) {
+    return base::MakeRefCounted<Channel<int>>(
+        base::SequencedTaskRunnerHandle::Get(),
+        base::BindRepeating(&ChannelTest::OnBatch, base::Unretained(this)),
+        options);
+  }
+
+  void OnBatch(std::vector<int>& batch) {
+    batch_sizes_.push_back(batch.size());
+    received_.insert(received_.end(), batch.begin(), batch.end());
+  }
+
+  base::test::TaskEnvironment task_environment_;
+
+  std::vector<size_t> batch_sizes_;
+
+  std::vector<int> received_;
+};
+
+TEST_F(ChannelTest, DeliversMessagesInBatches) {
+  ChannelOptions options;
+  options.capacity = 16;
+  options.max_batch_size = 4;
+  scoped_refptr<Channel<int>> channel = CreateChannel(options);
+
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(channel->Send(i));
+  }
+  // nothing is delivered until consumer sequence runs
+  EXPECT_TRUE(received_.empty());
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), received_);
+  EXPECT_EQ((std::vector<size_t>{4, 4, 2}), batch_sizes_);
+
+  Channel<int>::Snapshot snapshot = channel->GetSnapshot();
+  EXPECT_EQ(10u, snapshot.received);
+  EXPECT_EQ(3u, snapshot.batches);
+  // one wakeup per send into empty channel and one per yield
+  EXPECT_EQ(3u, snapshot.wakeups);
+}
+
+TEST_F(ChannelTest, SendBatchWakesUpConsumerOnce) {
+  scoped_refptr<Channel<int>> channel = CreateChannel(ChannelOptions{});
+
+  std::vector<int> messages{1, 2, 3};
+  EXPECT_EQ(3u, channel->SendBatch(messages.begin(), messages.end()));
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(messages, received_);
+  EXPECT_EQ(1u, channel->GetSnapshot().wakeups);
+}
+
+TEST_F(ChannelTest, DropsMessagesWhenFull) {
+  ChannelOptions options;
+  options.capacity = 2;
+  options.overflow_policy = ChannelOverflowPolicy::kDrop;
+  scoped_refptr<Channel<int>> channel = CreateChannel(options);
+  EXPECT_EQ(2u, channel->capacity());
+
+  EXPECT_TRUE(channel->Send(1));
+  EXPECT_TRUE(channel->Send(2));
+  EXPECT_FALSE(channel->Send(3));
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ((std::vector<int>{1, 2}), received_);
+  EXPECT_EQ(1u, channel->GetSnapshot().dropped);
+}
+
+TEST_F(ChannelTest, GrowsWhenFull) {
+  ChannelOptions options;
+  options.capacity = 2;
+  options.overflow_policy = ChannelOverflowPolicy::kGrow;
+  scoped_refptr<Channel<int>> channel = CreateChannel(options);
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(channel->Send(i));
+  }
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), received_);
+  EXPECT_EQ(3u, channel->GetSnapshot().overflowed);
+}
+
+TEST_F(ChannelTest, MoveOnlyMessages) {
+  std::vector<int> values;
+  scoped_refptr<Channel<std::unique_ptr<int>>> channel =
+      base::MakeRefCounted<Channel<std::unique_ptr<int>>>(
+          base::SequencedTaskRunnerHandle::Get(),
+          base::BindRepeating(
+              [](std::vector<int>* values,
+                 std::vector<std::unique_ptr<int>>& batch) {
+                for (const std::unique_ptr<int>& value : batch) {
+                  values->push_back(*value);
+                }
+              },
+              base::Unretained(&values)),
+          ChannelOptions{});
+
+  EXPECT_TRUE(channel->Send(std::make_unique<int>(7)));
+  EXPECT_TRUE(channel->Send(std::make_unique<int>(8)));
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ((std::vector<int>{7, 8}), values);
+
+  // not delivered, destroyed with channel
+  EXPECT_TRUE(channel->Send(std::make_unique<int>(9)));
+  channel->Close();
+  EXPECT_FALSE(channel->Send(std::make_unique<int>(10)));
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ((std::vector<int>{7, 8}), values);
+}
+
+TEST_F(ChannelTest, ClosesWhenConsumerIsUnavailable) {
+  scoped_refptr<RejectingTaskRunner> rejecting_runner =
+      base::MakeRefCounted<RejectingTaskRunner>(
+          base::SequencedTaskRunnerHandle::Get());
+  scoped_refptr<Channel<int>> channel = base::MakeRefCounted<Channel<int>>(
+      rejecting_runner,
+      base::BindRepeating(&ChannelTest::OnBatch, base::Unretained(this)),
+      ChannelOptions{});
+
+  rejecting_runner->set_reject(true);
+  // `false` means that message will never be handled
+  EXPECT_FALSE(channel->Send(1));
+  EXPECT_TRUE(channel->IsClosed());
+
+  rejecting_runner->set_reject(false);
+  EXPECT_FALSE(channel->Send(2));
+  std::vector<int> messages{3, 4};
+  EXPECT_EQ(0u, channel->SendBatch(messages.begin(), messages.end()));
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_TRUE(received_.empty());
+  Channel<int>::Snapshot snapshot = channel->GetSnapshot();
+  EXPECT_EQ(0u, snapshot.wakeups);
+  EXPECT_EQ(4u, snapshot.dropped);
+}
+
+TEST_F(ChannelTest, MultipleBlockingProducers) {
+  constexpr int kProducers = 4;
+  constexpr int kMessagesPerProducer = 1000;
+
+  ChannelOptions options;
+  options.capacity = 16;
+  options.overflow_policy = ChannelOverflowPolicy::kBlock;
+  options.max_batch_size = 8;
+
+  base::RunLoop run_loop;
+  std::vector<std::vector<int>> per_producer(kProducers);
+  int received = 0;
+
+  scoped_refptr<Channel<std::pair<int, int>>> channel =
+      base::MakeRefCounted<Channel<std::pair<int, int>>>(
+          base::SequencedTaskRunnerHandle::Get(),
+          base::BindRepeating(
+              [](std::vector<std::vector<int>>* per_producer, int* received,
+                 base::RepeatingClosure quit,
+                 std::vector<std::pair<int, int>>& batch) {
+                for (const std::pair<int, int>& message : batch) {
+                  (*per_producer)[message.first].push_back(message.second);
+                }
+                *received += batch.size();
+                if (*received == kProducers * kMessagesPerProducer) {
+                  quit.Run();
+                }
+              },
+              base::Unretained(&per_producer), base::Unretained(&received),
+              run_loop.QuitClosure()),
+          options);
+
+  for (int producer = 0; producer < kProducers; ++producer) {
+    base::ThreadPool::PostTask(
+        FROM_HERE, {base::MayBlock()},
+        base::BindOnce(
+            [](scoped_refptr<Channel<std::pair<int, int>>> channel,
+               int producer) {
+              for (int i = 0; i < kMessagesPerProducer; ++i) {
+                EXPECT_TRUE(channel->Send(std::make_pair(producer, i)));
+              }
+            },
+            channel, producer));
+  }
+
+  run_loop.Run();
+
+  // order of messages from one producer is preserved
+  for (const std::vector<int>& messages : per_producer) {
+    ASSERT_EQ(static_cast<size_t>(kMessagesPerProducer), messages.size());
+    for (int i = 0; i < kMessagesPerProducer; ++i) {
+      EXPECT_EQ(i, messages[i]);
+    }
+  }
+  EXPECT_EQ(0u, channel->GetSnapshot().dropped);
+
+  task_environment_.RunUntilIdle();
+}
+
+}  // namespace
+}  // namespace basis
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <base/bind.h>
+#include <base/callback.h>
+#include <base/logging.h>
+#include <base/macros.h>
+
+#include <basic/rvalue_cast.h>
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace basis {
+
+// Move-only callable `void()` that can be run once
+// (like `base::OnceClosure`), but stores small callables inline
+// instead of heap-allocated ref-counted `BindState`.
+//
+// Callable is stored inline if it is not larger than `kInlineSize`
+// and is nothrow move constructible,
+// otherwise it is stored on heap (one allocation, no atomics).
+//
+// `base::OnceClosure` is accepted as is
+// (stored inline, no extra allocation).
+//
+/// \note unlike `base::OnceClosure`, `InlineTask` does not support
+/// cancellation via `base::WeakPtr` of bound receiver:
+/// capture `base::WeakPtr` and check it inside of callable
+/// or use `base::BindOnce`.
+//
+// USAGE
+//
+//  // no allocations
+//  heap->ScheduleTask(FROM_HERE
+//    , ::basis::InlineTask([this, connection](){
+//        onConnected(connection);
+//      })
+//    , priority);
+class InlineTask
+{
+ public:
+  // 48 bytes of captures (six pointers),
+  // so `sizeof(InlineTask)` is 64 bytes.
+  static constexpr size_t kInlineSize = 48;
+
+  static constexpr size_t kInlineAlignment = alignof(std::max_align_t);
+
+  template <typename Func>
+  static constexpr bool IsStoredInline()
+  {
+    return sizeof(Func) <= kInlineSize
+      && alignof(Func) <= kInlineAlignment
+      && std::is_nothrow_move_constructible_v<Func>;
+  }
+
+  InlineTask() noexcept = default;
+
+  InlineTask(std::nullptr_t) noexcept {}
+
+  InlineTask(::base::OnceClosure closure)
+  {
+    if(closure)
+    {
+      emplace<OnceClosureAdapter>(OnceClosureAdapter{RVALUE_CAST(closure)});
+    }
+  }
+
+  template <
+    typename Func
+    , typename = std::enable_if_t<
+        !std::is_same_v<std::decay_t<Func>, InlineTask>
+        && !std::is_same_v<std::decay_t<Func>, ::base::OnceClosure>
+        && !std::is_same_v<std::decay_t<Func>, std::nullptr_t>
+        && std::is_invocable_r_v<void, std::decay_t<Func>&>
+      >
+  >
+  InlineTask(Func&& func)
+  {
+    emplace<std::decay_t<Func>>(std::forward<Func>(func));
+  }
+
+  InlineTask(InlineTask&& other) noexcept
+  {
+    moveFrom(other);
+  }
+
+  InlineTask& operator=(InlineTask&& other) noexcept
+  {
+    if(this != &other)
+    {
+      Reset();
+      moveFrom(other);
+    }
+    return *this;
+  }
+
+  ~InlineTask()
+  {
+    Reset();
+  }
+
+  bool is_null() const noexcept
+  {
+    return ops_ == nullptr;
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return !is_null();
+  }
+
+  // Destroys stored callable without run.
+  void Reset() noexcept
+  {
+    if(ops_)
+    {
+      const Ops* ops = ops_;
+      ops_ = nullptr;
+      ops->destroy(&storage_);
+    }
+  }
+
+  // Runs and destroys stored callable.
+  void Run() &&
+  {
+    DCHECK(ops_);
+
+    ops_->invoke(&storage_);
+    Reset();
+  }
+
+  // For APIs that require `base::OnceClosure`
+  // (like `base::TaskRunner::PostTask`).
+  /// \note allocates `BindState`.
+  MUST_USE_RETURN_VALUE
+  ::base::OnceClosure ToOnceClosure() &&
+  {
+    if(is_null())
+    {
+      return ::base::OnceClosure();
+    }
+
+    return ::base::BindOnce(
+      [](InlineTask task)
+      {
+        RVALUE_CAST(task).Run();
+      }
+      , RVALUE_CAST(*this));
+  }
+
+ private:
+  struct Ops
+  {
+    void (*invoke)(void* storage);
+    // Move constructs callable into `to` and destroys callable in `from`.
+    void (*relocate)(void* from, void* to) noexcept;
+    void (*destroy)(void* storage) noexcept;
+  };
+
+  struct OnceClosureAdapter
+  {
+    void operator()()
+    {
+      RVALUE_CAST(closure).Run();
+    }
+
+    ::base::OnceClosure closure;
+  };
+
+  template <typename Func>
+  struct InlineOps
+  {
+    static Func* get(void* storage) noexcept
+    {
+      return std::launder(reinterpret_cast<Func*>(storage));
+    }
+
+    static void invoke(void* storage)
+    {
+      (*get(storage))();
+    }
+
+    static void relocate(void* from, void* to) noexcept
+    {
+      Func* func = get(from);
+      new (to) Func(RVALUE_CAST(*func));
+      func->~Func();
+    }
+
+    static void destroy(void* storage) noexcept
+    {
+      get(storage)->~Func();
+    }
+
+    static constexpr Ops kOps{&invoke, &relocate, &destroy};
+  };
+
+  template <typename Func>
+  struct HeapOps
+  {
+    static Func*& get(void* storage) noexcept
+    {
+      return *std::launder(reinterpret_cast<Func**>(storage));
+    }
+
+    static void invoke(void* storage)
+    {
+      (*get(storage))();
+    }
+
+    static void relocate(void* from, void* to) noexcept
+    {
+      new (to) Func*(get(from));
+      get(from) = nullptr;
+    }
+
+    static void destroy(void* storage) noexcept
+    {
+      delete get(storage);
+    }
+
+    static constexpr Ops kOps{&invoke, &relocate, &destroy};
+  };
+
+  template <typename Func, typename Arg>
+  void emplace(Arg&& arg)
+  {
+    if constexpr (IsStoredInline<Func>())
+    {
+      new (&storage_) Func(std::forward<Arg>(arg));
+      ops_ = &InlineOps<Func>::kOps;
+    }
+    else
+    {
+      new (&storage_) Func*(new Func(std::forward<Arg>(arg)));
+      ops_ = &HeapOps<Func>::kOps;
+    }
+  }
+
+  void moveFrom(InlineTask& other) noexcept
+  {
+    DCHECK(!ops_);
+
+    if(other.ops_)
+    {
+      other.ops_->relocate(&other.storage_, &storage_);
+      ops_ = other.ops_;
+      other.ops_ = nullptr;
+    }
+  }
+
+ private:
+  std::aligned_storage_t<kInlineSize, kInlineAlignment> storage_;
+
+  const Ops* ops_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(InlineTask);
+};
+
+static_assert(sizeof(InlineTask) <= 64
+  , "InlineTask must fit into single cache line");
+
+} // namespace basis
@@ -0,0 +1,100 @@
+#include "basis/task/inline_task.h"
+
+#include "base/bind.h"
+#include "base/callback.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <array>
+#include <memory>
+#include <utility>
+
+namespace basis {
+namespace {
+
+// Counts live instances, so test can check that captures are destroyed.
+struct InstanceCounter {
+  explicit InstanceCounter(int* instances) : instances(instances) {
+    ++(*instances);
+  }
+  InstanceCounter(InstanceCounter&& other) noexcept
+      : instances(other.instances) {
+    ++(*instances);
+  }
+  ~InstanceCounter() { --(*instances); }
+
+  int* instances;
+};
+
+TEST(InlineTaskTest, SmallLambdaIsStoredInline) {
+  int counter = 0;
+  auto lambda = [&counter]() { ++counter; };
+  static_assert(InlineTask::IsStoredInline<decltype(lambda)>(),
+                "small lambda must be stored inline");
+
+  InlineTask task(std::move(lambda));
+  EXPECT_TRUE(task);
+
+  std::move(task).Run();
+  EXPECT_EQ(1, counter);
+  EXPECT_TRUE(task.is_null());
+}
+
+TEST(InlineTaskTest, LargeLambdaIsStoredOnHeap) {
+  std::array<int, 32> values{};
+  values[31] = 5;
+  int result = 0;
+  auto lambda = [values, &result]() { result = values[31]; };
+  static_assert(!InlineTask::IsStoredInline<decltype(lambda)>(),
+                "large lambda must be stored on heap");
+
+  InlineTask task(std::move(lambda));
+  InlineTask moved(std::move(task));
+  EXPECT_TRUE(task.is_null());
+
+  std::move(moved).Run();
+  EXPECT_EQ(5, result);
+}
+
+TEST(InlineTaskTest, AcceptsOnceClosure) {
+  int counter = 0;
+  InlineTask task(base::BindOnce([](int* counter) { ++(*counter); },
+                                 base::Unretained(&counter)));
+  std::move(task).Run();
+  EXPECT_EQ(1, counter);
+
+  EXPECT_TRUE(InlineTask(base::OnceClosure()).is_null());
+}
+
+TEST(InlineTaskTest, MoveOnlyCapturesAreDestroyed) {
+  int instances = 0;
+  {
+    InlineTask task([counter = InstanceCounter(&instances),
+                     ptr = std::make_unique<int>(1)]() {});
+    EXPECT_EQ(1, instances);
+
+    InlineTask other;
+    other = std::move(task);
+    EXPECT_EQ(1, instances);
+  }
+  // destroyed without run
+  EXPECT_EQ(0, instances);
+
+  InlineTask task([counter = InstanceCounter(&instances)]() {});
+  std::move(task).Run();
+  EXPECT_EQ(0, instances);
+}
+
+TEST(InlineTaskTest, ToOnceClosure) {
+  int counter = 0;
+  base::OnceClosure closure =
+      InlineTask([&counter]() { ++counter; }).ToOnceClosure();
+  ASSERT_TRUE(closure);
+  std::move(closure).Run();
+  EXPECT_EQ(1, counter);
+
+  EXPECT_TRUE(InlineTask().ToOnceClosure().is_null());
+}
+
+}  // namespace
+}  // namespace basis
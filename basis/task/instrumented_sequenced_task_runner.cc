@@ -0,0 +1,212 @@
+#include "basis/task/instrumented_sequenced_task_runner.h" // IWYU pragma: associated
+
+#include "basis/task/atomic_max.h"
+
+#include <base/bind.h>
+#include <base/callback_helpers.h>
+#include <base/hash/hash.h>
+#include <base/logging.h>
+#include <base/metrics/histogram.h>
+#include <base/trace_event/trace_event.h>
+
+#include <basic/rvalue_cast.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace basis {
+
+namespace {
+
+::base::HistogramBase* getTimesHistogram(const std::string& name)
+{
+  return ::base::Histogram::FactoryMicrosecondsTimeGet(
+    name
+    , ::base::TimeDelta::FromMicroseconds(1)
+    , ::base::TimeDelta::FromSeconds(10)
+    , 50
+    , ::base::HistogramBase::kUmaTargetedHistogramFlag);
+}
+
+} // namespace
+
+int32_t hashPostingLocation(const ::base::Location& from_here)
+{
+  const char* file_name = from_here.file_name();
+  const uint32_t file_hash
+    = file_name
+      ? ::base::PersistentHash(file_name, std::strlen(file_name))
+      : 0u;
+  return static_cast<int32_t>(
+    ::base::HashInts32(file_hash
+      , static_cast<uint32_t>(from_here.line_number()))
+    % static_cast<uint32_t>(kPostingLocationBuckets));
+}
+
+InstrumentedSequencedTaskRunner::InstrumentedSequencedTaskRunner(
+  const std::string& name
+  , scoped_refptr<::base::SequencedTaskRunner> task_runner)
+  : name_(name)
+  , task_runner_(RVALUE_CAST(task_runner))
+  , queue_latency_histogram_(
+      getTimesHistogram("Basis.TaskRunner." + name + ".QueueLatency"))
+  , run_duration_histogram_(
+      getTimesHistogram("Basis.TaskRunner." + name + ".RunDuration"))
+  , queue_depth_histogram_(
+      ::base::Histogram::FactoryGet(
+        "Basis.TaskRunner." + name + ".QueueDepth"
+        , 1
+        , 10000
+        , 50
+        , ::base::HistogramBase::kUmaTargetedHistogramFlag))
+  , posted_from_histogram_(
+      // one bucket per value
+      ::base::LinearHistogram::FactoryGet(
+        "Basis.TaskRunner." + name + ".PostedFrom"
+        , 1
+        , kPostingLocationBuckets
+        , kPostingLocationBuckets + 1
+        , ::base::HistogramBase::kUmaTargetedHistogramFlag))
+{
+  DCHECK(!name_.empty());
+  DCHECK(task_runner_);
+}
+
+InstrumentedSequencedTaskRunner::~InstrumentedSequencedTaskRunner() = default;
+
+bool InstrumentedSequencedTaskRunner::PostDelayedTask(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , ::base::TimeDelta delay)
+{
+  onTaskQueued(from_here);
+  /// \note if task was not posted, then it is destroyed without run
+  /// and queue depth is decremented by `wrapTask`
+  return task_runner_->PostDelayedTask(
+    from_here
+    , wrapTask(from_here, RVALUE_CAST(task), delay)
+    , delay);
+}
+
+bool InstrumentedSequencedTaskRunner::PostNonNestableDelayedTask(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , ::base::TimeDelta delay)
+{
+  onTaskQueued(from_here);
+  return task_runner_->PostNonNestableDelayedTask(
+    from_here
+    , wrapTask(from_here, RVALUE_CAST(task), delay)
+    , delay);
+}
+
+bool InstrumentedSequencedTaskRunner::RunsTasksInCurrentSequence() const
+{
+  return task_runner_->RunsTasksInCurrentSequence();
+}
+
+::base::OnceClosure InstrumentedSequencedTaskRunner::wrapTask(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , ::base::TimeDelta delay)
+{
+  DCHECK(task) << from_here.ToString();
+
+  // Keeps `this` alive until task is run or destroyed.
+  return ::base::BindOnce(
+    &InstrumentedSequencedTaskRunner::runTask
+    , scoped_refptr<InstrumentedSequencedTaskRunner>(this)
+    , ::base::TimeTicks::Now() + delay
+    , RVALUE_CAST(task)
+    // Task may be destroyed without run
+    // (if task runner is shutting down or rejected task).
+    , ::base::ScopedClosureRunner(::base::BindOnce(
+        &InstrumentedSequencedTaskRunner::onTaskDropped
+        , scoped_refptr<InstrumentedSequencedTaskRunner>(this))));
+}
+
+void InstrumentedSequencedTaskRunner::runTask(
+  ::base::TimeTicks expected_run_time
+  , ::base::OnceClosure task
+  , ::base::ScopedClosureRunner drop_guard)
+{
+  // task is not dropped
+  ignore_result(drop_guard.Release());
+
+  const ::base::TimeTicks start = ::base::TimeTicks::Now();
+  const ::base::TimeDelta latency
+    = std::max(::base::TimeDelta(), start - expected_run_time);
+
+  RVALUE_CAST(task).Run();
+
+  const ::base::TimeDelta duration = ::base::TimeTicks::Now() - start;
+
+  const int64_t latency_us = latency.InMicroseconds();
+  const int64_t duration_us = duration.InMicroseconds();
+
+  tasks_run_.fetch_add(1, std::memory_order_relaxed);
+  total_queue_latency_us_.fetch_add(latency_us, std::memory_order_relaxed);
+  updateAtomicMax(max_queue_latency_us_, latency_us);
+  total_run_duration_us_.fetch_add(duration_us, std::memory_order_relaxed);
+  updateAtomicMax(max_run_duration_us_, duration_us);
+
+  queue_latency_histogram_->AddTimeMicrosecondsGranularity(latency);
+  run_duration_histogram_->AddTimeMicrosecondsGranularity(duration);
+
+  const int64_t depth
+    = queue_depth_.fetch_sub(1, std::memory_order_relaxed) - 1;
+  DCHECK_GE(depth, 0);
+  TRACE_COUNTER_ID1("basis.task_runner", "TaskRunnerQueueDepth", this, depth);
+}
+
+void InstrumentedSequencedTaskRunner::onTaskQueued(
+  const ::base::Location& from_here)
+{
+  tasks_posted_.fetch_add(1, std::memory_order_relaxed);
+  const int64_t depth
+    = queue_depth_.fetch_add(1, std::memory_order_relaxed) + 1;
+  updateAtomicMax(max_queue_depth_, depth);
+  recordQueueDepth(depth);
+  posted_from_histogram_->Add(hashPostingLocation(from_here));
+}
+
+void InstrumentedSequencedTaskRunner::onTaskDropped()
+{
+  const int64_t depth
+    = queue_depth_.fetch_sub(1, std::memory_order_relaxed) - 1;
+  DCHECK_GE(depth, 0);
+  TRACE_COUNTER_ID1("basis.task_runner", "TaskRunnerQueueDepth", this, depth);
+}
+
+void InstrumentedSequencedTaskRunner::recordQueueDepth(int64_t depth)
+{
+  queue_depth_histogram_->Add(static_cast<int>(
+    std::min<int64_t>(depth, std::numeric_limits<int>::max())));
+  TRACE_COUNTER_ID1("basis.task_runner", "TaskRunnerQueueDepth", this, depth);
+}
+
+InstrumentedSequencedTaskRunner::Snapshot
+  InstrumentedSequencedTaskRunner::GetSnapshot() const
+{
+  Snapshot snapshot;
+  snapshot.queue_depth
+    = queue_depth_.load(std::memory_order_relaxed);
+  snapshot.max_queue_depth
+    = max_queue_depth_.load(std::memory_order_relaxed);
+  snapshot.tasks_posted
+    = tasks_posted_.load(std::memory_order_relaxed);
+  snapshot.tasks_run
+    = tasks_run_.load(std::memory_order_relaxed);
+  snapshot.total_queue_latency = ::base::TimeDelta::FromMicroseconds(
+    total_queue_latency_us_.load(std::memory_order_relaxed));
+  snapshot.max_queue_latency = ::base::TimeDelta::FromMicroseconds(
+    max_queue_latency_us_.load(std::memory_order_relaxed));
+  snapshot.total_run_duration = ::base::TimeDelta::FromMicroseconds(
+    total_run_duration_us_.load(std::memory_order_relaxed));
+  snapshot.max_run_duration = ::base::TimeDelta::FromMicroseconds(
+    max_run_duration_us_.load(std::memory_order_relaxed));
+  return snapshot;
+}
+
+} // namespace basis
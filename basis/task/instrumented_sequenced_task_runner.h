@@ -0,0 +1,161 @@
+#pragma once
+
+#include <base/callback.h>
+#include <base/callback_helpers.h>
+#include <base/location.h>
+#include <base/macros.h>
+#include <base/memory/scoped_refptr.h>
+#include <base/sequenced_task_runner.h>
+#include <base/time/time.h>
+
+#include <basic/macros.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace base {
+class HistogramBase;
+} // namespace base
+
+namespace basis {
+
+// Decorator for `base::SequencedTaskRunner` that records telemetry
+// about each posted task:
+// * enqueue-to-run latency (delay of delayed tasks is not counted)
+// * run duration
+// * queue depth (tasks posted, but not finished yet)
+// * posting location hot spots
+//
+// Telemetry is exported:
+// * as histograms (see `base::StatisticsRecorder`,
+//   initialized by `ScopedBaseEnvironment`):
+//   `Basis.TaskRunner.<name>.QueueLatency`
+//   `Basis.TaskRunner.<name>.RunDuration`
+//   `Basis.TaskRunner.<name>.QueueDepth`
+//   `Basis.TaskRunner.<name>.PostedFrom` (linear, samples are
+//   `basis::hashPostingLocation` of `from_here`)
+// * as trace counters `TaskRunnerQueueDepth` (category `basis.task_runner`)
+// * via `GetSnapshot()`
+//
+/// \note Histograms in `base` use atomic counters,
+/// so recording does not take locks after histogram creation.
+//
+// USAGE
+//
+//  scoped_refptr<::base::SequencedTaskRunner> taskRunner
+//    = ::base::MakeRefCounted<::basis::InstrumentedSequencedTaskRunner>(
+//        "ECS"
+//        , ::base::ThreadPool::CreateSequencedTaskRunner(...));
+class InstrumentedSequencedTaskRunner
+  : public ::base::SequencedTaskRunner
+{
+ public:
+  struct Snapshot
+  {
+    int64_t queue_depth = 0;
+    int64_t max_queue_depth = 0;
+    uint64_t tasks_posted = 0;
+    uint64_t tasks_run = 0;
+    ::base::TimeDelta total_queue_latency;
+    ::base::TimeDelta max_queue_latency;
+    ::base::TimeDelta total_run_duration;
+    ::base::TimeDelta max_run_duration;
+  };
+
+  InstrumentedSequencedTaskRunner(
+    const std::string& name
+    , scoped_refptr<::base::SequencedTaskRunner> task_runner);
+
+  // base::SequencedTaskRunner
+  bool PostDelayedTask(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , ::base::TimeDelta delay) override;
+
+  bool PostNonNestableDelayedTask(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , ::base::TimeDelta delay) override;
+
+  bool RunsTasksInCurrentSequence() const override;
+
+  MUST_USE_RETURN_VALUE
+  Snapshot GetSnapshot() const;
+
+  const std::string& name() const
+  {
+    return name_;
+  }
+
+  // Returns decorated task runner.
+  const scoped_refptr<::base::SequencedTaskRunner>& task_runner() const
+  {
+    return task_runner_;
+  }
+
+ private:
+  ~InstrumentedSequencedTaskRunner() override;
+
+  MUST_USE_RETURN_VALUE
+  ::base::OnceClosure wrapTask(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , ::base::TimeDelta delay);
+
+  void runTask(
+    ::base::TimeTicks expected_run_time
+    , ::base::OnceClosure task
+    , ::base::ScopedClosureRunner drop_guard);
+
+  void onTaskQueued(const ::base::Location& from_here);
+
+  // Called if task was destroyed without run.
+  void onTaskDropped();
+
+  void recordQueueDepth(int64_t depth);
+
+ private:
+  const std::string name_;
+
+  scoped_refptr<::base::SequencedTaskRunner> task_runner_;
+
+  std::atomic<int64_t> queue_depth_{0};
+
+  std::atomic<int64_t> max_queue_depth_{0};
+
+  std::atomic<uint64_t> tasks_posted_{0};
+
+  std::atomic<uint64_t> tasks_run_{0};
+
+  std::atomic<int64_t> total_queue_latency_us_{0};
+
+  std::atomic<int64_t> max_queue_latency_us_{0};
+
+  std::atomic<int64_t> total_run_duration_us_{0};
+
+  std::atomic<int64_t> max_run_duration_us_{0};
+
+  // Histograms are owned by `base::StatisticsRecorder`.
+  ::base::HistogramBase* queue_latency_histogram_;
+
+  ::base::HistogramBase* run_duration_histogram_;
+
+  ::base::HistogramBase* queue_depth_histogram_;
+
+  ::base::HistogramBase* posted_from_histogram_;
+
+  DISALLOW_COPY_AND_ASSIGN(InstrumentedSequencedTaskRunner);
+};
+
+// Number of buckets in `Basis.TaskRunner.<name>.PostedFrom`.
+constexpr int32_t kPostingLocationBuckets = 1000;
+
+// Returns stable hash of `file:line` (same between runs)
+// in range [0, kPostingLocationBuckets),
+// used as sample of `Basis.TaskRunner.<name>.PostedFrom`.
+/// \note Histogram has fixed buckets (sparse histogram takes lock
+/// on each sample), so different locations may share bucket.
+int32_t hashPostingLocation(const ::base::Location& from_here);
+
+} // namespace basis
@@ -0,0 +1,79 @@
+#include "basis/task/instrumented_sequenced_task_runner.h"
+
+#include "base/bind.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/metrics/histogram_base.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace basis {
+namespace {
+
+class InstrumentedSequencedTaskRunnerTest : public testing::Test {
+ protected:
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+};
+
+TEST_F(InstrumentedSequencedTaskRunnerTest, RecordsTasks) {
+  scoped_refptr<InstrumentedSequencedTaskRunner> task_runner =
+      base::MakeRefCounted<InstrumentedSequencedTaskRunner>(
+          "InstrumentedTest", base::SequencedTaskRunnerHandle::Get());
+
+  const base::Location from_here = FROM_HERE;
+  int counter = 0;
+  for (int i = 0; i < 3; ++i) {
+    task_runner->PostTask(
+        from_here,
+        base::BindOnce([](int* counter) { ++(*counter); },
+                       base::Unretained(&counter)));
+  }
+
+  InstrumentedSequencedTaskRunner::Snapshot queued =
+      task_runner->GetSnapshot();
+  EXPECT_EQ(3, queued.queue_depth);
+  EXPECT_EQ(3u, queued.tasks_posted);
+  EXPECT_EQ(0u, queued.tasks_run);
+
+  base::RunLoop().RunUntilIdle();
+
+  InstrumentedSequencedTaskRunner::Snapshot done = task_runner->GetSnapshot();
+  EXPECT_EQ(3, counter);
+  EXPECT_EQ(0, done.queue_depth);
+  EXPECT_EQ(3, done.max_queue_depth);
+  EXPECT_EQ(3u, done.tasks_run);
+
+  base::HistogramBase* latency = base::StatisticsRecorder::FindHistogram(
+      "Basis.TaskRunner.InstrumentedTest.QueueLatency");
+  ASSERT_TRUE(latency);
+  EXPECT_EQ(3, latency->SnapshotSamples()->TotalCount());
+
+  base::HistogramBase* posted_from = base::StatisticsRecorder::FindHistogram(
+      "Basis.TaskRunner.InstrumentedTest.PostedFrom");
+  ASSERT_TRUE(posted_from);
+  // all tasks were posted from same location
+  EXPECT_EQ(3, posted_from->SnapshotSamples()->GetCount(
+      hashPostingLocation(from_here)));
+}
+
+TEST_F(InstrumentedSequencedTaskRunnerTest, DelayIsNotLatency) {
+  scoped_refptr<InstrumentedSequencedTaskRunner> task_runner =
+      base::MakeRefCounted<InstrumentedSequencedTaskRunner>(
+          "InstrumentedDelayTest", base::SequencedTaskRunnerHandle::Get());
+
+  task_runner->PostDelayedTask(FROM_HERE, base::DoNothing(),
+                               base::TimeDelta::FromSeconds(10));
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(11));
+
+  InstrumentedSequencedTaskRunner::Snapshot done = task_runner->GetSnapshot();
+  EXPECT_EQ(1u, done.tasks_run);
+  EXPECT_LT(done.max_queue_latency, base::TimeDelta::FromSeconds(10));
+}
+
+}  // namespace
+}  // namespace basis
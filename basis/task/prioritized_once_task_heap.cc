@@ -7,6 +7,8 @@
 
 #include <basic/rvalue_cast.h>
 
+#include "basis/memory/scoped_memory_dump_provider.h"
+
 #include <queue>
 
 namespace {
@@ -39,7 +41,7 @@ bool PrioritizedOnceTaskHeap::CalledOnValidSequenceOrUsesLocks() const {
 
 PrioritizedOnceTaskHeap::Job::Job(
   const ::base::Location& from_here,
-  OnceTask&& task,
+  InlineTask&& task,
   TaskPriority priority,
   TaskId current_task_count)
   : from_here(from_here),
@@ -83,7 +85,7 @@ void PrioritizedOnceTaskHeap::ScheduleTask(
     from_here
     , RVALUE_CAST(onceTask)
     , priority
-    , max_task_count_++);
+    , 0);
 
   DCHECK(job.task)
     << "Unexpected once task. Location: "
@@ -91,6 +93,9 @@ void PrioritizedOnceTaskHeap::ScheduleTask(
 
   {
     AcquireLockIfNeeded();
+    // task id is assigned under lock, so tasks posted
+    // from multiple threads will have unique ids
+    job.task_id = max_task_count_++;
     task_job_heap_.push_back(RVALUE_CAST(job));
     // Add element at the end of the heap.
     // If that is not its right position,
@@ -127,6 +132,14 @@ void PrioritizedOnceTaskHeap::ScheduleTask(
   const ::base::Location& from_here
   , OnceTask&& task
   , TaskPriority priority)
+{
+  ScheduleTask(from_here, InlineTask(RVALUE_CAST(task)), priority);
+}
+
+void PrioritizedOnceTaskHeap::ScheduleTask(
+  const ::base::Location& from_here
+  , InlineTask&& task
+  , TaskPriority priority)
 {
   DCHECK(CalledOnValidSequenceOrUsesLocks());
 
@@ -138,10 +151,11 @@ void PrioritizedOnceTaskHeap::ScheduleTask(
     from_here
     , RVALUE_CAST(task)
     , priority
-    , max_task_count_++);
+    , 0);
 
   {
     AcquireLockIfNeeded();
+    job.task_id = max_task_count_++;
     task_job_heap_.push_back(RVALUE_CAST(job));
     // Add element at the end of the heap.
     // If that is not its right position,
@@ -155,7 +169,9 @@ PrioritizedOnceTaskHeap::~PrioritizedOnceTaskHeap()
 {
   /// \note destruction must be always performed
   /// on same thread that used during construction
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  /// (unless heap uses locks, so last reference may be released
+  /// on any thread)
+  DCHECK(CalledOnValidSequenceOrUsesLocks());
 }
 
 void PrioritizedOnceTaskHeap::RunAllTasks()
@@ -174,12 +190,16 @@ void PrioritizedOnceTaskHeap::RunAndPopLargestTask()
 {
   DCHECK(CalledOnValidSequenceOrUsesLocks());
 
-  base::OnceClosure closureWithoutLock;
+  InlineTask closureWithoutLock;
 
   auto retrieveTask = [&]() {
     DCHECK(CalledOnValidSequenceOrUsesLocks());
     AssertAcquiredLockIfNeeded();
 
+    if(task_job_heap_.empty()) {
+      return;
+    }
+
     // We can only remove one element, the root heap element
     // i.e. next job to run.
     // Moves the largest to the end
@@ -218,6 +238,22 @@ void PrioritizedOnceTaskHeap::RunAndPopLargestTask()
   }
 }
 
+void PrioritizedOnceTaskHeap::Clear()
+{
+  DCHECK(CalledOnValidSequenceOrUsesLocks());
+
+  std::vector<Job> jobsWithoutLock;
+
+  {
+    AcquireLockIfNeeded();
+    jobsWithoutLock.swap(task_job_heap_);
+    ReleaseLockIfNeeded();
+  }
+
+  // bound arguments of tasks may be heavy, so destroy them without lock
+  jobsWithoutLock.clear();
+}
+
 size_t PrioritizedOnceTaskHeap::size() noexcept
 {
   DCHECK(CalledOnValidSequenceOrUsesLocks());
@@ -233,4 +269,27 @@ size_t PrioritizedOnceTaskHeap::size() noexcept
   return size;
 }
 
+void PrioritizedOnceTaskHeap::DumpMemoryStats(
+  const std::string& dump_name
+  , ::base::trace_event::ProcessMemoryDump* pmd)
+{
+  DCHECK(CalledOnValidSequenceOrUsesLocks());
+
+  size_t size{0u};
+  size_t capacity{0u};
+
+  {
+    AcquireLockIfNeeded();
+    size = task_job_heap_.size();
+    capacity = task_job_heap_.capacity();
+    ReleaseLockIfNeeded();
+  }
+
+  /// \note does not include memory owned by bound arguments of tasks
+  ::basis::addAllocatorDump(pmd
+    , dump_name
+    , capacity * sizeof(Job)
+    , size);
+}
+
 }  // namespace basis
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <vector>
 #include <chrono>
+#include <string>
 
 #include <base/bind.h>
 #include <base/callback.h>
@@ -15,6 +16,14 @@
 #include <base/time/time.h>
 #include <base/trace_event/trace_event.h>
 
+#include "basis/task/inline_task.h"
+
+namespace base {
+namespace trace_event {
+class ProcessMemoryDump;
+} // namespace trace_event
+} // namespace base
+
 namespace basis {
 
 // ScopedAllowCrossThreadPrioritizedOnceTaskHeapAccess disables the check
@@ -71,7 +80,7 @@ class PrioritizedOnceTaskHeap
 
   struct Job {
     Job(const ::base::Location& from_here,
-        OnceTask&& task,
+        InlineTask&& task,
         TaskPriority priority,
         TaskId current_task_count);
     Job();
@@ -81,7 +90,9 @@ class PrioritizedOnceTaskHeap
     Job& operator=(Job&& other);
 
     ::base::Location from_here;
-    OnceTask task;
+    /// \note small callables are stored without heap allocation,
+    /// see `InlineTask`
+    InlineTask task;
     TaskPriority priority = 0;
     // task id based on `max_task_count_` at the moment of construction
     TaskId task_id = 0;
@@ -117,12 +128,31 @@ class PrioritizedOnceTaskHeap
     , OnceTask&& task
     , TaskPriority priority);
 
+  // Avoids allocation of `base::OnceClosure` (`BindState`)
+  // if callable fits into `InlineTask`.
+  void ScheduleTask(
+    const ::base::Location& from_here
+    , InlineTask&& task
+    , TaskPriority priority);
+
+  /// \note does nothing if heap is empty.
   void RunAndPopLargestTask();
 
   void RunAllTasks();
 
+  // Destroys all stored tasks without running them.
+  /// \note tasks are destroyed without lock.
+  void Clear();
+
   size_t size() noexcept;
 
+  // Adds allocator dump `dump_name` (capacity of heap in bytes
+  // and number of stored tasks) to `pmd`.
+  // See `::basis::ScopedMemoryDumpProvider`.
+  void DumpMemoryStats(
+    const std::string& dump_name
+    , ::base::trace_event::ProcessMemoryDump* pmd);
+
  private:
   friend class ::base::RefCountedThreadSafe<PrioritizedOnceTaskHeap>;
 
@@ -0,0 +1,90 @@
+#include "basis/task/prioritized_once_task_heap.h"
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/location.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/test/task_environment.h"
+
+#include <benchmark/benchmark.h>
+
+namespace basis {
+
+namespace {
+
+void IncrementCounter(int* counter) {
+  ++(*counter);
+}
+
+// Pushes `state.range(0)` tasks with pseudo-random priorities
+// and pops all of them.
+void BM_PrioritizedOnceTaskHeapPushPop(benchmark::State& state) {
+  base::test::TaskEnvironment task_environment;
+
+  const int tasks_count = state.range(0);
+  const bool with_thread_locking = state.range(1);
+
+  scoped_refptr<PrioritizedOnceTaskHeap> heap =
+      base::MakeRefCounted<PrioritizedOnceTaskHeap>(with_thread_locking);
+
+  int counter = 0;
+
+  for (auto _ : state) {
+    for (int i = 0; i < tasks_count; ++i) {
+      heap->ScheduleTask(FROM_HERE
+        , base::BindOnce(&IncrementCounter, base::Unretained(&counter))
+        // pseudo-random priority, keeps results reproducible
+        , (i * 7919) % tasks_count);
+    }
+    heap->RunAllTasks();
+  }
+
+  benchmark::DoNotOptimize(counter);
+  state.SetItemsProcessed(state.iterations() * tasks_count);
+}
+BENCHMARK(BM_PrioritizedOnceTaskHeapPushPop)
+  ->ArgNames({"tasks", "locking"})
+  ->Args({16, 0})
+  ->Args({256, 0})
+  ->Args({4096, 0})
+  ->Args({16, 1})
+  ->Args({256, 1})
+  ->Args({4096, 1});
+
+// Same as `BM_PrioritizedOnceTaskHeapPushPop`, but schedules lambdas
+// stored inline by `InlineTask` (no `BindState` allocations).
+void BM_PrioritizedOnceTaskHeapPushPopInline(benchmark::State& state) {
+  base::test::TaskEnvironment task_environment;
+
+  const int tasks_count = state.range(0);
+  const bool with_thread_locking = state.range(1);
+
+  scoped_refptr<PrioritizedOnceTaskHeap> heap =
+      base::MakeRefCounted<PrioritizedOnceTaskHeap>(with_thread_locking);
+
+  int counter = 0;
+
+  for (auto _ : state) {
+    for (int i = 0; i < tasks_count; ++i) {
+      heap->ScheduleTask(FROM_HERE
+        , InlineTask([&counter]() { IncrementCounter(&counter); })
+        , (i * 7919) % tasks_count);
+    }
+    heap->RunAllTasks();
+  }
+
+  benchmark::DoNotOptimize(counter);
+  state.SetItemsProcessed(state.iterations() * tasks_count);
+}
+BENCHMARK(BM_PrioritizedOnceTaskHeapPushPopInline)
+  ->ArgNames({"tasks", "locking"})
+  ->Args({16, 0})
+  ->Args({256, 0})
+  ->Args({4096, 0})
+  ->Args({16, 1})
+  ->Args({256, 1})
+  ->Args({4096, 1});
+
+}  // namespace
+
+}  // namespace basis
@@ -0,0 +1,173 @@
+#include "basis/task/prioritized_sequenced_task_runner.h" // IWYU pragma: associated
+
+#include <base/bind.h>
+#include <base/logging.h>
+#include <base/trace_event/trace_event.h>
+
+#include <basic/rvalue_cast.h>
+
+namespace basis {
+
+PrioritizedSequencedTaskRunner::PrioritizedSequencedTaskRunner(
+  scoped_refptr<::base::SequencedTaskRunner> task_runner
+  , TaskPriority default_priority
+  , ::base::TimeDelta time_budget)
+  : task_runner_(RVALUE_CAST(task_runner))
+  , default_priority_(default_priority)
+  , time_budget_(time_budget)
+  , task_heap_(::base::MakeRefCounted<PrioritizedOnceTaskHeap>(
+      /* with_thread_locking */ true))
+{
+  DCHECK(task_runner_);
+  DCHECK_GE(time_budget_, ::base::TimeDelta());
+}
+
+PrioritizedSequencedTaskRunner::~PrioritizedSequencedTaskRunner() = default;
+
+bool PrioritizedSequencedTaskRunner::PostTaskWithPriority(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , TaskPriority priority)
+{
+  return scheduleTask(from_here, InlineTask(RVALUE_CAST(task)), priority);
+}
+
+bool PrioritizedSequencedTaskRunner::PostTaskWithPriority(
+  const ::base::Location& from_here
+  , InlineTask task
+  , TaskPriority priority)
+{
+  return scheduleTask(from_here, RVALUE_CAST(task), priority);
+}
+
+bool PrioritizedSequencedTaskRunner::PostDelayedTaskWithPriority(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , TaskPriority priority
+  , ::base::TimeDelta delay)
+{
+  if(delay <= ::base::TimeDelta())
+  {
+    return scheduleTask(from_here, InlineTask(RVALUE_CAST(task)), priority);
+  }
+
+  // Keeps `this` alive until delay expires.
+  return task_runner_->PostDelayedTask(
+    from_here
+    , ::base::BindOnce(
+        ::base::IgnoreResult(&PrioritizedSequencedTaskRunner::scheduleTask)
+        , scoped_refptr<PrioritizedSequencedTaskRunner>(this)
+        , from_here
+        , InlineTask(RVALUE_CAST(task))
+        , priority)
+    , delay);
+}
+
+bool PrioritizedSequencedTaskRunner::PostDelayedTask(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , ::base::TimeDelta delay)
+{
+  return PostDelayedTaskWithPriority(
+    from_here
+    , RVALUE_CAST(task)
+    , default_priority_
+    , delay);
+}
+
+bool PrioritizedSequencedTaskRunner::PostNonNestableDelayedTask(
+  const ::base::Location& from_here
+  , ::base::OnceClosure task
+  , ::base::TimeDelta delay)
+{
+  // tasks from heap are never run from nested loop
+  return PostDelayedTask(from_here, RVALUE_CAST(task), delay);
+}
+
+bool PrioritizedSequencedTaskRunner::RunsTasksInCurrentSequence() const
+{
+  return task_runner_->RunsTasksInCurrentSequence();
+}
+
+size_t PrioritizedSequencedTaskRunner::pending_task_count() const
+{
+  return task_heap_->size();
+}
+
+bool PrioritizedSequencedTaskRunner::scheduleTask(
+  const ::base::Location& from_here
+  , InlineTask task
+  , TaskPriority priority)
+{
+  DCHECK(task) << from_here.ToString();
+
+  if(shut_down_.load(std::memory_order_acquire))
+  {
+    return false;
+  }
+
+  task_heap_->ScheduleTask(from_here, RVALUE_CAST(task), priority);
+
+  return schedulePumpIfNeeded();
+}
+
+bool PrioritizedSequencedTaskRunner::schedulePumpIfNeeded()
+{
+  if(pump_scheduled_.exchange(true, std::memory_order_acq_rel))
+  {
+    // already scheduled pump will see task in heap
+    return true;
+  }
+
+  // Keeps `this` alive until all tasks in heap are run.
+  const bool posted = task_runner_->PostTask(
+    FROM_HERE
+    , ::base::BindOnce(
+        &PrioritizedSequencedTaskRunner::runPump
+        , scoped_refptr<PrioritizedSequencedTaskRunner>(this)));
+
+  if(!posted)
+  {
+    // `task_runner_` will never run pump, so `false` must mean
+    // that task is dropped: destroy tasks in heap
+    // and reject all next posts.
+    /// \note `pump_scheduled_` stays `true`, so no more pumps are posted.
+    shut_down_.store(true, std::memory_order_release);
+    task_heap_->Clear();
+  }
+
+  return posted;
+}
+
+void PrioritizedSequencedTaskRunner::runPump()
+{
+  DCHECK(task_runner_->RunsTasksInCurrentSequence());
+
+  TRACE_EVENT0("headless", "PrioritizedSequencedTaskRunner::runPump");
+
+  // Tasks posted from now on must schedule next pump
+  // (if this pump will not run them).
+  pump_scheduled_.store(false, std::memory_order_release);
+
+  const ::base::TimeTicks start = ::base::TimeTicks::Now();
+
+  /// \note heap may be cleared concurrently on shutdown,
+  /// `RunAndPopLargestTask()` does nothing if heap is empty.
+  while(task_heap_->size() > 0)
+  {
+    task_heap_->RunAndPopLargestTask();
+
+    if(::base::TimeTicks::Now() - start >= time_budget_)
+    {
+      break;
+    }
+  }
+
+  // yield to other tasks of `task_runner_`
+  if(task_heap_->size() > 0)
+  {
+    ignore_result(schedulePumpIfNeeded());
+  }
+}
+
+} // namespace basis
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "basis/task/inline_task.h"
+#include "basis/task/prioritized_once_task_heap.h"
+
+#include <base/callback.h>
+#include <base/location.h>
+#include <base/macros.h>
+#include <base/memory/scoped_refptr.h>
+#include <base/sequenced_task_runner.h>
+#include <base/time/time.h>
+
+#include <basic/macros.h>
+
+#include <atomic>
+#include <cstddef>
+
+namespace basis {
+
+// `base::SequencedTaskRunner` that uses `PrioritizedOnceTaskHeap`
+// as its queue, so latency-critical tasks jump ahead of bulk work
+// posted to same sequence.
+//
+// Tasks run on sequence of `task_runner` (`base::ThreadPool` sequence
+// or task runner of dedicated `base::Thread`).
+// Each wakeup drains heap until it is empty or `time_budget` is exceeded
+// (at least one task runs per wakeup), then yields,
+// so other tasks posted directly to `task_runner` can run between batches.
+//
+// Tasks posted via `PostTask` (`SequencedTaskRunner` API)
+// use `default_priority`.
+//
+/// \note Task with lowest priority value runs first
+/// (see `PrioritizedOnceTaskHeap`).
+/// \note Delayed task is added to heap after its delay expires,
+/// so it is ordered by priority only with tasks that are in heap
+/// at that moment.
+/// \note `base::SequencedTaskRunnerHandle::Get()` inside of task
+/// returns `task_runner`, not `PrioritizedSequencedTaskRunner`.
+/// \note If `task_runner` rejects wakeup (it is shutting down),
+/// then all tasks in heap are destroyed without run
+/// and all next posts return `false`.
+//
+// USAGE
+//
+//  scoped_refptr<::basis::PrioritizedSequencedTaskRunner> entt_runner
+//    = ::base::MakeRefCounted<::basis::PrioritizedSequencedTaskRunner>(
+//        ::base::ThreadPool::CreateSequencedTaskRunner(...)
+//        , /* default_priority */ 100
+//        , /* time_budget */ ::base::TimeDelta::FromMilliseconds(2));
+//
+//  ::application::AppRunners::registerGlobalTaskRunner(
+//    ::application::AppRunners::ENTT, entt_runner);
+//
+//  entt_runner->PostTaskWithPriority(FROM_HERE
+//    , ::base::BindOnce(&onInput)
+//    , ::basis::PrioritizedOnceTaskHeap::kHighestPriority);
+class PrioritizedSequencedTaskRunner
+  : public ::base::SequencedTaskRunner
+{
+ public:
+  using TaskPriority = PrioritizedOnceTaskHeap::TaskPriority;
+
+  PrioritizedSequencedTaskRunner(
+    scoped_refptr<::base::SequencedTaskRunner> task_runner
+    , TaskPriority default_priority
+    , ::base::TimeDelta time_budget);
+
+  bool PostTaskWithPriority(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , TaskPriority priority);
+
+  // Avoids allocation of `base::OnceClosure`
+  // if callable fits into `InlineTask`.
+  bool PostTaskWithPriority(
+    const ::base::Location& from_here
+    , InlineTask task
+    , TaskPriority priority);
+
+  bool PostDelayedTaskWithPriority(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , TaskPriority priority
+    , ::base::TimeDelta delay);
+
+  // base::SequencedTaskRunner
+  bool PostDelayedTask(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , ::base::TimeDelta delay) override;
+
+  bool PostNonNestableDelayedTask(
+    const ::base::Location& from_here
+    , ::base::OnceClosure task
+    , ::base::TimeDelta delay) override;
+
+  bool RunsTasksInCurrentSequence() const override;
+
+  // Number of tasks in heap (delayed tasks are not counted
+  // until their delay expires).
+  MUST_USE_RETURN_VALUE
+  size_t pending_task_count() const;
+
+  TaskPriority default_priority() const
+  {
+    return default_priority_;
+  }
+
+  // Returns task runner that runs tasks.
+  const scoped_refptr<::base::SequencedTaskRunner>& task_runner() const
+  {
+    return task_runner_;
+  }
+
+ private:
+  ~PrioritizedSequencedTaskRunner() override;
+
+  // Adds task to heap and wakes up `task_runner_` if needed.
+  // Returns `false` if task will never run.
+  /// \note can be called on any thread.
+  bool scheduleTask(
+    const ::base::Location& from_here
+    , InlineTask task
+    , TaskPriority priority);
+
+  // Returns `false` if pump can not be posted
+  // (for example, `task_runner_` is shutting down).
+  // Tasks in heap are destroyed in that case.
+  bool schedulePumpIfNeeded();
+
+  // Runs tasks from heap on sequence of `task_runner_`.
+  void runPump();
+
+ private:
+  scoped_refptr<::base::SequencedTaskRunner> task_runner_;
+
+  const TaskPriority default_priority_;
+
+  const ::base::TimeDelta time_budget_;
+
+  // Uses locks, because tasks are posted from any thread.
+  scoped_refptr<PrioritizedOnceTaskHeap> task_heap_;
+
+  // `true` if `runPump` is posted to `task_runner_`, but not started yet.
+  std::atomic<bool> pump_scheduled_{false};
+
+  // Set when `task_runner_` rejects pump, never reset.
+  std::atomic<bool> shut_down_{false};
+
+  DISALLOW_COPY_AND_ASSIGN(PrioritizedSequencedTaskRunner);
+};
+
+} // namespace basis
@@ -0,0 +1,151 @@
+#include "basis/task/prioritized_sequenced_task_runner.h"
+
+#include "base/bind.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+#include <utility>
+#include <vector>
+
+namespace basis {
+namespace {
+
+// Rejects all posts while `reject` is set.
+class RejectingTaskRunner : public base::SequencedTaskRunner {
+ public:
+  explicit RejectingTaskRunner(
+      scoped_refptr<base::SequencedTaskRunner> task_runner)
+      : task_runner_(std::move(task_runner)) {}
+
+  void set_reject(bool reject) { reject_ = reject; }
+
+  bool PostDelayedTask(const base::Location& from_here,
+                       base::OnceClosure task,
+                       base::TimeDelta delay) override {
+    return !reject_ &&
+           task_runner_->PostDelayedTask(from_here, std::move(task), delay);
+  }
+
+  bool PostNonNestableDelayedTask(const base::Location& from_here,
+                                  base::OnceClosure task,
+                                  base::TimeDelta delay) override {
+    return !reject_ && task_runner_->PostNonNestableDelayedTask(
+                           from_here, std::move(task), delay);
+  }
+
+  bool RunsTasksInCurrentSequence() const override {
+    return task_runner_->RunsTasksInCurrentSequence();
+  }
+
+ private:
+  ~RejectingTaskRunner() override = default;
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  bool reject_ = false;
+};
+
+class PrioritizedSequencedTaskRunnerTest : public testing::Test {
+ protected:
+  scoped_refptr<PrioritizedSequencedTaskRunner> CreateTaskRunner(
+      base::TimeDelta time_budget) {
+    return base::MakeRefCounted<PrioritizedSequencedTaskRunner>(
+        base::SequencedTaskRunnerHandle::Get(), /* default_priority */ 10u,
+        time_budget);
+  }
+
+  base::OnceClosure Record(int value) {
+    return base::BindOnce(
+        [](std::vector<int>* order, int value) { order->push_back(value); },
+        base::Unretained(&order_), value);
+  }
+
+  // Time does not advance during test, so time budget is not exceeded
+  // unless it is zero.
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+
+  std::vector<int> order_;
+};
+
+TEST_F(PrioritizedSequencedTaskRunnerTest, RunsTasksInPriorityOrder) {
+  scoped_refptr<PrioritizedSequencedTaskRunner> task_runner =
+      CreateTaskRunner(base::TimeDelta::FromSeconds(1));
+
+  task_runner->PostTaskWithPriority(FROM_HERE, Record(1), 20u);
+  // uses default priority
+  task_runner->PostTask(FROM_HERE, Record(2));
+  task_runner->PostTaskWithPriority(
+      FROM_HERE, Record(3), PrioritizedOnceTaskHeap::kHighestPriority);
+  task_runner->PostTaskWithPriority(FROM_HERE, Record(4), 20u);
+  EXPECT_EQ(4u, task_runner->pending_task_count());
+
+  base::RunLoop().RunUntilIdle();
+
+  // same priority runs in order of posting
+  EXPECT_EQ((std::vector<int>{3, 2, 1, 4}), order_);
+  EXPECT_EQ(0u, task_runner->pending_task_count());
+}
+
+TEST_F(PrioritizedSequencedTaskRunnerTest, YieldsWhenBudgetExceeded) {
+  scoped_refptr<PrioritizedSequencedTaskRunner> task_runner =
+      CreateTaskRunner(base::TimeDelta());
+
+  task_runner->PostTask(FROM_HERE, Record(1));
+  task_runner->PostTask(FROM_HERE, Record(2));
+  // posted directly to underlying sequence
+  task_runner->task_runner()->PostTask(FROM_HERE, Record(0));
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ((std::vector<int>{1, 0, 2}), order_);
+}
+
+TEST_F(PrioritizedSequencedTaskRunnerTest, DelayedTask) {
+  scoped_refptr<PrioritizedSequencedTaskRunner> task_runner =
+      CreateTaskRunner(base::TimeDelta::FromSeconds(1));
+
+  EXPECT_TRUE(task_runner->RunsTasksInCurrentSequence());
+
+  task_runner->PostDelayedTaskWithPriority(
+      FROM_HERE, Record(1), PrioritizedOnceTaskHeap::kHighestPriority,
+      base::TimeDelta::FromSeconds(5));
+  task_runner->PostTask(FROM_HERE, Record(2));
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ((std::vector<int>{2}), order_);
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(5));
+  EXPECT_EQ((std::vector<int>{2, 1}), order_);
+}
+
+TEST_F(PrioritizedSequencedTaskRunnerTest, DropsTasksWhenPumpIsRejected) {
+  scoped_refptr<RejectingTaskRunner> rejecting_runner =
+      base::MakeRefCounted<RejectingTaskRunner>(
+          base::SequencedTaskRunnerHandle::Get());
+  scoped_refptr<PrioritizedSequencedTaskRunner> task_runner =
+      base::MakeRefCounted<PrioritizedSequencedTaskRunner>(
+          rejecting_runner, /* default_priority */ 10u,
+          base::TimeDelta::FromSeconds(1));
+
+  rejecting_runner->set_reject(true);
+  // `false` means that task will never run
+  EXPECT_FALSE(task_runner->PostTask(FROM_HERE, Record(1)));
+  EXPECT_EQ(0u, task_runner->pending_task_count());
+
+  // runner is shut down, next posts are rejected too
+  rejecting_runner->set_reject(false);
+  EXPECT_FALSE(task_runner->PostTask(FROM_HERE, Record(2)));
+  EXPECT_EQ(0u, task_runner->pending_task_count());
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_TRUE(order_.empty());
+}
+
+}  // namespace
+}  // namespace basis
@@ -0,0 +1,123 @@
+#include "basis/task/strand_occupancy.h" // IWYU pragma: associated
+
+#include "basis/task/atomic_max.h"
+
+#include <base/metrics/histogram.h>
+#include <base/trace_event/trace_event.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace basis {
+
+namespace {
+
+int64_t nowInMicroseconds()
+{
+  return (::base::TimeTicks::Now() - ::base::TimeTicks()).InMicroseconds();
+}
+
+} // namespace
+
+StrandOccupancy::StrandOccupancy(const std::string& name)
+  : name_(name)
+  , start_time_us_(nowInMicroseconds())
+  , run_time_histogram_(
+      ::base::Histogram::FactoryMicrosecondsTimeGet(
+        "Basis.Strand." + name + ".RunTime"
+        , ::base::TimeDelta::FromMicroseconds(1)
+        , ::base::TimeDelta::FromSeconds(1)
+        , 50
+        , ::base::HistogramBase::kUmaTargetedHistogramFlag))
+  , queue_depth_histogram_(
+      ::base::Histogram::FactoryGet(
+        "Basis.Strand." + name + ".QueueDepth"
+        , 1
+        , 10000
+        , 50
+        , ::base::HistogramBase::kUmaTargetedHistogramFlag))
+{
+  DCHECK(!name_.empty());
+}
+
+StrandOccupancy::~StrandOccupancy()
+{
+  DCHECK_EQ(queue_depth_.load(), 0)
+    << "strand occupancy destroyed with pending handlers: "
+    << name_;
+}
+
+void StrandOccupancy::OnHandlerQueued()
+{
+  const int64_t depth
+    = queue_depth_.fetch_add(1, std::memory_order_relaxed) + 1;
+  updateAtomicMax(max_queue_depth_, depth);
+  RecordQueueDepth(depth);
+}
+
+void StrandOccupancy::OnHandlerFinished(::base::TimeDelta run_time)
+{
+  const int64_t depth
+    = queue_depth_.fetch_sub(1, std::memory_order_relaxed) - 1;
+  DCHECK_GE(depth, 0);
+
+  const int64_t run_time_us = run_time.InMicroseconds();
+  handlers_run_.fetch_add(1, std::memory_order_relaxed);
+  total_run_time_us_.fetch_add(run_time_us, std::memory_order_relaxed);
+  updateAtomicMax(max_run_time_us_, run_time_us);
+
+  run_time_histogram_->AddTimeMicrosecondsGranularity(run_time);
+  TRACE_COUNTER_ID1("basis.strand", "StrandQueueDepth", this, depth);
+}
+
+void StrandOccupancy::OnHandlerDropped()
+{
+  const int64_t depth
+    = queue_depth_.fetch_sub(1, std::memory_order_relaxed) - 1;
+  DCHECK_GE(depth, 0);
+  TRACE_COUNTER_ID1("basis.strand", "StrandQueueDepth", this, depth);
+}
+
+void StrandOccupancy::RecordQueueDepth(int64_t depth)
+{
+  queue_depth_histogram_->Add(static_cast<int>(
+    std::min<int64_t>(depth, std::numeric_limits<int>::max())));
+  TRACE_COUNTER_ID1("basis.strand", "StrandQueueDepth", this, depth);
+}
+
+StrandOccupancy::Snapshot StrandOccupancy::GetSnapshot() const
+{
+  Snapshot snapshot;
+  snapshot.queue_depth
+    = queue_depth_.load(std::memory_order_relaxed);
+  snapshot.max_queue_depth
+    = max_queue_depth_.load(std::memory_order_relaxed);
+  snapshot.handlers_run
+    = handlers_run_.load(std::memory_order_relaxed);
+  snapshot.total_run_time = ::base::TimeDelta::FromMicroseconds(
+    total_run_time_us_.load(std::memory_order_relaxed));
+  snapshot.max_run_time = ::base::TimeDelta::FromMicroseconds(
+    max_run_time_us_.load(std::memory_order_relaxed));
+
+  const int64_t wall_time_us
+    = nowInMicroseconds() - start_time_us_.load(std::memory_order_relaxed);
+  snapshot.busy_fraction
+    = wall_time_us > 0
+      ? static_cast<double>(snapshot.total_run_time.InMicroseconds())
+          / wall_time_us
+      : 0.0;
+
+  return snapshot;
+}
+
+void StrandOccupancy::Reset()
+{
+  max_queue_depth_.store(
+    queue_depth_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  handlers_run_.store(0, std::memory_order_relaxed);
+  total_run_time_us_.store(0, std::memory_order_relaxed);
+  max_run_time_us_.store(0, std::memory_order_relaxed);
+  start_time_us_.store(nowInMicroseconds(), std::memory_order_relaxed);
+}
+
+} // namespace basis
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <base/macros.h>
+#include <base/logging.h>
+#include <base/location.h>
+#include <base/memory/ref_counted.h>
+#include <base/memory/scoped_refptr.h>
+#include <base/time/time.h>
+
+#include <basic/macros.h>
+#include <basic/rvalue_cast.h>
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace base {
+class HistogramBase;
+} // namespace base
+
+namespace basis {
+
+// Lightweight "strand occupancy" profiler.
+//
+// Records per-strand queue depth (handlers posted, but not finished yet)
+// and handler run time.
+// Use it to find hot strands that serialize too much work.
+//
+// Data is exported:
+// * via `GetSnapshot()`
+// * as trace counters (category `basis.strand`)
+// * as histograms `Basis.Strand.<name>.RunTime`
+//   and `Basis.Strand.<name>.QueueDepth`
+//   (see `base::StatisticsRecorder`).
+//
+/// \note All counters are relaxed atomics,
+/// so profiler can be used in release builds.
+//
+// USAGE
+//
+//  scoped_refptr<::basis::StrandOccupancy> occupancy_
+//    = ::base::MakeRefCounted<::basis::StrandOccupancy>("Acceptor");
+//
+//  ::basis::postOnStrand(perConnectionStrand_->data
+//    , occupancy_
+//    , [](){ ... });
+class StrandOccupancy
+  : public ::base::RefCountedThreadSafe<StrandOccupancy>
+{
+ public:
+  struct Snapshot
+  {
+    // Number of handlers posted, but not finished yet.
+    int64_t queue_depth = 0;
+    int64_t max_queue_depth = 0;
+    uint64_t handlers_run = 0;
+    ::base::TimeDelta total_run_time;
+    ::base::TimeDelta max_run_time;
+    // Fraction of wall time (since creation or `Reset`)
+    // when strand was running handlers (1.0 means always busy).
+    double busy_fraction = 0.0;
+  };
+
+  // Wraps handler to record queue depth and run time.
+  // Queue depth decremented even if handler was destroyed without run
+  // (for example, if `io_context` was stopped).
+  template <typename Handler>
+  class WrappedHandler
+  {
+   public:
+    WrappedHandler(
+      scoped_refptr<StrandOccupancy> occupancy
+      , Handler&& handler)
+      : occupancy_(RVALUE_CAST(occupancy))
+      , handler_(RVALUE_CAST(handler))
+    {
+      DCHECK(occupancy_);
+      occupancy_->OnHandlerQueued();
+    }
+
+    WrappedHandler(WrappedHandler&& other)
+      : occupancy_(RVALUE_CAST(other.occupancy_))
+      , handler_(RVALUE_CAST(other.handler_))
+    {}
+
+    WrappedHandler& operator=(WrappedHandler&& other) = delete;
+
+    ~WrappedHandler()
+    {
+      // handler was not called
+      if(occupancy_)
+      {
+        occupancy_->OnHandlerDropped();
+      }
+    }
+
+    template <typename... Args>
+    void operator()(Args&&... args)
+    {
+      DCHECK(occupancy_);
+      const ::base::TimeTicks start = ::base::TimeTicks::Now();
+      handler_(FORWARD(args)...);
+      occupancy_->OnHandlerFinished(::base::TimeTicks::Now() - start);
+      occupancy_.reset();
+    }
+
+   private:
+    scoped_refptr<StrandOccupancy> occupancy_;
+
+    Handler handler_;
+
+    DISALLOW_COPY_AND_ASSIGN(WrappedHandler);
+  };
+
+  explicit StrandOccupancy(const std::string& name);
+
+  template <typename Handler>
+  MUST_USE_RETURN_VALUE
+  WrappedHandler<std::decay_t<Handler>> wrap(Handler&& handler)
+  {
+    return WrappedHandler<std::decay_t<Handler>>(
+      this, std::decay_t<Handler>(FORWARD(handler)));
+  }
+
+  MUST_USE_RETURN_VALUE
+  Snapshot GetSnapshot() const;
+
+  // Resets accumulated statistics (but not current queue depth).
+  void Reset();
+
+  const std::string& name() const
+  {
+    return name_;
+  }
+
+ private:
+  friend class ::base::RefCountedThreadSafe<StrandOccupancy>;
+
+  ~StrandOccupancy();
+
+  void OnHandlerQueued();
+
+  void OnHandlerFinished(::base::TimeDelta run_time);
+
+  void OnHandlerDropped();
+
+  void RecordQueueDepth(int64_t depth);
+
+ private:
+  const std::string name_;
+
+  std::atomic<int64_t> queue_depth_{0};
+
+  std::atomic<int64_t> max_queue_depth_{0};
+
+  std::atomic<uint64_t> handlers_run_{0};
+
+  std::atomic<int64_t> total_run_time_us_{0};
+
+  std::atomic<int64_t> max_run_time_us_{0};
+
+  std::atomic<int64_t> start_time_us_;
+
+  // Histograms are owned by `base::StatisticsRecorder`.
+  ::base::HistogramBase* run_time_histogram_;
+
+  ::base::HistogramBase* queue_depth_histogram_;
+
+  DISALLOW_COPY_AND_ASSIGN(StrandOccupancy);
+};
+
+// Posts `handler` on `strand` and records it in `occupancy`.
+template <typename Executor, typename Handler>
+void postOnStrand(
+  ::boost::asio::strand<Executor>& strand
+  , const scoped_refptr<StrandOccupancy>& occupancy
+  , Handler&& handler)
+{
+  DCHECK(occupancy);
+  ::boost::asio::post(strand, occupancy->wrap(FORWARD(handler)));
+}
+
+} // namespace basis
@@ -0,0 +1,65 @@
+#include "basis/task/strand_occupancy.h"
+
+#include "basis/annotations/asio_guard_annotations.h"
+
+#include "base/memory/scoped_refptr.h"
+#include "base/notreached.h"
+#include "base/time/time.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace basis {
+namespace {
+
+TEST(StrandOccupancyTest, RecordsQueueDepthAndRunTime) {
+  using ExecutorType = ::boost::asio::io_context::executor_type;
+
+  ::boost::asio::io_context ioc;
+  AnnotatedStrand<ExecutorType> strand(ioc.get_executor());
+
+  scoped_refptr<StrandOccupancy> occupancy
+    = ::base::MakeRefCounted<StrandOccupancy>("StrandOccupancyTest");
+
+  int handlers_called = 0;
+  for (int i = 0; i < 3; ++i) {
+    postOnStrand(strand.data, occupancy, [&strand, &handlers_called]() {
+      DCHECK_RUN_ON_STRAND(&strand, ExecutorType);
+      ++handlers_called;
+    });
+  }
+
+  StrandOccupancy::Snapshot queued = occupancy->GetSnapshot();
+  EXPECT_EQ(3, queued.queue_depth);
+  EXPECT_EQ(3, queued.max_queue_depth);
+  EXPECT_EQ(0u, queued.handlers_run);
+
+  ioc.run();
+
+  StrandOccupancy::Snapshot done = occupancy->GetSnapshot();
+  EXPECT_EQ(3, handlers_called);
+  EXPECT_EQ(0, done.queue_depth);
+  EXPECT_EQ(3, done.max_queue_depth);
+  EXPECT_EQ(3u, done.handlers_run);
+  EXPECT_GE(done.max_run_time, ::base::TimeDelta());
+}
+
+TEST(StrandOccupancyTest, DroppedHandler) {
+  scoped_refptr<StrandOccupancy> occupancy
+    = ::base::MakeRefCounted<StrandOccupancy>("StrandOccupancyTestDropped");
+
+  {
+    ::boost::asio::io_context ioc;
+    auto strand = ::boost::asio::make_strand(ioc);
+
+    postOnStrand(strand, occupancy, []() { NOTREACHED(); });
+    EXPECT_EQ(1, occupancy->GetSnapshot().queue_depth);
+
+    // `io_context` destroys pending handlers without running them
+  }
+
+  EXPECT_EQ(0, occupancy->GetSnapshot().queue_depth);
+  EXPECT_EQ(0u, occupancy->GetSnapshot().handlers_run);
+}
+
+}  // namespace
+}  // namespace basis
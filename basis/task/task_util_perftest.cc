@@ -0,0 +1,62 @@
+#include "basis/task/task_util.h"
+
+#include "base/bind.h"
+#include "base/callback.h"
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+
+namespace basis {
+
+namespace {
+
+void addToCounter(int* counter, int value) {
+  *counter += value;
+}
+
+// Baseline: create and run `base::OnceCallback` directly.
+void BM_OnceCallbackRun(benchmark::State& state) {
+  int counter = 0;
+
+  for (auto _ : state) {
+    base::OnceCallback<void(int)> task
+      = base::BindOnce(&addToCounter, base::Unretained(&counter));
+    std::move(task).Run(1);
+  }
+
+  benchmark::DoNotOptimize(counter);
+}
+BENCHMARK(BM_OnceCallbackRun);
+
+// Wraps `base::OnceCallback` into handler usable by `boost::asio`
+// (same as `async_write` handlers).
+void BM_BindFrontOnceCallback(benchmark::State& state) {
+  int counter = 0;
+
+  for (auto _ : state) {
+    auto handler = ::basis::bindFrontOnceCallback(
+      base::BindOnce(&addToCounter, base::Unretained(&counter)));
+    handler(1);
+  }
+
+  benchmark::DoNotOptimize(counter);
+}
+BENCHMARK(BM_BindFrontOnceCallback);
+
+void BM_BindFrontOnceClosure(benchmark::State& state) {
+  int counter = 0;
+
+  for (auto _ : state) {
+    auto handler = ::basis::bindFrontOnceClosure(
+      base::BindOnce(&addToCounter, base::Unretained(&counter), 1));
+    handler();
+  }
+
+  benchmark::DoNotOptimize(counter);
+}
+BENCHMARK(BM_BindFrontOnceClosure);
+
+}  // namespace
+
+}  // namespace basis
@@ -4,8 +4,33 @@
 
 #include "base/test/perf_test_suite.h"
 
+#include <benchmark/benchmark.h>
+
 #include <locale>
 
+namespace {
+
+// Runs registered Google Benchmark cases
+// inside of environment created by `base::PerfTestSuite`
+// (AtExitManager, logging, feature list, etc.).
+//
+/// \note Pass `--benchmark_out=<file> --benchmark_out_format=json`
+/// to store results in machine-readable format.
+class BenchmarkPerfTestSuite : public base::PerfTestSuite {
+ public:
+  BenchmarkPerfTestSuite(int argc, char** argv)
+    : base::PerfTestSuite(argc, argv) {}
+
+  int RunBenchmarks() {
+    Initialize();
+    benchmark::RunSpecifiedBenchmarks();
+    Shutdown();
+    return 0;
+  }
+};
+
+}  // namespace
+
 int main(int argc, char** argv) {
   CHECK(setlocale(LC_ALL, "en_US.UTF-8") != nullptr)
       << "Failed to set locale: " << "en_US.UTF-8";
@@ -15,5 +40,9 @@ int main(int argc, char** argv) {
   CHECK(setlocale(LC_NUMERIC, "C") != nullptr)
       << "Failed to set locale: " << "LC_NUMERIC C";
 
-  return base::PerfTestSuite(argc, argv).Run();
+  // Removes `--benchmark_*` flags from `argv`,
+  // so `base::CommandLine` will not see them.
+  benchmark::Initialize(&argc, argv);
+
+  return BenchmarkPerfTestSuite(argc, argv).RunBenchmarks();
 }
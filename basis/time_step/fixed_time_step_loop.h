@@ -4,6 +4,8 @@
 
 #include <chrono>
 #include <functional>
+#include <type_traits>
+#include <utility>
 
 #include <base/logging.h>
 #include <base/macros.h>
@@ -126,6 +128,54 @@ auto spareCycleAfterUpdateCallback(Args... args)
     FORWARD(args)...);
 }
 
+namespace fixed_time_step_internal {
+
+template <class T, typename = void>
+struct has_tick_boundary_callback : std::false_type {};
+
+template <class T>
+struct has_tick_boundary_callback<
+  T
+  , std::void_t<decltype(T::tickBoundaryCallback(std::declval<void*>()))>
+> : std::true_type {};
+
+} // namespace fixed_time_step_internal
+
+// calls method `T::tickBoundaryCallback()` (if `T` provides it)
+// after each single `update tick`
+/// \note `T::tickBoundaryCallback()` is optional
+/// \note Clear per-tick state here (see `ECS::ChangeTracker`)
+/// \note This is end of `simulationUpdate` part of main loop:
+/// while(true)
+/// {
+///   earlyUpdate();
+///
+///   while (lag >= MS_PER_UPDATE) // single `update tick`
+///   {
+///     simulationUpdate();
+///     tickBoundary(); // <-- here
+///   }
+///
+///   lateUpdate();
+/// } // while(true)
+template <class T>
+inline /* `inline` to eleminate function call overhead */
+void tickBoundaryCallback(void* data_raw)
+{
+  if constexpr (fixed_time_step_internal::has_tick_boundary_callback<T>::value)
+  {
+    ///\note checks return type
+    static_assert(
+      std::is_same<
+        decltype(T::tickBoundaryCallback(data_raw))
+        , void>::value,
+      "'T::tickBoundaryCallback() const' "
+      "must return void.");
+
+    T::tickBoundaryCallback(data_raw);
+  }
+}
+
 /// \brief Fixed Time Step based on code from
 /// https://gameprogrammingpatterns.com/game-loop.html
 /// \note single `frame` may contain zero or more `update ticks`
@@ -305,6 +355,9 @@ public:
       }
 
       time_step_.update_lag();
+
+      /// \note may be inlined (or removed if `T` does not provide it)
+      tickBoundaryCallback<UpdateCallbacksType>(data_raw_);
     }
 
     /// \note can be used to compute (lag / MS_PER_UPDATE), so
@@ -0,0 +1,86 @@
+#include "basis/time_step/fixed_time_step_loop.h"
+
+#include <chrono>
+
+#include <benchmark/benchmark.h>
+
+namespace basis {
+
+namespace {
+
+// Callbacks do nothing, so benchmark measures overhead of loop itself
+// (clock reads, lag accounting, callback dispatch).
+struct EmptyUpdateCallbacks
+{
+  static void spareCycleBeforeUpdateCallback(
+    void* data
+    , const std::chrono::nanoseconds&
+    , const std::chrono::nanoseconds&)
+  {
+    benchmark::DoNotOptimize(data);
+  }
+
+  static void updateCallback(
+    void* data
+    , const std::chrono::nanoseconds&
+    , const std::chrono::nanoseconds&)
+  {
+    ++(*static_cast<size_t*>(data));
+  }
+
+  static void spareCycleAfterUpdateCallback(
+    void* data
+    , const std::chrono::nanoseconds&
+    , const std::chrono::nanoseconds&
+    , const std::chrono::nanoseconds&
+    , const std::chrono::steady_clock::time_point&)
+  {
+    benchmark::DoNotOptimize(data);
+  }
+};
+
+// Measures single `run_once()` (frame) with tickrate
+// that is much larger than frame time,
+// so usually frame contains zero `update ticks`.
+void BM_FixedTimeStepLoopFrame(benchmark::State& state) {
+  size_t updates = 0;
+
+  FixedTimeStepLoop<EmptyUpdateCallbacks> loop(
+    k60fps
+    , &updates);
+
+  loop.time_step_ref().update_clock(FixedTimeStep::clock::now());
+
+  for (auto _ : state) {
+    loop.run_once();
+  }
+
+  benchmark::DoNotOptimize(updates);
+}
+BENCHMARK(BM_FixedTimeStepLoopFrame);
+
+// Measures `run_once()` with tiny tickrate,
+// so each frame contains many `update ticks`
+// (see `items_per_second` for cost of single tick).
+void BM_FixedTimeStepLoopTick(benchmark::State& state) {
+  size_t updates = 0;
+
+  FixedTimeStepLoop<EmptyUpdateCallbacks> loop(
+    std::chrono::nanoseconds{1}
+    , &updates);
+
+  loop.time_step_ref().update_clock(FixedTimeStep::clock::now());
+
+  for (auto _ : state) {
+    loop.run_once();
+  }
+
+  state.SetItemsProcessed(updates);
+  state.counters["updates_per_frame"]
+    = static_cast<double>(updates) / state.iterations();
+}
+BENCHMARK(BM_FixedTimeStepLoopTick);
+
+}  // namespace
+
+}  // namespace basis
@@ -54,4 +54,9 @@ option(ENABLE_MSAN
 option(ENABLE_TSAN
   "Enable Thread Sanitizer" OFF)
 
+# NOTE: cross-checks O(1) relationship queries (like `hasChildAtTopLevel`)
+# against walk over linked list i.e. O(children) per query.
+option(ENABLE_ECS_VALIDATE_RELATIONSHIP_LISTS
+  "Enable validation of ECS relationship linked lists" OFF)
+
 set(BASIS_SOURCES_PATH ${CMAKE_CURRENT_SOURCE_DIR}/basis/)
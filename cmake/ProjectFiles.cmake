@@ -22,6 +22,8 @@ list(APPEND BASIS_SOURCES
   ${BASIS_DIR}/i18n/icu_util.cc
   #
   ${BASIS_DIR}/memory/any_ptr.h
+  ${BASIS_DIR}/memory/scoped_memory_dump_provider.h
+  ${BASIS_DIR}/memory/scoped_memory_dump_provider.cc
   #
   ${BASIS_DIR}/threading/thread_pool_util.h
   ${BASIS_DIR}/threading/thread_pool_util.cc
@@ -34,6 +36,8 @@ list(APPEND BASIS_SOURCES
   ${BASIS_DIR}/promise/post_promise.h
   ${BASIS_DIR}/promise/post_promise.cc
   #
+  ${BASIS_DIR}/task/inline_task.h
+  ${BASIS_DIR}/task/channel.h
   ${BASIS_DIR}/task/prioritized_once_task_heap.h
   ${BASIS_DIR}/task/prioritized_once_task_heap.cc
   ${BASIS_DIR}/task/periodic_task_executor.h
@@ -47,6 +51,19 @@ list(APPEND BASIS_SOURCES
   ${BASIS_DIR}/task/alarm_manager.h
   ${BASIS_DIR}/task/alarm_manager.cc
   #
+  ${BASIS_DIR}/task/strand_occupancy.h
+  ${BASIS_DIR}/task/strand_occupancy.cc
+  ${BASIS_DIR}/task/atomic_max.h
+  #
+  ${BASIS_DIR}/task/instrumented_sequenced_task_runner.h
+  ${BASIS_DIR}/task/instrumented_sequenced_task_runner.cc
+  ${BASIS_DIR}/task/prioritized_sequenced_task_runner.h
+  ${BASIS_DIR}/task/prioritized_sequenced_task_runner.cc
+  ${BASIS_DIR}/task/bounded_sequenced_task_runner.h
+  ${BASIS_DIR}/task/bounded_sequenced_task_runner.cc
+  ${BASIS_DIR}/task/cancellation_token.h
+  ${BASIS_DIR}/task/cancellation_token.cc
+  #
   ${BASIS_DIR}/application/application.h
   ${BASIS_DIR}/application/application.cc
   ${BASIS_DIR}/application/application_configuration.h
@@ -66,6 +83,8 @@ list(APPEND BASIS_SOURCES
   ${BASIS_DIR}/time_step/fixed_time_step_loop.cc
   #
   ${BASIS_DIR}/checked_optional.h
+  ${BASIS_DIR}/checked_optional.cc
+  ${BASIS_DIR}/static_checked_optional.h
   #
   ${BASIS_DIR}/ECS/components/relationship/parent_entity.h
   #
@@ -75,6 +94,8 @@ list(APPEND BASIS_SOURCES
   #
   ${BASIS_DIR}/ECS/components/relationship/child_siblings.h
   #
+  ${BASIS_DIR}/ECS/components/relationship/hierarchy_node.h
+  #
   ${BASIS_DIR}/ECS/helpers/relationship/remove_child_from_top_level.h
   #
   ${BASIS_DIR}/ECS/helpers/relationship/foreach_top_level_child.h
@@ -83,9 +104,29 @@ list(APPEND BASIS_SOURCES
   #
   ${BASIS_DIR}/ECS/helpers/relationship/prepend_child_entity.h
   #
+  ${BASIS_DIR}/ECS/helpers/relationship/validate_relationships.h
+  #
+  ${BASIS_DIR}/ECS/helpers/relationship/has_child_at_top_level.h
+  ${BASIS_DIR}/ECS/helpers/relationship/are_children_of.h
+  #
+  ${BASIS_DIR}/ECS/helpers/relationship/is_child_node_of.h
+  ${BASIS_DIR}/ECS/helpers/relationship/prepend_child_node.h
+  ${BASIS_DIR}/ECS/helpers/relationship/remove_child_node.h
+  ${BASIS_DIR}/ECS/helpers/relationship/foreach_child_node.h
+  #
+  ${BASIS_DIR}/ECS/helpers/algorithm/component_index.h
+  #
   ${BASIS_DIR}/ECS/helpers/lifetime/populate_delayed_construction_components.h
   ${BASIS_DIR}/ECS/helpers/lifetime/populate_delayed_construction_components.cc
   #
+  ${BASIS_DIR}/ECS/helpers/lifetime/lifecycle_state.h
+  ${BASIS_DIR}/ECS/helpers/lifetime/lifecycle_state.cc
+  #
+  ${BASIS_DIR}/ECS/helpers/lifetime/delayed_construction_pipeline.h
+  #
+  ${BASIS_DIR}/ECS/helpers/lifetime/destruction_queue.h
+  ${BASIS_DIR}/ECS/helpers/lifetime/destruction_queue.cc
+  #
   ${BASIS_DIR}/ECS/unsafe_context.cc
   ${BASIS_DIR}/ECS/unsafe_context.h
   #
@@ -95,6 +136,23 @@ list(APPEND BASIS_SOURCES
   ${BASIS_DIR}/ECS/safe_registry.cc
   ${BASIS_DIR}/ECS/safe_registry.h
   #
+  ${BASIS_DIR}/ECS/group_presets.h
+  ${BASIS_DIR}/ECS/change_tracker.h
+  ${BASIS_DIR}/ECS/registry_compactor.h
+  ${BASIS_DIR}/ECS/registry_compactor.cc
+  ${BASIS_DIR}/ECS/registry_memory_dump.h
+  ${BASIS_DIR}/ECS/entity_migration.h
+  ${BASIS_DIR}/ECS/entity_migration.cc
+  #
+  ${BASIS_DIR}/ECS/snapshot/registry_snapshot.h
+  ${BASIS_DIR}/ECS/snapshot/registry_snapshot.cc
+  #
+  ${BASIS_DIR}/ECS/snapshot/registry_delta.h
+  ${BASIS_DIR}/ECS/snapshot/registry_delta.cc
+  #
+  ${BASIS_DIR}/ECS/snapshot/registry_delta_log.h
+  ${BASIS_DIR}/ECS/snapshot/registry_delta_log.cc
+  #
   ${BASIS_DIR}/ECS/ecs.h
   ${BASIS_DIR}/ECS/ecs.cc
   #
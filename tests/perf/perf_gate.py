@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+"""Perf regression gate for basis benchmarks.
+
+Runs each Google Benchmark executable N times, computes median and MAD
+(median absolute deviation) of every benchmark and compares medians
+against checked-in baseline JSON.
+
+Benchmark regresses if its median is slower than baseline median
+by more than its tolerance AND the difference exceeds noise
+(`--mad-factor` * MAD of current run).
+
+Benchmark without baseline (NEW) and baseline without result (MISSING)
+also fail the gate, so the gate can not pass silently
+with empty or stale baseline. Re-generate baseline
+using `--update-baseline` after benchmarks are added or renamed.
+
+Usage:
+  perf_gate.py --baseline baselines.json [--repetitions 5] BINARY...
+  perf_gate.py --baseline baselines.json --update-baseline BINARY...
+  perf_gate.py --baseline baselines.json --input results1.json ...
+
+Exit code is 1 if any benchmark regressed, is NEW or MISSING, 0 otherwise.
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+
+# Google Benchmark `time_unit` to nanoseconds.
+_TIME_UNIT_TO_NS = {
+    'ns': 1.0,
+    'us': 1e3,
+    'ms': 1e6,
+    's': 1e9,
+}
+
+_DEFAULT_TOLERANCE = 0.10
+
+
+def _load_json(path):
+  with open(path, 'r') as f:
+    return json.load(f)
+
+
+def _collect_samples(report, samples, metric):
+  """Adds per-benchmark times (in ns) from Google Benchmark JSON report."""
+  for entry in report.get('benchmarks', []):
+    # Skip aggregates (mean/median/stddev) produced by repetitions.
+    if entry.get('run_type') == 'aggregate':
+      continue
+    if 'error_occurred' in entry and entry['error_occurred']:
+      continue
+    unit = _TIME_UNIT_TO_NS[entry.get('time_unit', 'ns')]
+    value = float(entry[metric]) * unit
+    samples.setdefault(entry['name'], []).append(value)
+
+
+def _run_binary(binary, repetitions, benchmark_filter, samples, metric):
+  for run in range(repetitions):
+    fd, out_path = tempfile.mkstemp(suffix='.json')
+    os.close(fd)
+    try:
+      command = [
+          binary,
+          '--benchmark_out=' + out_path,
+          '--benchmark_out_format=json',
+      ]
+      if benchmark_filter:
+        command.append('--benchmark_filter=' + benchmark_filter)
+      print('[perf_gate] run %d/%d: %s' %
+            (run + 1, repetitions, os.path.basename(binary)),
+            flush=True)
+      subprocess.run(command, check=True, stdout=subprocess.DEVNULL)
+      _collect_samples(_load_json(out_path), samples, metric)
+    finally:
+      os.remove(out_path)
+
+
+def _median_and_mad(values):
+  median = statistics.median(values)
+  mad = statistics.median([abs(v - median) for v in values])
+  return median, mad
+
+
+def _format_ns(value):
+  for unit, scale in (('s', 1e9), ('ms', 1e6), ('us', 1e3)):
+    if value >= scale:
+      return '%.3f %s' % (value / scale, unit)
+  return '%.3f ns' % value
+
+
+def _compare(stats, baseline, mad_factor, count_missing):
+  """Returns list of rows (name, status, base, current, delta)
+  and number of failures (REGRESSED, NEW or MISSING)."""
+  default_tolerance = baseline.get('default_tolerance', _DEFAULT_TOLERANCE)
+  expected = baseline.get('benchmarks', {})
+  rows = []
+  regressions = 0
+
+  for name in sorted(stats):
+    median, mad = stats[name]
+    entry = expected.get(name)
+    if entry is None or 'median_ns' not in entry:
+      rows.append((name, 'NEW', None, median, None))
+      regressions += 1
+      continue
+
+    base = float(entry['median_ns'])
+    tolerance = float(entry.get('tolerance', default_tolerance))
+    delta = (median - base) / base if base > 0 else 0.0
+
+    if delta > tolerance and (median - base) > mad_factor * mad:
+      status = 'REGRESSED'
+      regressions += 1
+    elif delta < -tolerance and (base - median) > mad_factor * mad:
+      status = 'IMPROVED'
+    else:
+      status = 'OK'
+    rows.append((name, status, base, median, (delta, tolerance)))
+
+  for name in sorted(set(expected) - set(stats)):
+    rows.append((name, 'MISSING', float(expected[name].get('median_ns', 0)),
+                 None, None))
+    if count_missing:
+      regressions += 1
+
+  return rows, regressions
+
+
+def _print_report(rows):
+  name_width = max([len(row[0]) for row in rows] + [len('benchmark')])
+  header = '%-*s  %-9s  %14s  %14s  %s' % (
+      name_width, 'benchmark', 'status', 'baseline', 'current',
+      'delta (tolerance)')
+  print(header)
+  print('-' * len(header))
+  for name, status, base, current, delta in rows:
+    print('%-*s  %-9s  %14s  %14s  %s' % (
+        name_width, name, status,
+        _format_ns(base) if base is not None else '-',
+        _format_ns(current) if current is not None else '-',
+        ('%+.1f%% (%.0f%%)' % (delta[0] * 100, delta[1] * 100))
+        if delta is not None else ''))
+
+
+def _update_baseline(path, baseline, stats):
+  expected = baseline.setdefault('benchmarks', {})
+  baseline.setdefault('default_tolerance', _DEFAULT_TOLERANCE)
+  for name, (median, mad) in stats.items():
+    entry = expected.setdefault(name, {})
+    # Keep hand-written tolerance (if any).
+    entry['median_ns'] = round(median, 3)
+    entry['mad_ns'] = round(mad, 3)
+  with open(path, 'w') as f:
+    json.dump(baseline, f, indent=2, sort_keys=True)
+    f.write('\n')
+  print('[perf_gate] baseline updated: %s (%d benchmarks)' %
+        (path, len(stats)))
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(
+      description=__doc__, formatter_class=argparse.RawTextHelpFormatter)
+  parser.add_argument('binaries', nargs='*',
+                      help='Google Benchmark executables to run')
+  parser.add_argument('--baseline', required=True,
+                      help='path to baseline JSON')
+  parser.add_argument('--input', action='append', default=[],
+                      help='use existing benchmark JSON output '
+                           'instead of running binaries (can be repeated)')
+  parser.add_argument('--repetitions', type=int, default=5,
+                      help='how many times to run each binary')
+  parser.add_argument('--filter', default='',
+                      help='value for --benchmark_filter')
+  parser.add_argument('--metric', choices=('real_time', 'cpu_time'),
+                      default='cpu_time')
+  parser.add_argument('--mad-factor', type=float, default=3.0,
+                      help='difference must exceed MAD * factor '
+                           'to be reported')
+  parser.add_argument('--update-baseline', '--update', dest='update',
+                      action='store_true',
+                      help='store current results as new baseline')
+  args = parser.parse_args(argv)
+
+  if not args.binaries and not args.input:
+    parser.error('pass benchmark executables or --input files')
+  if args.repetitions < 1:
+    parser.error('--repetitions must be positive')
+
+  samples = {}
+  for path in args.input:
+    _collect_samples(_load_json(path), samples, args.metric)
+  for binary in args.binaries:
+    _run_binary(binary, args.repetitions, args.filter, samples, args.metric)
+
+  if not samples:
+    print('[perf_gate] no benchmark results collected', file=sys.stderr)
+    return 1
+
+  stats = {name: _median_and_mad(values) for name, values in samples.items()}
+
+  baseline = {}
+  if os.path.exists(args.baseline):
+    baseline = _load_json(args.baseline)
+
+  if args.update:
+    _update_baseline(args.baseline, baseline, stats)
+    return 0
+
+  # `--filter` skips benchmarks on purpose, so they are not MISSING.
+  rows, regressions = _compare(stats, baseline, args.mad_factor,
+                               count_missing=not args.filter)
+  _print_report(rows)
+
+  if regressions:
+    print('\n[perf_gate] FAILED: %d benchmark(s) regressed, '
+          'are NEW or MISSING (use --update-baseline to accept '
+          'intended changes)' % regressions)
+    return 1
+
+  print('\n[perf_gate] PASSED')
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main(sys.argv[1:]))
@@ -31,3 +31,36 @@ target_compile_definitions( ${perf_test_runner} PUBLIC
   USE_GTEST_TEST=1
   GTEST_PERF_SUITE=1
   PERF_TEST=1)
+
+target_link_libraries(${perf_test_runner} PUBLIC
+  CONAN_PKG::benchmark
+)
+
+# Perf tests are not registered in `ctest`
+# (results depend on machine load),
+# use `${ROOT_PROJECT_NAME}_run_perftests` target to run them.
+macro(basis_test_perf test_name source_list)
+  add_executable(${test_name} ${source_list})
+  list(APPEND ${ROOT_PROJECT_NAME}_PERF_TARGETS ${test_name})
+
+  target_link_libraries(${test_name} PUBLIC
+    ${USED_3DPARTY_LIBS}
+    ${ROOT_PROJECT_LIB}-test-includes
+    ${ROOT_PROJECT_LIB}
+    ${USED_SYSTEM_LIBS}
+    ${perf_test_runner}
+  )
+
+  target_include_directories(${test_name} PUBLIC
+    ${CMAKE_CURRENT_SOURCE_DIR}
+  )
+
+  set_tests_default_compile_options( ${test_name} )
+
+  set_target_properties( ${test_name} PROPERTIES
+    CXX_STANDARD 17
+    CXX_EXTENSIONS OFF
+    CMAKE_CXX_STANDARD_REQUIRED ON
+    CMAKE_CXX_FLAGS "-fno-rtti"
+    RUNTIME_OUTPUT_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}/${TESTS_BINARY_DIR_NAME} )
+endmacro()
@@ -9,11 +9,33 @@ add_custom_command( TARGET ${ROOT_PROJECT_NAME}-i18n POST_BUILD
                         ${CMAKE_CURRENT_BINARY_DIR}/${PROJECT_NAME} )
 
 list(APPEND basis_unittests
+  checked_optional_unittest.cc
+  static_checked_optional_unittest.cc
   annotations/asio_guard_annotations_unittest.cc
   threading/thread_health_checker_unittest.cc
+  task/strand_occupancy_unittest.cc
   task/prioritized_once_task_heap_unittest.cc
   task/alarm_manager_unittest.cc
+  ECS/group_presets_unittest.cc
   ECS/ecs_hierarchies_unittest.cc
+  ECS/ecs_hierarchy_node_unittest.cc
+  ECS/helpers/algorithm/component_index_unittest.cc
+  ECS/change_tracker_unittest.cc
+  ECS/registry_compactor_unittest.cc
+  ECS/registry_memory_dump_unittest.cc
+  ECS/entity_migration_unittest.cc
+  memory/any_ptr_unittest.cc
+  task/instrumented_sequenced_task_runner_unittest.cc
+  task/prioritized_sequenced_task_runner_unittest.cc
+  task/inline_task_unittest.cc
+  task/channel_unittest.cc
+  task/bounded_sequenced_task_runner_unittest.cc
+  task/cancellation_token_unittest.cc
+  ECS/snapshot/registry_snapshot_unittest.cc
+  ECS/snapshot/registry_delta_unittest.cc
+  ECS/helpers/lifetime/lifecycle_state_unittest.cc
+  ECS/helpers/lifetime/delayed_construction_pipeline_unittest.cc
+  ECS/helpers/lifetime/destruction_queue_unittest.cc
 )
 list(APPEND basis_unittest_utils
   #"allocator/partition_allocator/arm_bti_test_functions.h"
@@ -36,3 +58,27 @@ foreach(FILEPATH ${basis_unittests})
   basis_test_gtest(${ROOT_PROJECT_NAME}-basis-${FILENAME_WITHOUT_EXT}
     "${test_sources}")
 endforeach()
+
+list(APPEND basis_perftests
+  checked_optional_perftest.cc
+  task/prioritized_once_task_heap_perftest.cc
+  task/alarm_manager_perftest.cc
+  task/task_util_perftest.cc
+  task/channel_perftest.cc
+  ECS/unsafe_context_perftest.cc
+  ECS/ecs_hierarchies_perftest.cc
+  ECS/group_presets_perftest.cc
+  ECS/change_tracker_perftest.cc
+  ECS/helpers/lifetime/lifecycle_state_perftest.cc
+  time_step/fixed_time_step_loop_perftest.cc
+  promise/post_promise_perftest.cc
+)
+
+list(REMOVE_DUPLICATES basis_perftests)
+list(TRANSFORM basis_perftests PREPEND ${BASIS_SOURCES_PATH})
+
+foreach(FILEPATH ${basis_perftests})
+  get_filename_component(FILENAME_WITHOUT_EXT ${FILEPATH} NAME_WE)
+  basis_test_perf(${ROOT_PROJECT_NAME}-basis-${FILENAME_WITHOUT_EXT}
+    "${FILEPATH}")
+endforeach()